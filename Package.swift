@@ -9,6 +9,7 @@ let package = Package(
     products: [
         .library(name: "Awaken", targets: ["Awaken"]),
         .executable(name: "awaken", targets: ["awaken-cli"]),
+        .executable(name: "awakend", targets: ["awakend"]),
     ],
     dependencies: [
     ],
@@ -20,6 +21,8 @@ let package = Package(
             exclude: [
                 "meson.build",
                 "Waiter/meson.build",
+                "Backend/meson.build",
+                "Lease/meson.build",
                 "include/meson.build",
                 "include/Awaken/meson.build",
                 "include/Awaken/config.h.in",
@@ -34,8 +37,8 @@ let package = Package(
             dependencies: ["Awaken"],
             path: ".",
             exclude: [
-                "build", "src", "include",
-                "Makefile", "meson.build", "subprojects",
+                "build", "src", "include", "benchmarks", "daemon",
+                "Makefile", "meson.build", "meson_options.txt", "subprojects",
                 "Doxyfile", "LICENSE", "CHANGELOG.md", "README.md",
             ],
             sources: [
@@ -48,6 +51,24 @@ let package = Package(
                 .linkedFramework("CoreFoundation"),
                 .linkedFramework("IOKit"),
             ]
+        ),
+        .executableTarget(
+            name: "awakend",
+            dependencies: ["Awaken"],
+            path: "daemon",
+            exclude: [
+                "meson.build",
+            ],
+            sources: [
+                "main.cpp"
+            ],
+            cxxSettings: [
+                .headerSearchPath("../subprojects/cxxopts-\(cxxoptsVersion)/include")
+            ],
+            linkerSettings: [
+                .linkedFramework("CoreFoundation"),
+                .linkedFramework("IOKit"),
+            ]
         )
     ],
     cxxLanguageStandard: .cxx17
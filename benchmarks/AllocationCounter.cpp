@@ -0,0 +1,73 @@
+//
+//  AllocationCounter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of the benchmark
+// executable to count every heap allocation of the library.
+
+namespace
+{
+std::atomic<std::size_t> allocationCount { 0 };
+
+void* Allocate(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if(auto pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    const auto alignmentValue = static_cast<std::size_t>(alignment);
+    const auto alignedSize = (size + alignmentValue - 1) / alignmentValue * alignmentValue;
+    if(auto pointer = std::aligned_alloc(alignmentValue, alignedSize == 0 ? alignmentValue : alignedSize))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+}
+
+std::size_t Awaken::Benchmarks::AllocationCount() noexcept
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+
+// Temporary buffers, e.g. of std::stable_sort(), are allocated without throwing.
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return Allocate(size); } catch(...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return Allocate(size); } catch(...) { return nullptr; }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { std::free(pointer); }
@@ -0,0 +1,337 @@
+//
+//  AwakenBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <atomic>
+#include <coroutine>
+#include <format>
+#include <optional>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <Awaken/Awaken.hpp>
+#include <Awaken/BasicAwaken.hpp>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/IOPowerAssertion.hpp>
+#include <Awaken/ProcessWaiter.hpp>
+#include <Awaken/SessionPool.hpp>
+#include <Awaken/ThreadWaiter.hpp>
+#include <Awaken/TimerWheelWaiter.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The number of concurrent sessions used to count threads per session
+constexpr size_t ConcurrentSessionCount = 100;
+/// The number of sessions held at once in a session pool
+constexpr size_t PooledSessionCount = 1000;
+/// The number of holds that wait for an already exited process
+constexpr size_t ExitedHoldCount = 100;
+
+template<typename WaiterClass>
+void RunSessionBenchmark(const string& waiterName, Report& report, const Options& options)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    const auto makeSession = [&backend] {
+        auto awaken = make_unique<::Awaken::Awaken>("awaken-benchmark", backend, make_unique<WaiterClass>());
+        awaken->setPreventUserIdleSystemSleep(true);
+        awaken->setTimeout(60s);
+        return awaken;
+    };
+    
+    // Warm up shared state like the timing wheel thread.
+    auto awaken = makeSession();
+    awaken->run();
+    awaken->cancel();
+    backend->reset();
+    
+    vector<chrono::nanoseconds> runs, cancels;
+    runs.reserve(options.iterations);
+    cancels.reserve(options.iterations);
+    size_t allocations = 0;
+    
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        const auto allocationCount = AllocationCount();
+        runs.push_back(Measure([&] { awaken->run(); }));
+        cancels.push_back(Measure([&] { awaken->cancel(); }));
+        allocations += AllocationCount() - allocationCount;
+        backend->reset();
+    }
+    
+    report.addLatencies(format("Awaken::run() [{}]", waiterName), std::move(runs));
+    report.addLatencies(format("Awaken::cancel() [{}]", waiterName), std::move(cancels));
+    report.addCounter(format("allocations per session [{}]", waiterName),
+                      static_cast<double>(allocations) / static_cast<double>(options.iterations), "allocations");
+    // The assertion name is interned by the backend and the timeout handler
+    // is scheduled without allocating, so a warm session does not allocate.
+    report.addCheck(format("Awaken::run() and cancel() do not allocate [{}]", waiterName), allocations == 0,
+                    format("{} allocations in {} sessions", allocations, options.iterations));
+    
+    // Threads are counted with many concurrent sessions,
+    // shared threads are amortized over all of them.
+    vector<unique_ptr<::Awaken::Awaken>> sessions;
+    for(size_t index = 0; index < ConcurrentSessionCount; index++)
+    {
+        sessions.push_back(makeSession());
+    }
+    
+    const auto baselineThreadCount = ThreadCount();
+    for(auto& session : sessions)
+    {
+        session->run();
+    }
+    const auto runningThreadCount = ThreadCount();
+    
+    if(baselineThreadCount && runningThreadCount)
+    {
+        const auto threads = static_cast<double>(*runningThreadCount) - static_cast<double>(*baselineThreadCount);
+        report.addCounter(format("threads per session [{}]", waiterName),
+                          threads / ConcurrentSessionCount, "threads");
+    }
+    
+    const auto activeCount = backend->activeCount();
+    report.addCheck(format("concurrent sessions share one backend assertion [{}]", waiterName),
+                    activeCount == 1,
+                    format("{} sessions hold {} backend assertions", ConcurrentSessionCount, activeCount));
+    
+    for(auto& session : sessions)
+    {
+        session->cancel();
+    }
+}
+
+void RunBasicAwakenBenchmark(Report& report, const Options& options)
+{
+    using InlineAwaken = BasicAwaken<IOPowerAssertion, NoPowerSource, TimerWheelWaiter>;
+    static_assert(!InlineAwaken::MonitorsBatteryCapacity);
+    
+    // Lingering assertions are re-attached by the next run,
+    // so the in-memory backend only extends their timeout.
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    InlineAwaken awaken { "awaken-benchmark", piecewise_construct, forward_as_tuple(backend), tuple {}, tuple {} };
+    awaken.setPreventUserIdleSystemSleep(true);
+    awaken.setReleaseLinger(60s);
+    awaken.setTimeout(60s);
+    
+    size_t endCount = 0;
+    awaken.subscribeToEnd([&endCount](HoldEndReason) { endCount++; });
+    
+    // The second run re-attaches for the first time.
+    awaken.run();
+    awaken.cancel();
+    awaken.run();
+    awaken.cancel();
+    backend->reset();
+    
+    vector<chrono::nanoseconds> runs, cancels;
+    runs.reserve(options.iterations);
+    cancels.reserve(options.iterations);
+    size_t allocations = 0;
+    
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        const auto allocationCount = AllocationCount();
+        runs.push_back(Measure([&] { awaken.run(); }));
+        cancels.push_back(Measure([&] { awaken.cancel(); }));
+        allocations += AllocationCount() - allocationCount;
+        backend->reset();
+    }
+    
+    report.addLatencies("BasicAwaken::run() [TimerWheelWaiter]", std::move(runs));
+    report.addLatencies("BasicAwaken::cancel() [TimerWheelWaiter]", std::move(cancels));
+    report.addCheck("BasicAwaken runs and cancels without allocating",
+                    allocations == 0 && endCount == options.iterations + 2,
+                    format("{} allocations in {} sessions, {} ended", allocations, options.iterations, endCount));
+}
+
+void RunSessionPoolBenchmark(Report& report, const Options& options)
+{
+    using InlineAwaken = BasicAwaken<IOPowerAssertion, NoPowerSource, TimerWheelWaiter>;
+    
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    SessionPool<InlineAwaken> pool { "awaken-benchmark", piecewise_construct, tuple { backend }, tuple {}, tuple {} };
+    
+    // Ended sessions are recycled through their handles by the end handler.
+    atomic<size_t> endCount = 0;
+    atomic<bool> didEndAll = false;
+    pool.subscribeToEnd([&](SessionHandle handle, HoldEndReason reason) {
+        if(reason == HoldEndReason::Timeout && pool.release(handle)
+           && endCount.fetch_add(1, memory_order_relaxed) + 1 == PooledSessionCount)
+        {
+            didEndAll.store(true, memory_order_release);
+        }
+    });
+    
+    const auto startSession = [&pool](SessionHandle handle) {
+        return pool.visit(handle, [](InlineAwaken& session) {
+            session.setPreventUserIdleSystemSleep(true);
+            session.setTimeout(60s);
+            session.run();
+        });
+    };
+    
+    vector<SessionHandle> handles;
+    handles.reserve(PooledSessionCount);
+    for(size_t index = 0; index < PooledSessionCount; index++)
+    {
+        handles.push_back(pool.acquire());
+        startSession(handles.back());
+    }
+    const auto capacity = pool.capacity();
+    
+    // Moving the deadlines up lets all sessions time out at once.
+    for(const auto handle : handles)
+    {
+        pool.visit(handle, [](InlineAwaken& session) { session.setDeadline(Clock::now()); });
+    }
+    const bool didEnd = SpinUntil(didEndAll);
+    report.addCheck("pooled sessions end and are recycled through their handles",
+                    didEnd && pool.size() == 0 && backend->activeCount() == 0,
+                    format("{} of {} sessions ended, {} still acquired", endCount.load(), PooledSessionCount, pool.size()));
+    
+    vector<chrono::nanoseconds> jobs;
+    jobs.reserve(options.iterations);
+    size_t allocations = 0;
+    backend->reset();
+    
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        const auto allocationCount = AllocationCount();
+        jobs.push_back(Measure([&] {
+            const auto handle = pool.acquire();
+            startSession(handle);
+            pool.release(handle);
+        }));
+        allocations += AllocationCount() - allocationCount;
+        backend->reset();
+    }
+    
+    // All slots were reused, the original handles must not resolve to the new jobs.
+    size_t staleVisits = 0;
+    for(const auto handle : handles)
+    {
+        staleVisits += pool.visit(handle, [](InlineAwaken&) {}) ? 1 : 0;
+    }
+    
+    report.addLatencies("SessionPool job [TimerWheelWaiter]", std::move(jobs));
+    report.addCheck("recycling a pooled session does not allocate",
+                    allocations == 0 && pool.capacity() == capacity,
+                    format("{} allocations in {} jobs, {} sessions constructed", allocations, options.iterations, pool.capacity()));
+    report.addCheck("stale session handles are rejected", staleVisits == 0,
+                    format("{} of {} released handles resolved", staleVisits, handles.size()));
+}
+
+/// A coroutine that starts immediately and is not awaited
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+DetachedTask HoldAndDestroy(unique_ptr<::Awaken::Awaken> awaken, chrono::seconds timeout, optional<HoldEndReason>& reason)
+{
+    reason = co_await awaken->holdFor(timeout);
+    awaken.reset();
+}
+
+/// Like `HoldAndDestroy()`, for holds that may end on another thread
+DetachedTask HoldAndDestroy(unique_ptr<::Awaken::Awaken> awaken, chrono::seconds timeout,
+                            atomic<HoldEndReason>& reason, atomic<bool>& didEnd)
+{
+    reason.store(co_await awaken->holdFor(timeout), memory_order_relaxed);
+    awaken.reset();
+    didEnd.store(true, memory_order_release);
+}
+
+/// Returns the identifier of a child process that already exited and was reaped
+pid_t ExitedProcess()
+{
+    const auto process = fork();
+    if(process == 0) { _exit(EXIT_SUCCESS); }
+    waitpid(process, nullptr, 0);
+    return process;
+}
+
+void RunHoldForBenchmark(Report& report, const Options&)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    const auto makeSession = [&backend] {
+        auto awaken = make_unique<::Awaken::Awaken>("awaken-benchmark", backend, make_unique<TimerWheelWaiter>());
+        awaken->setPreventUserIdleSystemSleep(true);
+        awaken->setTimeout(60s);
+        return awaken;
+    };
+    
+    // The hold uses its own duration, the configured timeout stays.
+    auto awaken = makeSession();
+    optional<HoldEndReason> reason = nullopt;
+    [](::Awaken::Awaken& awaken, optional<HoldEndReason>& reason) -> DetachedTask {
+        reason = co_await awaken.holdFor(1h);
+    }(*awaken, reason);
+    const auto timeoutWhileHeld = awaken->timeout();
+    awaken->cancel();
+    const auto timeoutAfterHold = awaken->timeout();
+    report.addCheck("holdFor() keeps the configured timeout",
+                    reason == HoldEndReason::Cancelled && timeoutWhileHeld == 60s && timeoutAfterHold == 60s,
+                    format("timeout {} while held, {} after the hold", timeoutWhileHeld, timeoutAfterHold));
+    
+    // The coroutine resumed by a failed hold destroys the instance
+    // before the awaiter returns to it.
+    backend->setFailing(PowerAssertionType::PreventUserIdleSystemSleep, true);
+    optional<HoldEndReason> failedReason = nullopt;
+    HoldAndDestroy(makeSession(), 60s, failedReason);
+    backend->setFailing(PowerAssertionType::PreventUserIdleSystemSleep, false);
+    report.addCheck("a failed hold resumes with HoldEndReason::Failed",
+                    failedReason == HoldEndReason::Failed,
+                    format("resumed {}", failedReason ? "with the reason" : "never"));
+    
+    // The waiter finishes while the hold is arming, the
+    // coroutine then destroys the instance on any thread.
+    size_t timeoutCount = 0, missedCount = 0;
+    for(size_t hold = 0; hold < ExitedHoldCount; hold++)
+    {
+        auto awaken = make_unique<::Awaken::Awaken>("awaken-benchmark", backend,
+                                                    make_unique<ProcessWaiter>(vector { ExitedProcess() }));
+        awaken->setPreventUserIdleSystemSleep(true);
+        
+        atomic<HoldEndReason> exitedReason = HoldEndReason::Failed;
+        atomic<bool> didEnd = false;
+        HoldAndDestroy(std::move(awaken), InfiniteTimeout, exitedReason, didEnd);
+        if(!SpinUntil(didEnd))
+        {
+            missedCount++;
+            continue;
+        }
+        timeoutCount += exitedReason.load(memory_order_relaxed) == HoldEndReason::Timeout ? 1 : 0;
+    }
+    report.addCheck("a hold for an exited process without a timeout ends right away [ProcessWaiter]",
+                    missedCount == 0 && timeoutCount == ExitedHoldCount && backend->activeCount() == 0,
+                    format("{} of {} holds timed out, {} never ended, {} assertions held",
+                           timeoutCount, ExitedHoldCount, missedCount, backend->activeCount()));
+}
+
+}
+
+void Awaken::Benchmarks::RunAwakenBenchmarks(Report& report, const Options& options)
+{
+    RunSessionBenchmark<ThreadWaiter>("ThreadWaiter", report, options);
+    RunSessionBenchmark<TimerWheelWaiter>("TimerWheelWaiter", report, options);
+    RunBasicAwakenBenchmark(report, options);
+    RunSessionPoolBenchmark(report, options);
+    RunHoldForBenchmark(report, options);
+}
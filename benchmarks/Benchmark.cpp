@@ -0,0 +1,176 @@
+//
+//  Benchmark.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+using namespace std;
+using namespace Awaken::Benchmarks;
+
+#pragma mark - Report
+
+void Report::addLatencies(const string& name, vector<chrono::nanoseconds> samples)
+{
+    if(samples.empty()) { return; }
+    
+    sort(samples.begin(), samples.end());
+    const auto percentile = [&samples](double fraction) {
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+        return samples[index];
+    };
+    const auto total = accumulate(samples.begin(), samples.end(), chrono::nanoseconds { 0 });
+    
+    this->_latencies.push_back({
+        name,
+        samples.size(),
+        samples.front(),
+        percentile(0.50),
+        percentile(0.90),
+        percentile(0.99),
+        samples.back(),
+        total / static_cast<chrono::nanoseconds::rep>(samples.size()),
+    });
+}
+
+void Report::addCounter(const string& name, double value, const string& unit)
+{
+    this->_counters.push_back({ name, value, unit });
+}
+
+void Report::addCheck(const string& name, bool passed, const string& detail)
+{
+    this->_checks.push_back({ name, passed, detail });
+}
+
+bool Report::passed() const noexcept
+{
+    return all_of(this->_checks.begin(), this->_checks.end(), [](const auto& check) { return check.passed; });
+}
+
+void Report::printText(FILE* file) const
+{
+    const auto microseconds = [](chrono::nanoseconds duration) {
+        return static_cast<double>(duration.count()) / 1000.0;
+    };
+    
+    fprintf(file, "%-48s %8s %10s %10s %10s %10s %10s\n", "latency (µs)", "n", "min", "p50", "p90", "p99", "max");
+    for(const auto& latencies : this->_latencies)
+    {
+        fprintf(file, "%-48s %8zu %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                latencies.name.c_str(), latencies.count,
+                microseconds(latencies.minimum), microseconds(latencies.p50), microseconds(latencies.p90),
+                microseconds(latencies.p99), microseconds(latencies.maximum));
+    }
+    
+    fprintf(file, "\n");
+    for(const auto& counter : this->_counters)
+    {
+        fprintf(file, "%-48s %12.2f %s\n", counter.name.c_str(), counter.value, counter.unit.c_str());
+    }
+    
+    fprintf(file, "\n");
+    for(const auto& check : this->_checks)
+    {
+        fprintf(file, "[%s] %s: %s\n", check.passed ? "PASS" : "FAIL", check.name.c_str(), check.detail.c_str());
+    }
+}
+
+void Report::writeJSON(ostream& stream) const
+{
+    const auto quoted = [](const string& value) {
+        string result = "\"";
+        for(const auto character : value)
+        {
+            if(character == '"' || character == '\\') { result += '\\'; }
+            result += character;
+        }
+        return result + "\"";
+    };
+    
+    stream << "{\n  \"latencies\": [";
+    for(size_t index = 0; index < this->_latencies.size(); index++)
+    {
+        const auto& latencies = this->_latencies[index];
+        stream << (index == 0 ? "\n" : ",\n")
+               << "    { \"name\": " << quoted(latencies.name)
+               << ", \"count\": " << latencies.count
+               << ", \"min_ns\": " << latencies.minimum.count()
+               << ", \"p50_ns\": " << latencies.p50.count()
+               << ", \"p90_ns\": " << latencies.p90.count()
+               << ", \"p99_ns\": " << latencies.p99.count()
+               << ", \"max_ns\": " << latencies.maximum.count()
+               << ", \"mean_ns\": " << latencies.mean.count() << " }";
+    }
+    
+    stream << "\n  ],\n  \"counters\": [";
+    for(size_t index = 0; index < this->_counters.size(); index++)
+    {
+        const auto& counter = this->_counters[index];
+        stream << (index == 0 ? "\n" : ",\n")
+               << "    { \"name\": " << quoted(counter.name)
+               << ", \"value\": " << counter.value
+               << ", \"unit\": " << quoted(counter.unit) << " }";
+    }
+    
+    stream << "\n  ],\n  \"checks\": [";
+    for(size_t index = 0; index < this->_checks.size(); index++)
+    {
+        const auto& check = this->_checks[index];
+        stream << (index == 0 ? "\n" : ",\n")
+               << "    { \"name\": " << quoted(check.name)
+               << ", \"passed\": " << (check.passed ? "true" : "false")
+               << ", \"detail\": " << quoted(check.detail) << " }";
+    }
+    stream << "\n  ]\n}\n";
+}
+
+#pragma mark - Statistics
+
+chrono::nanoseconds Awaken::Benchmarks::Percentile(vector<chrono::nanoseconds> samples, double fraction)
+{
+    if(samples.empty()) { return chrono::nanoseconds { 0 }; }
+    
+    const auto index = static_cast<size_t>(fraction * static_cast<double>(samples.size() - 1));
+    nth_element(samples.begin(), samples.begin() + static_cast<ptrdiff_t>(index), samples.end());
+    return samples[index];
+}
+
+#pragma mark - Process
+
+optional<size_t> Awaken::Benchmarks::ThreadCount() noexcept
+{
+#if defined(__linux__)
+    error_code error;
+    size_t count = 0;
+    for(filesystem::directory_iterator iterator { "/proc/self/task", error }, end; iterator != end; iterator.increment(error))
+    {
+        count++;
+    }
+    if(error) { return nullopt; }
+    return count;
+#elif defined(__APPLE__)
+    thread_act_array_t threads;
+    mach_msg_type_number_t count = 0;
+    if(task_threads(mach_task_self(), &threads, &count) != KERN_SUCCESS) { return nullopt; }
+    
+    for(mach_msg_type_number_t index = 0; index < count; index++)
+    {
+        mach_port_deallocate(mach_task_self(), threads[index]);
+    }
+    vm_deallocate(mach_task_self(), reinterpret_cast<vm_address_t>(threads), count * sizeof(thread_act_t));
+    return count;
+#else
+    return nullopt;
+#endif
+}
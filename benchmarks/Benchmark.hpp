@@ -0,0 +1,133 @@
+//
+//  Benchmark.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef Benchmark_hpp
+#define Benchmark_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Awaken::Benchmarks
+{
+
+using Clock = std::chrono::steady_clock;
+
+/// Command-line options shared by all benchmarks
+struct Options
+{
+    /// The number of samples per latency measurement
+    std::size_t iterations = 1000;
+    /// Only benchmarks whose name contains the filter are run
+    std::string filter;
+    /// Writes the report as JSON to the path, "-" for stdout
+    std::optional<std::string> jsonPath = std::nullopt;
+};
+
+/// Collects latency samples, counters and pass/fail checks
+/// and prints them as text or JSON.
+class Report
+{
+public:
+    /// Adds a latency distribution, e.g. of `Awaken::run()`
+    void addLatencies(const std::string& name, std::vector<std::chrono::nanoseconds> samples);
+    
+    /// Adds a single value, e.g. a thread count per session
+    void addCounter(const std::string& name, double value, const std::string& unit);
+    
+    /// Adds a check that fails the benchmark run if not passed
+    void addCheck(const std::string& name, bool passed, const std::string& detail);
+    
+    /// Returns true if all checks passed
+    bool passed() const noexcept;
+    
+    void printText(std::FILE*) const;
+    void writeJSON(std::ostream&) const;
+    
+private:
+    struct Latencies
+    {
+        std::string name;
+        std::size_t count;
+        std::chrono::nanoseconds minimum, p50, p90, p99, maximum, mean;
+    };
+    
+    struct Counter
+    {
+        std::string name;
+        double value;
+        std::string unit;
+    };
+    
+    struct Check
+    {
+        std::string name;
+        bool passed;
+        std::string detail;
+    };
+    
+    std::vector<Latencies> _latencies;
+    std::vector<Counter> _counters;
+    std::vector<Check> _checks;
+};
+
+/// Measures the duration of a single call
+template<typename Function>
+std::chrono::nanoseconds Measure(Function&& function)
+{
+    const auto start = Clock::now();
+    function();
+    return Clock::now() - start;
+}
+
+/// Spins until the flag is set or the timeout is reached
+/// @returns false on timeout
+template<typename Flag>
+bool SpinUntil(const Flag& flag, std::chrono::milliseconds timeout = std::chrono::seconds { 5 })
+{
+    const auto deadline = Clock::now() + timeout;
+    while(!flag.load(std::memory_order_acquire))
+    {
+        if(Clock::now() > deadline) { return false; }
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+/// Returns the sample at the fraction of the sorted samples, e.g. 0.5 for the median
+std::chrono::nanoseconds Percentile(std::vector<std::chrono::nanoseconds> samples, double fraction);
+
+/// Returns the number of heap allocations made by the process so far
+std::size_t AllocationCount() noexcept;
+
+/// Returns the number of threads of the process
+/// or nullopt if not supported on the platform
+std::optional<std::size_t> ThreadCount() noexcept;
+
+#pragma mark - Benchmarks
+
+void RunAwakenBenchmarks(Report&, const Options&);
+void RunWaiterBenchmarks(Report&, const Options&);
+void RunPowerSourceBenchmarks(Report&, const Options&);
+void RunRegistryBenchmarks(Report&, const Options&);
+void RunStressBenchmarks(Report&, const Options&);
+void RunLeaseBenchmarks(Report&, const Options&);
+void RunHeartbeatBenchmarks(Report&, const Options&);
+void RunSimulationBenchmarks(Report&, const Options&);
+void RunMetricsBenchmarks(Report&, const Options&);
+void RunTraceBenchmarks(Report&, const Options&);
+
+}
+
+#endif /* Benchmark_hpp */
@@ -0,0 +1,166 @@
+//
+//  HeartbeatBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <format>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <Awaken/HeartbeatLease.hpp>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/Metrics.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The TTL of leases that are expected to expire
+constexpr auto ShortTTL = 50ms;
+
+/// The time a missed heartbeat may take to be reported after the TTL
+constexpr auto DetectionTolerance = 100ms;
+
+/// The number of leases renewed by a single thread, half of them stall
+constexpr size_t SharedLeaseCount = 256;
+
+void RunRenewBenchmark(Report& report, const Options& options)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    HeartbeatLease lease { "awaken-benchmark", 60s, backend };
+    lease.acquire();
+    
+    vector<chrono::nanoseconds> samples;
+    samples.reserve(options.iterations);
+    const auto allocationCount = AllocationCount();
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        samples.push_back(Measure([&] { lease.renew(); }));
+    }
+    const auto allocations = AllocationCount() - allocationCount;
+    report.addLatencies("HeartbeatLease::renew()", std::move(samples));
+    
+    report.addCheck("renewing a lease does not allocate",
+                    allocations == 0,
+                    format("{} allocations for {} renewals", allocations, options.iterations));
+    lease.release();
+}
+
+void RunMissedHeartbeatBenchmark(Report& report)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    HeartbeatLease lease { "stalled-worker", ShortTTL, backend };
+    
+    mutex reportedMutex;
+    string reportedOwner;
+    atomic<bool> didReport = false;
+    lease.subscribeToMissedHeartbeat([&](const string& owner) {
+        lock_guard lock { reportedMutex };
+        reportedOwner = owner;
+        didReport.store(true, memory_order_release);
+    });
+    
+    // Renewing keeps the lease held for several TTLs.
+    lease.acquire();
+    const auto renewUntil = Clock::now() + 4 * ShortTTL;
+    bool wasHeld = true;
+    while(Clock::now() < renewUntil)
+    {
+        lease.renew();
+        wasHeld = wasHeld && lease.isHeld();
+        this_thread::sleep_for(ShortTTL / 5);
+    }
+    report.addCheck("a renewed heartbeat lease stays held",
+                    wasHeld && lease.isHeld() && !didReport.load(),
+                    format("renewed every {} with a TTL of {}", ShortTTL / 5, ShortTTL));
+    
+    // The holder stalls.
+    const auto stallStart = Clock::now();
+    lease.renew();
+    const bool didExpire = SpinUntil(didReport);
+    const auto detection = chrono::duration_cast<chrono::milliseconds>(Clock::now() - stallStart);
+    
+    lock_guard lock { reportedMutex };
+    report.addCheck("a stalled holder's lease expires and reports its owner",
+                    didExpire && reportedOwner == "stalled-worker" && !lease.isHeld() && backend->activeCount() == 0,
+                    format("'{}' reported after {}, {} backend assertions held",
+                           reportedOwner, detection, backend->activeCount()));
+    report.addCheck("a missed heartbeat is detected within the TTL",
+                    detection < ShortTTL + DetectionTolerance,
+                    format("detected after {} with a TTL of {}", detection, ShortTTL));
+}
+
+void RunSharedSchedulerBenchmark(Report& report)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    vector<unique_ptr<HeartbeatLease>> leases;
+    mutex reportedMutex;
+    set<string> reportedOwners;
+    
+    for(size_t index = 0; index < SharedLeaseCount; index++)
+    {
+        auto& lease = leases.emplace_back(make_unique<HeartbeatLease>(format("worker-{}", index), ShortTTL, backend));
+        lease->subscribeToMissedHeartbeat([&](const string& owner) {
+            lock_guard lock { reportedMutex };
+            reportedOwners.insert(owner);
+        });
+        lease->acquire();
+    }
+    
+    // Every other worker stalls, the rest keeps renewing.
+    const auto wakeups = Metrics::shared().timerWheelWakeups.value();
+    const auto start = Clock::now();
+    while(Clock::now() < start + 6 * ShortTTL)
+    {
+        for(size_t index = 0; index < leases.size(); index += 2)
+        {
+            leases[index]->renew();
+        }
+        this_thread::sleep_for(ShortTTL / 5);
+    }
+    const auto elapsed = Clock::now() - start;
+    const auto wheelWakeups = Metrics::shared().timerWheelWakeups.value() - wakeups;
+    
+    size_t heldCount = 0;
+    bool reportedOnlyStalled = true;
+    {
+        lock_guard lock { reportedMutex };
+        for(size_t index = 0; index < leases.size(); index++)
+        {
+            const bool isStalled = index % 2 == 1;
+            heldCount += leases[index]->isHeld() ? 1 : 0;
+            reportedOnlyStalled = reportedOnlyStalled
+                && reportedOwners.contains(format("worker-{}", index)) == isStalled
+                && leases[index]->isHeld() != isStalled;
+        }
+    }
+    
+    report.addCounter("timer wheel wakeups per renewed lease per TTL",
+                      static_cast<double>(wheelWakeups) / static_cast<double>(SharedLeaseCount / 2)
+                      / (chrono::duration<double>(elapsed) / ShortTTL),
+                      "wakeups");
+    report.addCheck("one scheduler expires exactly the stalled leases",
+                    reportedOnlyStalled && heldCount == SharedLeaseCount / 2,
+                    format("{} of {} leases held, {} owners reported", heldCount, SharedLeaseCount, reportedOwners.size()));
+    
+    leases.clear();
+    report.addCheck("no assertions leak from heartbeat leases",
+                    backend->activeCount() == 0,
+                    format("{} backend assertions held", backend->activeCount()));
+}
+
+}
+
+void Awaken::Benchmarks::RunHeartbeatBenchmarks(Report& report, const Options& options)
+{
+    RunRenewBenchmark(report, options);
+    RunMissedHeartbeatBenchmark(report);
+    RunSharedSchedulerBenchmark(report);
+}
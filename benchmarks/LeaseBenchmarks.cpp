@@ -0,0 +1,194 @@
+//
+//  LeaseBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <format>
+#include <thread>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/LeaseClient.hpp>
+#include <Awaken/LeaseServer.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The number of clients holding a lease at the same time,
+/// limited by the number of descriptors the process may open
+constexpr size_t LeaseClientCount = 4000;
+
+/// A lease that expires while the benchmark waits for it
+constexpr auto ShortLeaseDuration = 50ms;
+
+/// The time an expired lease may take to be released
+constexpr auto ExpiryTolerance = 100ms;
+
+/// Raises the descriptor limit as far as allowed
+/// @returns the number of clients that fit into the limit
+size_t PrepareClientCount() noexcept
+{
+    rlimit limit {};
+    if(getrlimit(RLIMIT_NOFILE, &limit) != 0) { return 0; }
+    
+    if(limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    
+    // Each client needs a descriptor on both ends of its connection.
+    const auto available = limit.rlim_cur > 128 ? (limit.rlim_cur - 128) / 2 : 0;
+    return min<size_t>(LeaseClientCount, available);
+}
+
+template<typename Predicate>
+bool WaitUntil(Predicate&& predicate, chrono::milliseconds timeout = 5s)
+{
+    const auto deadline = Clock::now() + timeout;
+    while(!predicate())
+    {
+        if(Clock::now() > deadline) { return false; }
+        this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+void RunLeaseLoadBenchmark(Report& report, const Options& options)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    const auto socketPath = format("/tmp/awaken-lease-benchmark-{}.sock", getpid());
+    LeaseServer server { socketPath, make_shared<PowerAssertionRegistry>(backend) };
+    if(!server.listen())
+    {
+        report.addCheck("lease server listens", false, socketPath);
+        return;
+    }
+    thread serverThread { [&server] { server.run(); } };
+    
+    const auto clientCount = PrepareClientCount();
+    vector<LeaseClient> clients(clientCount);
+    size_t connectedCount = 0;
+    for(auto& client : clients)
+    {
+        connectedCount += client.connect(socketPath) ? 1 : 0;
+    }
+    report.addCounter("connected lease clients", static_cast<double>(connectedCount), "clients");
+    
+    // Every client takes a lease, requests are sent before reading
+    // any response so the server handles them in batches.
+    const auto acquireStart = Clock::now();
+    for(size_t index = 0; index < clients.size(); index++)
+    {
+        clients[index].send(LeaseProtocol::Opcode::Acquire, PowerAssertionType::PreventUserIdleSystemSleep,
+                            LeaseProtocol::InvalidLeaseID, 60s, format("client-{}", index));
+    }
+    vector<LeaseProtocol::LeaseID> leases;
+    leases.reserve(clients.size());
+    for(auto& client : clients)
+    {
+        const auto response = client.receive();
+        leases.push_back(response && response->status == LeaseProtocol::Status::Ok ? response->lease : LeaseProtocol::InvalidLeaseID);
+    }
+    const auto acquireElapsed = Clock::now() - acquireStart;
+    const auto acquiredCount = ranges::count_if(leases, [](auto lease) { return lease != LeaseProtocol::InvalidLeaseID; });
+    
+    report.addCounter("concurrent lease acquisitions per second",
+                      static_cast<double>(acquiredCount) / chrono::duration<double>(acquireElapsed).count(), "leases/s");
+    report.addCheck("concurrent leases fold into one backend assertion",
+                    acquiredCount == static_cast<ptrdiff_t>(connectedCount) && backend->activeCount() == 1 && backend->createCount() == 1,
+                    format("{} leases, {} backend assertions held, {} created",
+                           acquiredCount, backend->activeCount(), backend->createCount()));
+    
+    // Round trips while all other leases are held
+    if(!clients.empty())
+    {
+        auto& client = clients.front();
+        vector<chrono::nanoseconds> samples;
+        samples.reserve(options.iterations);
+        for(size_t iteration = 0; iteration < options.iterations; iteration++)
+        {
+            samples.push_back(Measure([&] {
+                if(const auto lease = client.acquire(PowerAssertionType::PreventUserIdleSystemSleep, 60s, "awaken-benchmark"))
+                {
+                    client.release(*lease);
+                }
+            }));
+        }
+        report.addLatencies("acquire/release round trip [LeaseClient]", std::move(samples));
+    }
+    
+    for(size_t index = 0; index < clients.size(); index++)
+    {
+        clients[index].send(LeaseProtocol::Opcode::Release, PowerAssertionType::PreventUserIdleSystemSleep, leases[index], 0ms);
+    }
+    for(auto& client : clients)
+    {
+        client.receive();
+    }
+    report.addCheck("released leases release the backend assertion",
+                    backend->activeCount() == 0 && server.statistics().leases == 0,
+                    format("{} backend assertions held, {} leases", backend->activeCount(), server.statistics().leases));
+    clients.clear();
+    
+    // Expiry and disconnects are handled by the server alone
+    LeaseClient client;
+    client.connect(socketPath);
+    const auto shortLeaseStart = Clock::now();
+    client.acquire(PowerAssertionType::PreventUserIdleDisplaySleep, ShortLeaseDuration, "awaken-benchmark");
+    const bool didExpire = WaitUntil([&] { return backend->activeCount() == 0; });
+    const auto expiryDuration = chrono::duration_cast<chrono::milliseconds>(Clock::now() - shortLeaseStart);
+    report.addCheck("an unrenewed lease expires on time",
+                    didExpire && expiryDuration < ShortLeaseDuration + ExpiryTolerance,
+                    format("{} lease released after {}", ShortLeaseDuration, expiryDuration));
+    
+    // Renewing moves the lease's deadline, also to an earlier one
+    const auto renewedLease = client.acquire(PowerAssertionType::PreventUserIdleDisplaySleep, 60s, "awaken-benchmark");
+    bool didRenew = renewedLease != nullopt;
+    for(size_t iteration = 0; didRenew && iteration < options.iterations; iteration++)
+    {
+        didRenew = client.renew(*renewedLease, 60s);
+    }
+    didRenew = didRenew && client.renew(*renewedLease, ShortLeaseDuration);
+    const bool didExpireRenewed = didRenew && WaitUntil([&] { return backend->activeCount() == 0; }, ShortLeaseDuration + ExpiryTolerance);
+    report.addCheck("a lease renewed to a shorter duration expires on time",
+                    didExpireRenewed,
+                    format("{} renewals, {}", options.iterations + 1, didExpireRenewed ? "expired" : "still held"));
+    
+    client.acquire(PowerAssertionType::PreventUserIdleSystemSleep, 60s, "awaken-benchmark");
+    client.disconnect();
+    const bool didReleaseOnDisconnect = WaitUntil([&] { return backend->activeCount() == 0 && server.statistics().clients == 0; });
+    report.addCheck("disconnecting releases the leases of a client",
+                    didReleaseOnDisconnect,
+                    format("{} backend assertions held", backend->activeCount()));
+    
+    // An invalid request is answered before the server disconnects the client
+    client.connect(socketPath);
+    client.send(static_cast<LeaseProtocol::Opcode>(0xff), PowerAssertionType::PreventUserIdleSystemSleep, LeaseProtocol::InvalidLeaseID, 0ms);
+    const auto invalidResponse = client.receive();
+    const bool didDisconnectInvalid = WaitUntil([&] { return server.statistics().clients == 0; });
+    report.addCheck("an invalid request is answered and disconnects the client",
+                    invalidResponse && invalidResponse->status == LeaseProtocol::Status::InvalidRequest && didDisconnectInvalid,
+                    format("{} clients connected", server.statistics().clients));
+    client.disconnect();
+    
+    server.stop();
+    serverThread.join();
+}
+
+}
+
+void Awaken::Benchmarks::RunLeaseBenchmarks(Report& report, const Options& options)
+{
+    RunLeaseLoadBenchmark(report, options);
+}
@@ -0,0 +1,141 @@
+//
+//  MetricsBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <format>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <Awaken/Metrics.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The histogram exported by the Prometheus checks
+constexpr string_view ExportedHistogramName = "awaken_executor_run_duration_seconds";
+
+void RunBucketBoundaryChecks(Report& report)
+{
+    // Every bucket ends right before the next one starts,
+    // which covers both edges of every group of buckets.
+    size_t failedBucketCount = 0;
+    for(size_t index = 0; index < Histogram::BucketCount; index++)
+    {
+        const auto upperBound = Histogram::bucketUpperBound(index);
+        const bool isLast = index + 1 == Histogram::BucketCount;
+        const bool isValid = Histogram::bucketIndex(upperBound) == index
+            && (isLast ? upperBound == numeric_limits<uint64_t>::max()
+                       : Histogram::bucketIndex(upperBound + 1) == index + 1);
+        failedBucketCount += isValid ? 0 : 1;
+    }
+    
+    // Powers of two and their neighbors are where the groups start.
+    size_t failedValueCount = 0;
+    for(unsigned bit = 0; bit < 64; bit++)
+    {
+        const auto power = uint64_t { 1 } << bit;
+        for(const auto value : { power - 1, power, power + 1 })
+        {
+            const auto index = Histogram::bucketIndex(value);
+            const bool isValid = index < Histogram::BucketCount
+                && Histogram::bucketUpperBound(index) >= value
+                && (index == 0 || Histogram::bucketUpperBound(index - 1) < value);
+            failedValueCount += isValid ? 0 : 1;
+        }
+    }
+    
+    report.addCheck("every value is at most the upper bound of its bucket [Histogram]",
+                    failedBucketCount == 0 && failedValueCount == 0,
+                    format("{} of {} buckets and {} values next to powers of two are misplaced",
+                           failedBucketCount, Histogram::BucketCount, failedValueCount));
+}
+
+void RunPercentileChecks(Report& report)
+{
+    // 90 values in the bucket [896 ns, 1023 ns] and 10 in [917504 ns, 1048575 ns]
+    Histogram histogram;
+    for(size_t index = 0; index < 90; index++) { histogram.record(1000ns); }
+    for(size_t index = 0; index < 10; index++) { histogram.record(1ms); }
+    
+    const auto snapshot = histogram.snapshot();
+    const auto median = snapshot.percentile(0.5);
+    const auto p90 = snapshot.percentile(0.9);
+    const auto p91 = snapshot.percentile(0.91);
+    const auto p99 = snapshot.percentile(0.99);
+    const auto empty = Histogram {}.snapshot().percentile(0.99);
+    
+    report.addCheck("percentiles return the upper bound of their bucket [Histogram]",
+                    median == 1023ns && p90 == 1023ns && p91 == 1048575ns && p99 == 1048575ns && empty == 0ns,
+                    format("p50 {} ns, p90 {} ns, p91 {} ns, p99 {} ns, {} ns without values",
+                           median.count(), p90.count(), p91.count(), p99.count(), empty.count()));
+}
+
+void RunPrometheusChecks(Report& report)
+{
+    // Values below the first and above the last exported bucket, and in between
+    auto metrics = make_unique<Metrics>();
+    auto& histogram = metrics->executors.runDuration;
+    uint64_t recordedCount = 0;
+    for(const auto duration : initializer_list<chrono::nanoseconds> { 0ns, 1ns, 999ns, 1us, 1025ns, 1ms, 1s, 1h, 100h })
+    {
+        for(size_t index = 0; index < 3; index++)
+        {
+            histogram.record(duration);
+            recordedCount++;
+        }
+    }
+    
+    const auto bucketPrefix = string { ExportedHistogramName } + "_bucket{le=\"";
+    const auto countPrefix = string { ExportedHistogramName } + "_count ";
+    
+    istringstream stream { metrics->prometheusText() };
+    string line;
+    size_t bucketCount = 0;
+    uint64_t previousCount = 0;
+    bool isNonDecreasing = true;
+    optional<uint64_t> infinityCount;
+    optional<uint64_t> count;
+    while(getline(stream, line))
+    {
+        if(line.starts_with(bucketPrefix))
+        {
+            const auto label = line.substr(bucketPrefix.size(), line.find('"', bucketPrefix.size()) - bucketPrefix.size());
+            const auto value = stoull(line.substr(line.rfind(' ') + 1));
+            isNonDecreasing = isNonDecreasing && value >= previousCount;
+            previousCount = value;
+            bucketCount++;
+            if(label == "+Inf") { infinityCount = value; }
+        }
+        else if(line.starts_with(countPrefix))
+        {
+            count = stoull(line.substr(countPrefix.size()));
+        }
+    }
+    
+    report.addCheck("exported buckets are cumulative and end at the count [Prometheus]",
+                    bucketCount > 1 && isNonDecreasing && infinityCount == count && count == recordedCount,
+                    format("{} buckets, {}, +Inf {}, count {} of {} recorded values",
+                           bucketCount, isNonDecreasing ? "non-decreasing" : "decreasing",
+                           infinityCount.value_or(0), count.value_or(0), recordedCount));
+}
+
+}
+
+void Awaken::Benchmarks::RunMetricsBenchmarks(Report& report, const Options&)
+{
+    RunBucketBoundaryChecks(report);
+    RunPercentileChecks(report);
+    RunPrometheusChecks(report);
+}
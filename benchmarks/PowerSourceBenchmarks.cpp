@@ -0,0 +1,359 @@
+//
+//  PowerSourceBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <Awaken/BasicAwaken.hpp>
+#include <Awaken/DischargeEstimator.hpp>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/InMemoryPowerSourceProvider.hpp>
+#include <Awaken/IOPowerAssertion.hpp>
+#include <Awaken/IOPowerSource.hpp>
+#include <Awaken/TimerWheelWaiter.hpp>
+
+#if defined(__linux__)
+#include <Awaken/SysfsPowerSourceProvider.hpp>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The number of subscribers notified next to the capacity change handler
+constexpr size_t FanOutSubscriberCount = 3;
+
+/// The discharge rate of the simulated battery in percent per hour
+constexpr float SimulatedDischargeRate = 12;
+
+/// The minimum battery capacity of the simulated and the early released sessions
+constexpr float MinimumCapacity = 20;
+
+PowerSourceSnapshot MakeSnapshot(float capacity)
+{
+    PowerSourceSnapshot snapshot;
+    snapshot.sourceCount = 1;
+    snapshot.sources[0].type = PowerSourceSnapshot::Type::InternalBattery;
+    snapshot.sources[0].capacity = capacity;
+    return snapshot;
+}
+
+void RunInMemoryBenchmark(Report& report, const Options& options)
+{
+    auto provider = make_shared<InMemoryPowerSourceProvider>();
+    provider->setSnapshot(MakeSnapshot(50));
+    
+    IOPowerSource powerSource { provider };
+    atomic<Clock::rep> notifiedAt { 0 };
+    atomic<size_t> notificationCount { 0 };
+    powerSource.setCapacityChangeHandler([&](float) {
+        notifiedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        notificationCount.fetch_add(1, memory_order_release);
+    });
+    powerSource.registerForCapacityChanges();
+    
+    // The handlers are called on the executor, wait for each change
+    // to be delivered before the next one is made.
+    const auto waitForNotification = [&](size_t count) {
+        const auto deadline = Clock::now() + 1s;
+        while(notificationCount.load(memory_order_acquire) < count && Clock::now() < deadline)
+        {
+            this_thread::yield();
+        }
+    };
+    
+    vector<chrono::nanoseconds> notifications;
+    notifications.reserve(options.iterations);
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        const auto snapshot = MakeSnapshot(iteration % 2 == 0 ? 49 : 50);
+        const auto count = notificationCount.load(memory_order_relaxed);
+        const auto start = Clock::now();
+        provider->setSnapshot(snapshot);
+        waitForNotification(count + 1);
+        notifications.push_back(Clock::duration { notifiedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+    }
+    report.addLatencies("notification-to-handler [IOPowerSource, in-memory]", std::move(notifications));
+    
+    // Queries between notifications must be served from the cache.
+    vector<chrono::nanoseconds> queries;
+    queries.reserve(options.iterations);
+    const auto copyCount = provider->copyCount();
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        queries.push_back(Measure([&] { [[maybe_unused]] auto capacity = powerSource.capacity(); }));
+    }
+    report.addLatencies("IOPowerSource::capacity() [cached]", std::move(queries));
+    
+    const auto copies = provider->copyCount() - copyCount;
+    report.addCheck("capacity queries are served from the snapshot cache",
+                    copies == 0,
+                    format("{} queries copied {} snapshots", options.iterations, copies));
+    
+    // Several subscribers are called from the same immutable handler list,
+    // one of them removes itself from within its first call.
+    atomic<size_t> subscriberCalls { 0 };
+    for(size_t index = 0; index < FanOutSubscriberCount; index++)
+    {
+        powerSource.subscribeToCapacityChanges([&](float) {
+            subscriberCalls.fetch_add(1, memory_order_relaxed);
+        });
+    }
+    atomic<size_t> selfRemovingCalls { 0 };
+    auto selfRemoving = make_shared<Subscription>();
+    *selfRemoving = powerSource.subscribeToCapacityChanges([&, selfRemoving](float) {
+        selfRemovingCalls.fetch_add(1, memory_order_relaxed);
+        powerSource.unsubscribe(*selfRemoving);
+    });
+    
+    vector<chrono::nanoseconds> fanOuts;
+    fanOuts.reserve(options.iterations);
+    size_t allocations = 0;
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        const auto snapshot = MakeSnapshot(iteration % 2 == 0 ? 49 : 50);
+        const auto count = notificationCount.load(memory_order_relaxed);
+        const auto allocationCount = AllocationCount();
+        const auto start = Clock::now();
+        provider->setSnapshot(snapshot);
+        waitForNotification(count + 1);
+        fanOuts.push_back(Clock::duration { notifiedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+        if(iteration > 0)
+        {
+            allocations += AllocationCount() - allocationCount;
+        }
+    }
+    
+    // The capacity change handler is called first, the subscribers may still be running.
+    const auto expectedCalls = FanOutSubscriberCount * options.iterations;
+    const auto deadline = Clock::now() + 1s;
+    while(subscriberCalls.load(memory_order_relaxed) < expectedCalls && Clock::now() < deadline)
+    {
+        this_thread::yield();
+    }
+    report.addLatencies(format("notification-to-handler [IOPowerSource, {} subscribers]", FanOutSubscriberCount + 1),
+                        std::move(fanOuts));
+    
+    report.addCheck("capacity changes fan out to all subscribers",
+                    subscriberCalls.load() == expectedCalls && selfRemovingCalls.load() == 1,
+                    format("{} of {} subscriber calls, {} self-removing calls",
+                           subscriberCalls.load(), expectedCalls, selfRemovingCalls.load()));
+    report.addCheck("capacity changes fan out without allocating",
+                    allocations == 0,
+                    format("{} allocations in {} notifications", allocations, options.iterations - 1));
+}
+
+void RunDischargeSimulation(Report& report)
+{
+    // A battery discharging linearly from 100 %, which reports whole
+    // percents like the platform providers, is sampled at the interval
+    // chosen by the estimator until it reports the minimum capacity.
+    using EstimatorClock = DischargeEstimator::Clock;
+    const auto start = EstimatorClock::time_point {};
+    const auto trueCapacity = [&](EstimatorClock::time_point time) {
+        return 100.0f - SimulatedDischargeRate * chrono::duration<float, ratio<3600>>(time - start).count();
+    };
+    const auto crossing = start + chrono::duration_cast<EstimatorClock::duration>(
+        chrono::duration<float, ratio<3600>>((100.0f - (MinimumCapacity + 1)) / SimulatedDischargeRate));
+    
+    DischargeEstimator estimator;
+    auto time = start;
+    size_t sampleCount = 0;
+    optional<chrono::seconds> predictionError;
+    while(true)
+    {
+        PowerSourceSnapshot snapshot;
+        snapshot.type = PowerSourceSnapshot::Type::InternalBattery;
+        snapshot.capacity = floor(trueCapacity(time));
+        estimator.record(snapshot, time);
+        sampleCount++;
+        
+        if(snapshot.capacity <= MinimumCapacity) { break; }
+        if(!predictionError && snapshot.capacity <= 60)
+        {
+            if(const auto remaining = estimator.timeUntil(MinimumCapacity, time))
+            {
+                predictionError = chrono::abs(chrono::duration_cast<chrono::seconds>(time + *remaining - crossing));
+            }
+        }
+        time += estimator.samplingInterval(MinimumCapacity, time);
+    }
+    
+    const auto overshoot = chrono::duration_cast<chrono::seconds>(time - crossing);
+    const auto fixedSampleCount = static_cast<size_t>((crossing - start) / DischargeEstimator::MinimumSamplingInterval);
+    const auto rate = estimator.dischargeRate().value_or(0);
+    
+    report.addCheck("the discharge rate converges to the simulated rate",
+                    abs(rate - SimulatedDischargeRate) < SimulatedDischargeRate * 0.1f,
+                    format("{:.2f} %/h estimated, {:.2f} %/h simulated", rate, SimulatedDischargeRate));
+    report.addCheck("the time to the minimum capacity is predicted within 5 minutes",
+                    predictionError && *predictionError <= 5min,
+                    format("off by {} s at 60 %", predictionError.value_or(chrono::seconds::max()).count()));
+    report.addCheck("adaptive sampling detects the minimum capacity within the shortest interval",
+                    overshoot <= DischargeEstimator::MinimumSamplingInterval,
+                    format("detected {} s after the crossing", overshoot.count()));
+    report.addCheck("adaptive sampling wakes up less than sampling at the shortest interval",
+                    sampleCount * 10 < fixedSampleCount,
+                    format("{} samples instead of {}", sampleCount, fixedSampleCount));
+    report.addCounter("adaptive sampling wakeups [100 % to 20 % at 12 %/h]", static_cast<double>(sampleCount), "samples");
+}
+
+void RunEarlyReleaseBenchmark(Report& report)
+{
+    using BatteryAwaken = BasicAwaken<IOPowerAssertion, IOPowerSource, TimerWheelWaiter>;
+    
+    // Without a margin the session ends at the minimum capacity,
+    // with one as soon as the capacity is predicted to reach it.
+    for(const chrono::seconds margin : { 0s, 3600s })
+    {
+        auto provider = make_shared<InMemoryPowerSourceProvider>();
+        provider->setSnapshot(MakeSnapshot(50));
+        
+        BatteryAwaken awaken { "awaken-benchmark", piecewise_construct,
+                               forward_as_tuple(make_shared<InMemoryPowerAssertionBackend>()),
+                               forward_as_tuple(provider),
+                               tuple {} };
+        awaken.setMinimumBatteryCapacity(MinimumCapacity);
+        awaken.setMinimumBatteryCapacityMargin(margin);
+        
+        atomic<bool> didEnd { false };
+        atomic<int> endCapacity { 0 };
+        awaken.setMinimumBatteryCapacityReachedHandler([&](float capacity) {
+            endCapacity.store(static_cast<int>(capacity), memory_order_relaxed);
+        });
+        atomic<HoldEndReason> endReason { HoldEndReason::Failed };
+        awaken.subscribeToEnd([&](HoldEndReason reason) {
+            endReason.store(reason, memory_order_relaxed);
+            didEnd.store(true, memory_order_release);
+        });
+        awaken.run();
+        
+        for(int capacity = 49; capacity >= 0 && !didEnd.load(memory_order_acquire); capacity--)
+        {
+            this_thread::sleep_for(2ms);
+            provider->setSnapshot(MakeSnapshot(static_cast<float>(capacity)));
+        }
+        SpinUntil(didEnd);
+        
+        const auto isEarly = margin > 0s;
+        const auto capacity = endCapacity.load(memory_order_relaxed);
+        report.addCheck(isEarly ? "a margin releases before the minimum battery capacity is reached"
+                                : "no margin releases at the minimum battery capacity",
+                        endReason.load() == HoldEndReason::BatteryThreshold
+                            && (isEarly ? capacity > MinimumCapacity : capacity == MinimumCapacity),
+                        format("released at {} % with a minimum of {:.0f} %", capacity, MinimumCapacity));
+    }
+}
+
+#if defined(__linux__)
+void RunSysfsBenchmark(Report& report, const Options& options)
+{
+    const auto root = filesystem::temp_directory_path() / format("awaken-benchmark-{}", getpid());
+    const auto battery = root / "BAT0";
+    filesystem::create_directories(battery);
+    
+    const auto writeAttribute = [&battery](const string& name, const string& value) {
+        // Replace the file atomically, so the provider never reads a partial value.
+        const auto temporaryPath = battery / ("." + name);
+        ofstream { temporaryPath } << value << "\n";
+        filesystem::rename(temporaryPath, battery / name);
+    };
+    writeAttribute("type", "Battery");
+    writeAttribute("capacity", "50");
+    
+    {
+        IOPowerSource powerSource { make_shared<SysfsPowerSourceProvider>(root) };
+        atomic<Clock::rep> notifiedAt { 0 };
+        atomic<int> notifiedCapacity { 50 };
+        powerSource.setCapacityChangeHandler([&](float capacity) {
+            notifiedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+            notifiedCapacity.store(static_cast<int>(capacity), memory_order_release);
+        });
+        powerSource.registerForCapacityChanges();
+        
+        vector<chrono::nanoseconds> samples;
+        size_t missedCount = 0;
+        const auto iterations = min<size_t>(options.iterations, 200);
+        for(size_t iteration = 0; iteration < iterations; iteration++)
+        {
+            const int capacity = iteration % 2 == 0 ? 49 : 50;
+            const auto start = Clock::now();
+            writeAttribute("capacity", to_string(capacity));
+            
+            const auto deadline = start + 1s;
+            while(notifiedCapacity.load(memory_order_acquire) != capacity && Clock::now() < deadline)
+            {
+                this_thread::yield();
+            }
+            if(notifiedCapacity.load(memory_order_acquire) != capacity)
+            {
+                missedCount++;
+                notifiedCapacity.store(capacity, memory_order_relaxed);
+                continue;
+            }
+            samples.push_back(Clock::duration { notifiedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+        }
+        
+        report.addCheck("sysfs changes reach the capacity handler",
+                        missedCount == 0,
+                        format("{} of {} changes were not reported", missedCount, iterations));
+        report.addLatencies("notification-to-handler [IOPowerSource, sysfs]", std::move(samples));
+    }
+    
+    {
+        // The observing thread outlives a provider destroyed by its own change handler.
+        const auto threadCount = ThreadCount();
+        auto provider = make_unique<SysfsPowerSourceProvider>(root);
+        atomic<size_t> handlerCount { 0 };
+        provider->startObserving([&] {
+            provider = nullptr;
+            handlerCount.fetch_add(1, memory_order_release);
+        });
+        writeAttribute("capacity", "48");
+        
+        const auto deadline = Clock::now() + 5s;
+        while((handlerCount.load(memory_order_acquire) == 0 || ThreadCount() != threadCount) && Clock::now() < deadline)
+        {
+            this_thread::yield();
+        }
+        writeAttribute("capacity", "47");
+        this_thread::sleep_for(50ms);
+        
+        report.addCheck("a provider destroyed by its change handler stops observing [sysfs]",
+                        handlerCount.load(memory_order_acquire) == 1 && ThreadCount() == threadCount,
+                        format("{} handler calls, {} threads before, {} after",
+                               handlerCount.load(memory_order_acquire),
+                               threadCount.value_or(0), ThreadCount().value_or(0)));
+    }
+    
+    error_code error;
+    filesystem::remove_all(root, error);
+}
+#endif
+
+}
+
+void Awaken::Benchmarks::RunPowerSourceBenchmarks(Report& report, const Options& options)
+{
+    RunInMemoryBenchmark(report, options);
+    RunDischargeSimulation(report);
+    RunEarlyReleaseBenchmark(report);
+#if defined(__linux__)
+    RunSysfsBenchmark(report, options);
+#endif
+}
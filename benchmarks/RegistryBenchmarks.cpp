@@ -0,0 +1,170 @@
+//
+//  RegistryBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <format>
+#include <thread>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/IOPowerAssertion.hpp>
+#include <Awaken/NullPowerAssertionBackend.hpp>
+#include <Awaken/PowerAssertionRegistry.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+constexpr size_t CoalescedPairCount = 10'000;
+constexpr size_t CoalescingThreadCount = 4;
+constexpr auto JoinedTimeout = 60s;
+/// The number of backend assertions created and released by a long-running process
+constexpr size_t NullBackendCycleCount = 100'000;
+/// The number of sessions that each run with a timeout of their own
+constexpr size_t VaryingTimeoutCount = 1000;
+
+void RunCoalescingBenchmark(Report& report, const Options& options)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    PowerAssertionRegistry registry { backend };
+    auto& entry = registry.entry(PowerAssertionType::PreventUserIdleSystemSleep, 0s);
+    
+    // One session keeps the assertion while the others come and go.
+    registry.acquire(entry, "awaken-benchmark");
+    const auto heldCallCount = backend->createCount() + backend->releaseCount() + backend->updateCount();
+    
+    vector<thread> threads;
+    for(size_t index = 0; index < CoalescingThreadCount; index++)
+    {
+        threads.emplace_back([&registry, &entry] {
+            for(size_t pair = 0; pair < CoalescedPairCount / CoalescingThreadCount; pair++)
+            {
+                registry.acquire(entry, "awaken-benchmark");
+                registry.release(entry);
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    
+    // Without a timeout to extend, joining and leaving only counts references.
+    const auto pairCallCount = backend->createCount() + backend->releaseCount() + backend->updateCount() - heldCallCount;
+    report.addCheck("joining an assertion without a timeout does not call the backend",
+                    pairCallCount == 0,
+                    format("{} backend calls for {} acquire/release pairs", pairCallCount, CoalescedPairCount));
+    
+    vector<chrono::nanoseconds> samples;
+    samples.reserve(options.iterations);
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        samples.push_back(Measure([&] {
+            registry.acquire(entry, "awaken-benchmark");
+            registry.release(entry);
+        }));
+    }
+    report.addLatencies("acquire/release pair [PowerAssertionRegistry, held]", std::move(samples));
+    
+    registry.release(entry);
+    
+    const auto createCount = backend->createCount();
+    const auto releaseCount = backend->releaseCount();
+    report.addCheck("acquire/release pairs coalesce into one backend assertion",
+                    createCount == 1 && releaseCount == 1,
+                    format("{} pairs on {} threads: {} creates, {} releases",
+                           CoalescedPairCount, CoalescingThreadCount, createCount, releaseCount));
+}
+
+void RunJoinedTimeoutBenchmark(Report& report, const Options&)
+{
+    constexpr auto type = PowerAssertionType::PreventUserIdleSystemSleep;
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    PowerAssertionRegistry registry { backend };
+    auto& entry = registry.entry(type, JoinedTimeout);
+    
+    // The second session joins later, its timeout ends after the first one's.
+    registry.acquire(entry, "awaken-benchmark");
+    this_thread::sleep_for(10ms);
+    const bool didJoin = registry.acquire(entry, "awaken-benchmark");
+    const auto updateCount = backend->updateCount();
+    
+    backend->setFailing(type, true);
+    const bool didJoinFailing = registry.acquire(entry, "awaken-benchmark");
+    const auto references = entry.references();
+    backend->setFailing(type, false);
+    
+    registry.release(entry);
+    registry.release(entry);
+    
+    report.addCheck("a joining session extends the shared backend assertion to its own timeout",
+                    didJoin && updateCount == 1 && backend->createCount() == 1,
+                    format("{} creates, {} timeout updates", backend->createCount(), updateCount));
+    report.addCheck("a session that cannot extend the shared backend assertion does not join it",
+                    !didJoinFailing && references == 2,
+                    format("acquire {}, {} references", didJoinFailing ? "succeeded" : "failed", references));
+}
+
+void RunNullBackendBenchmark(Report& report, const Options&)
+{
+    PowerAssertionRegistry registry { make_shared<NullPowerAssertionBackend>() };
+    auto& entry = registry.entry(PowerAssertionType::PreventUserIdleSystemSleep, JoinedTimeout);
+    
+    const string name { "awaken-benchmark" };
+    const auto allocationCount = AllocationCount();
+    bool didAcquire = true;
+    for(size_t cycle = 0; cycle < NullBackendCycleCount; cycle++)
+    {
+        didAcquire = registry.acquire(entry, name) && didAcquire;
+        didAcquire = registry.acquire(entry, name) && didAcquire;
+        registry.release(entry);
+        registry.release(entry);
+    }
+    const auto allocations = AllocationCount() - allocationCount;
+    
+    report.addCheck("the null backend holds sessions without growing",
+                    didAcquire && allocations == 0,
+                    format("{} allocations in {} backend assertions", allocations, NullBackendCycleCount));
+}
+
+void RunVaryingTimeoutBenchmark(Report& report, const Options&)
+{
+    auto registry = make_shared<PowerAssertionRegistry>(make_shared<InMemoryPowerAssertionBackend>());
+    IOPowerAssertion heldAssertion { registry };
+    heldAssertion.preventUserIdleSystemSleep = true;
+    heldAssertion.timeout = JoinedTimeout;
+    heldAssertion.run();
+    
+    // Every session uses a timeout no other session used before.
+    IOPowerAssertion assertion { registry };
+    assertion.preventUserIdleSystemSleep = true;
+    bool didRun = true;
+    for(size_t session = 1; session <= VaryingTimeoutCount; session++)
+    {
+        assertion.timeout = JoinedTimeout + chrono::seconds(session);
+        didRun = assertion.run() && didRun;
+        assertion.cancel();
+    }
+    heldAssertion.cancel();
+    
+    const auto entries = registry->statistics().entries;
+    report.addCheck("sessions with varying timeouts reuse the registry's entries",
+                    didRun && entries == 2,
+                    format("{} entries after {} timeouts", entries, VaryingTimeoutCount + 1));
+}
+
+}
+
+void Awaken::Benchmarks::RunRegistryBenchmarks(Report& report, const Options& options)
+{
+    RunCoalescingBenchmark(report, options);
+    RunJoinedTimeoutBenchmark(report, options);
+    RunNullBackendBenchmark(report, options);
+    RunVaryingTimeoutBenchmark(report, options);
+}
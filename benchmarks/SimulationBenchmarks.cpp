@@ -0,0 +1,228 @@
+//
+//  SimulationBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <format>
+#include <memory>
+#include <optional>
+#include <random>
+#include <Awaken/BasicAwaken.hpp>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/IOPowerAssertion.hpp>
+#include <Awaken/ThreadWaiter.hpp>
+#include <Awaken/TimeSource.hpp>
+#include <Awaken/TimerWheel.hpp>
+#include <Awaken/TimerWheelWaiter.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+using SimulatedAwaken = BasicAwaken<IOPowerAssertion, NoPowerSource, TimerWheelWaiter>;
+using TimePoint = TimeSource::Clock::time_point;
+
+/// The number of clients that run sessions over the simulated day
+constexpr size_t SimulatedClientCount = 10000;
+/// Clients stop starting sessions after this time
+constexpr auto SimulatedDuration = 24h;
+/// The bounds of session timeouts and of the idle time between sessions
+constexpr auto ShortestPeriod = 1min;
+constexpr auto LongestPeriod = 2h;
+/// The share of sessions that are cancelled before their timeout, in percent
+constexpr uint64_t CancelledPercentage = 20;
+
+/// A client that runs one session after the other, each for a random
+/// timeout or until it cancels it, with random idle times in between.
+/// All handlers are called on the thread advancing the time source.
+class SimulatedClient
+{
+public:
+    SimulatedClient(shared_ptr<InMemoryPowerAssertionBackend> backend, TimerWheel& wheel, mt19937_64& random) noexcept
+        : _wheel(wheel)
+        , _random(random)
+        , _session("awaken-simulation", piecewise_construct, tuple { backend }, tuple {},
+                   forward_as_tuple(wheel, InlineExecutor::shared()))
+        , _start([this]{ this->start(); })
+        , _cancel([this]{ this->_session.cancel(); })
+    {
+        this->_session.setPreventUserIdleSystemSleep(true);
+        this->_session.subscribeToEnd([this](HoldEndReason reason) { this->sessionDidEnd(reason); });
+    }
+
+    /// Schedules the first session
+    void schedule(TimePoint end) noexcept
+    {
+        this->_end = end;
+        this->_wheel.schedule(this->_start, this->_wheel.now() + this->period());
+    }
+
+    size_t runCount() const noexcept { return this->_runCount; }
+    size_t endCount() const noexcept { return this->_endCount; }
+    size_t timeoutCount() const noexcept { return this->_timeoutCount; }
+    /// The number of sessions that did not end exactly when expected
+    size_t lateCount() const noexcept { return this->_lateCount; }
+    /// The largest difference between an expected and an actual end
+    chrono::nanoseconds maximumError() const noexcept { return this->_maximumError; }
+
+private:
+    TimerWheel& _wheel;
+    mt19937_64& _random;
+    SimulatedAwaken _session;
+    TimerWheel::Timer _start;
+    TimerWheel::Timer _cancel;
+    TimePoint _end;
+    optional<TimePoint> _expectedEnd = nullopt;
+
+    size_t _runCount = 0;
+    size_t _endCount = 0;
+    size_t _timeoutCount = 0;
+    size_t _lateCount = 0;
+    chrono::nanoseconds _maximumError { 0 };
+
+    /// Returns a random number of whole seconds between the shortest and longest period
+    chrono::seconds period() noexcept
+    {
+        const auto range = chrono::seconds(LongestPeriod - ShortestPeriod).count() + 1;
+        return ShortestPeriod + chrono::seconds(static_cast<int64_t>(this->_random() % static_cast<uint64_t>(range)));
+    }
+
+    void start() noexcept
+    {
+        const auto now = this->_wheel.now();
+        if(now >= this->_end) { return; }
+
+        const auto timeout = this->period();
+        this->_session.setTimeout(timeout);
+        if(!this->_session.run()) { return; }
+        this->_runCount++;
+
+        this->_expectedEnd = now + timeout;
+        if(this->_random() % 100 < CancelledPercentage)
+        {
+            const auto cancelAfter = chrono::seconds(static_cast<int64_t>(this->_random() % static_cast<uint64_t>(timeout.count())));
+            this->_expectedEnd = now + cancelAfter;
+            this->_wheel.schedule(this->_cancel, now + cancelAfter);
+        }
+    }
+
+    void sessionDidEnd(HoldEndReason reason) noexcept
+    {
+        const auto now = this->_wheel.now();
+        this->_endCount++;
+        this->_timeoutCount += reason == HoldEndReason::Timeout ? 1 : 0;
+
+        if(const auto expectedEnd = this->_expectedEnd)
+        {
+            const auto error = chrono::abs(now - *expectedEnd);
+            this->_lateCount += error > 0ns ? 1 : 0;
+            this->_maximumError = max(this->_maximumError, chrono::duration_cast<chrono::nanoseconds>(error));
+        }
+        this->_expectedEnd = nullopt;
+
+        this->_wheel.schedule(this->_start, now + this->period());
+    }
+};
+
+void RunChurnSimulation(Report& report, const Options&)
+{
+    // A fixed seed replays the same day on every run.
+    mt19937_64 random { 20261017 };
+    VirtualTimeSource timeSource;
+    TimerWheel wheel { timeSource };
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+
+    vector<unique_ptr<SimulatedClient>> clients;
+    clients.reserve(SimulatedClientCount);
+    const auto end = timeSource.now() + SimulatedDuration;
+    for(size_t index = 0; index < SimulatedClientCount; index++)
+    {
+        clients.push_back(make_unique<SimulatedClient>(backend, wheel, random));
+        clients.back()->schedule(end);
+    }
+
+    // The sessions that are still running at the end of the day time out afterwards.
+    const auto startedAt = Clock::now();
+    timeSource.advance(SimulatedDuration + LongestPeriod);
+    const auto elapsed = chrono::duration<double>(Clock::now() - startedAt);
+
+    size_t runCount = 0, endCount = 0, timeoutCount = 0, lateCount = 0;
+    chrono::nanoseconds maximumError { 0 };
+    for(const auto& client : clients)
+    {
+        runCount += client->runCount();
+        endCount += client->endCount();
+        timeoutCount += client->timeoutCount();
+        lateCount += client->lateCount();
+        maximumError = max(maximumError, client->maximumError());
+    }
+
+    const auto simulated = chrono::duration<double>(SimulatedDuration + LongestPeriod);
+    report.addCounter("simulated sessions [day of churn]", static_cast<double>(runCount), "sessions");
+    report.addCounter("simulated time per real time [day of churn]", simulated / elapsed, "x");
+    report.addCheck("a simulated day of churn releases every session at its exact deadline",
+                    runCount > 0 && endCount == runCount && timeoutCount > 0 && lateCount == 0,
+                    format("{} of {} sessions ended, {} timed out, {} ended late by up to {} ns",
+                           endCount, runCount, timeoutCount, lateCount, maximumError.count()));
+    report.addCheck("all simulated sessions released their power assertions", backend->activeCount() == 0,
+                    format("{} backend assertions held after the day", backend->activeCount()));
+}
+
+void RunThreadWaiterSimulation(Report& report, const Options&)
+{
+    VirtualTimeSource timeSource;
+    ThreadWaiter waiter { InlineExecutor::shared(), timeSource };
+    atomic<bool> didTimeOut = false;
+    waiter.setTimeoutHandler([&didTimeOut] { didTimeOut.store(true, memory_order_release); });
+    waiter.setTimeout(2h);
+    waiter.run();
+
+    // The waiting thread checks the virtual time every millisecond.
+    timeSource.advance(2h - 1s);
+    this_thread::sleep_for(20ms);
+    const bool didTimeOutEarly = didTimeOut.load(memory_order_acquire);
+
+    timeSource.advance(1s);
+    const bool didTimeOutInTime = SpinUntil(didTimeOut, 1s);
+    report.addCheck("ThreadWaiter times out after two simulated hours",
+                    !didTimeOutEarly && didTimeOutInTime,
+                    format("timed out {} the deadline", didTimeOutEarly ? "before" : didTimeOutInTime ? "at" : "long after"));
+}
+
+void RunDeadlineSimulation(Report& report, const Options&)
+{
+    VirtualTimeSource timeSource;
+    TimerWheel wheel { timeSource };
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    SimulatedAwaken session { "awaken-simulation", piecewise_construct, tuple { backend }, tuple {},
+                              forward_as_tuple(wheel, InlineExecutor::shared()) };
+    session.setPreventUserIdleSystemSleep(true);
+    session.setTimeout(1min);
+    session.run();
+    
+    // The simulated deadline lies long before the steady clock's now,
+    // the backend is extended by the simulated time remaining.
+    const bool didMove = session.setDeadline(timeSource.now() + LongestPeriod);
+    const auto updateCount = backend->updateCount();
+    session.cancel();
+    
+    report.addCheck("moving a simulated deadline extends the backend assertion",
+                    didMove && updateCount == 1,
+                    format("deadline {}, {} timeout updates", didMove ? "moved" : "not moved", updateCount));
+}
+
+}
+
+void Awaken::Benchmarks::RunSimulationBenchmarks(Report& report, const Options& options)
+{
+    RunChurnSimulation(report, options);
+    RunThreadWaiterSimulation(report, options);
+    RunDeadlineSimulation(report, options);
+}
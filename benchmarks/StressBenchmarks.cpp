@@ -0,0 +1,148 @@
+//
+//  StressBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <format>
+#include <random>
+#include <Awaken/Awaken.hpp>
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <Awaken/Metrics.hpp>
+#include <Awaken/ThreadWaiter.hpp>
+#include <Awaken/TimerWheelWaiter.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// The number of threads racing on a single session,
+/// meant to be run with `-Db_sanitize=thread`
+constexpr size_t StressThreadCount = 4;
+
+/// The number of sessions the timeout handler may start itself
+constexpr int HandlerRunBudget = 100;
+
+template<typename WaiterClass>
+void RunStressBenchmark(const string& waiterName, Report& report, const Options& options)
+{
+    auto backend = make_shared<InMemoryPowerAssertionBackend>();
+    ::Awaken::Awaken awaken { "awaken-stress", backend, make_unique<WaiterClass>() };
+    awaken.setPreventUserIdleSystemSleep(true);
+    awaken.setPreventUserIdleDisplaySleep(true);
+    awaken.setTimeout(60s);
+    
+    atomic<size_t> runs = 0;
+    atomic<size_t> handlerCalls = 0;
+    atomic<size_t> handlersInFlight = 0;
+    atomic<int> handlerRunBudget = HandlerRunBudget;
+    
+    // Every session that was run ends exactly once, handlers
+    // may start the next session from within the handler.
+    awaken.setTimeoutHandler([&] {
+        handlersInFlight.fetch_add(1, memory_order_relaxed);
+        handlerCalls.fetch_add(1, memory_order_relaxed);
+        if(handlerRunBudget.fetch_sub(1, memory_order_relaxed) > 0 && awaken.run())
+        {
+            runs.fetch_add(1, memory_order_relaxed);
+        }
+        handlersInFlight.fetch_sub(1, memory_order_release);
+    });
+    
+    const auto start = Clock::now();
+    vector<thread> threads;
+    for(size_t index = 0; index < StressThreadCount; index++)
+    {
+        threads.emplace_back([&, index] {
+            minstd_rand random { static_cast<minstd_rand::result_type>(index + 1) };
+            for(size_t iteration = 0; iteration < options.iterations; iteration++)
+            {
+                switch(random() % 5)
+                {
+                    case 0:
+                    case 1:
+                        if(awaken.run())
+                        {
+                            runs.fetch_add(1, memory_order_relaxed);
+                        }
+                        break;
+                    case 2:
+                        awaken.cancel();
+                        break;
+                    case 3:
+                        // Races an expiring waiter against cancel().
+                        awaken.setDeadline(Clock::now());
+                        break;
+                    case 4:
+                        awaken.extendBy(1s);
+                        awaken.deadline();
+                        break;
+                }
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    
+    // Timeouts end on the waiter's thread, the last one may still be releasing.
+    handlerRunBudget.store(0, memory_order_relaxed);
+    awaken.cancel();
+    // Handlers that re-run the session may be
+    // called on a detached waiter thread.
+    const auto isSettled = [&] {
+        return handlersInFlight.load(memory_order_acquire) == 0
+            && !awaken.isRunning()
+            && handlerCalls.load(memory_order_relaxed) == runs.load(memory_order_relaxed);
+    };
+    const auto settleDeadline = Clock::now() + 5s;
+    while(!isSettled() && Clock::now() < settleDeadline)
+    {
+        this_thread::yield();
+    }
+    const bool didSettle = isSettled();
+    const auto elapsed = Clock::now() - start;
+    
+    const auto operations = static_cast<double>(StressThreadCount * options.iterations);
+    report.addCounter(format("concurrent operations per second [{}]", waiterName),
+                      operations / chrono::duration<double>(elapsed).count(), "operations/s");
+    report.addCounter(format("sessions run concurrently [{}]", waiterName),
+                      static_cast<double>(runs.load()), "sessions");
+    
+    report.addCheck(format("concurrent sessions settle [{}]", waiterName),
+                    didSettle,
+                    format("{} sessions run, {} handler calls", runs.load(), handlerCalls.load()));
+    report.addCheck(format("every concurrent session ends exactly once [{}]", waiterName),
+                    handlerCalls.load() == runs.load(),
+                    format("{} sessions run, {} handler calls", runs.load(), handlerCalls.load()));
+    
+    const auto& metrics = awaken.metrics();
+    uint64_t ended = 0;
+    for(const auto& counter : metrics.ended)
+    {
+        ended += counter.value();
+    }
+    report.addCheck(format("session metrics balance [{}]", waiterName),
+                    metrics.started.value() == ended && metrics.active.value() == 0,
+                    format("{} started, {} ended, {} active", metrics.started.value(), ended, metrics.active.value()));
+    
+    const auto activeCount = backend->activeCount();
+    report.addCheck(format("no assertions leak from concurrent sessions [{}]", waiterName),
+                    activeCount == 0,
+                    format("{} backend assertions held", activeCount));
+}
+
+}
+
+void Awaken::Benchmarks::RunStressBenchmarks(Report& report, const Options& options)
+{
+    RunStressBenchmark<ThreadWaiter>("ThreadWaiter", report, options);
+    RunStressBenchmark<TimerWheelWaiter>("TimerWheelWaiter", report, options);
+}
@@ -0,0 +1,166 @@
+//
+//  TraceBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <cstring>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Awaken/Trace.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+constexpr TraceEventDescriptor SignedDescriptor { TraceLevel::Info, "Waiting for %{public}lld seconds.", __FILE__, __LINE__ };
+constexpr TraceEventDescriptor UnsignedDescriptor { TraceLevel::Info, "Source %{public}u of %{public}u.", __FILE__, __LINE__ };
+constexpr TraceEventDescriptor FloatingDescriptor { TraceLevel::Error, "Capacity %{public}.00f %% reached.", __FILE__, __LINE__ };
+constexpr TraceEventDescriptor MissingDescriptor { TraceLevel::Info, "%{public}lld and %{public}lld", __FILE__, __LINE__ };
+constexpr TraceEventDescriptor WrapDescriptor { TraceLevel::Debug, "Event %{public}llu", __FILE__, __LINE__ };
+
+/// The format of the events recorded below the compiled trace level
+constexpr const char* DebugFormat = "Benchmark debug event %{public}u";
+constexpr const char* ErrorFormat = "Benchmark error event %{public}u";
+
+/// The capacity of the buffer that truncates a formatted event
+constexpr size_t TruncatedCapacity = 16;
+
+/// Returns the recorded events of the call site ordered by time
+vector<TraceRecord> RecordsOf(const TraceEventDescriptor& descriptor)
+{
+    vector<TraceRecord> records;
+    for(const auto& record : Trace::records())
+    {
+        if(record.descriptor == &descriptor) { records.push_back(record); }
+    }
+    return records;
+}
+
+/// Returns the formatted event without the timestamp, thread and level
+string Message(const TraceRecord& record)
+{
+    const auto line = Trace::format(record);
+    const auto separator = line.find(": ");
+    return separator == string::npos ? line : line.substr(separator + 2);
+}
+
+void RunFormatChecks(Report& report)
+{
+    Trace::clear();
+    Trace::record(SignedDescriptor, -5LL);
+    Trace::record(UnsignedDescriptor, 3u, 4u);
+    Trace::record(FloatingDescriptor, 49.6);
+    Trace::record(MissingDescriptor, 1LL);
+    
+    struct Expectation
+    {
+        const TraceEventDescriptor& descriptor;
+        string_view message;
+    };
+    const Expectation expectations[] = {
+        { SignedDescriptor, "Waiting for -5 seconds." },
+        { UnsignedDescriptor, "Source 3 of 4." },
+        { FloatingDescriptor, "Capacity 50 % reached." },
+        { MissingDescriptor, "1 and <missing>" },
+    };
+    
+    size_t mismatchCount = 0;
+    string mismatches;
+    for(const auto& expectation : expectations)
+    {
+        const auto records = RecordsOf(expectation.descriptor);
+        const auto message = records.size() == 1 ? Message(records.front()) : format("{} events", records.size());
+        if(message != expectation.message)
+        {
+            mismatchCount++;
+            mismatches += format(", \"{}\" instead of \"{}\"", message, expectation.message);
+        }
+    }
+    report.addCheck("events format back to their text [Trace]",
+                    mismatchCount == 0,
+                    format("{} of {} events mismatched{}", mismatchCount, size(expectations), mismatches));
+    
+    // A truncated line is the terminated start of the full line.
+    const auto records = RecordsOf(SignedDescriptor);
+    const auto line = records.empty() ? string {} : Trace::format(records.front());
+    char buffer[TruncatedCapacity];
+    memset(buffer, 'x', sizeof(buffer));
+    const auto length = records.empty() ? 0 : Trace::format(records.front(), buffer, sizeof(buffer));
+    const auto isTruncated = length == TruncatedCapacity - 1
+        && strlen(buffer) == length
+        && line.compare(0, length, buffer) == 0;
+    
+    char emptyBuffer[1] = { 'x' };
+    const auto emptyLength = records.empty() ? 1 : Trace::format(records.front(), emptyBuffer, sizeof(emptyBuffer));
+    
+    report.addCheck("long events are truncated to the buffer [Trace]",
+                    line.size() >= TruncatedCapacity && isTruncated && emptyLength == 0 && emptyBuffer[0] == '\0',
+                    format("{} of {} characters fit into {} bytes, {} into 1 byte",
+                           length, line.size(), TruncatedCapacity, emptyLength));
+}
+
+void RunWrapAroundChecks(Report& report)
+{
+    // The current thread's buffer only keeps the latest events.
+    constexpr size_t OverflowCount = 10;
+    constexpr auto recordCount = Trace::BufferCapacity + OverflowCount;
+    Trace::clear();
+    for(uint64_t index = 0; index < recordCount; index++)
+    {
+        Trace::record(WrapDescriptor, index);
+    }
+    
+    const auto records = RecordsOf(WrapDescriptor);
+    bool isOrdered = true;
+    for(size_t index = 0; index < records.size(); index++)
+    {
+        isOrdered = isOrdered && records[index].arguments[0] == OverflowCount + index;
+    }
+    
+    report.addCheck("buffers keep the latest events in order [Trace]",
+                    records.size() == Trace::BufferCapacity && isOrdered,
+                    format("{} of {} events kept, {}, first event {}",
+                           records.size(), recordCount, isOrdered ? "in order" : "out of order",
+                           records.empty() ? 0 : records.front().arguments[0]));
+}
+
+void RunCompiledLevelChecks(Report& report)
+{
+    Trace::clear();
+    AWAKEN_TRACE(Debug, DebugFormat, 1u);
+    AWAKEN_TRACE(Error, ErrorFormat, 2u);
+    
+    size_t debugCount = 0;
+    size_t errorCount = 0;
+    for(const auto& record : Trace::records())
+    {
+        debugCount += strcmp(record.descriptor->format, DebugFormat) == 0 ? 1 : 0;
+        errorCount += strcmp(record.descriptor->format, ErrorFormat) == 0 ? 1 : 0;
+    }
+    
+    const size_t expectedDebugCount = TraceLevel::Debug >= CompiledTraceLevel ? 1 : 0;
+    const size_t expectedErrorCount = TraceLevel::Error >= CompiledTraceLevel ? 1 : 0;
+    report.addCheck("events below the compiled trace level record nothing [Trace]",
+                    debugCount == expectedDebugCount && errorCount == expectedErrorCount,
+                    format("{} debug and {} error events at trace level {}",
+                           debugCount, errorCount, AWAKEN_TRACE_LEVEL));
+}
+
+}
+
+void Awaken::Benchmarks::RunTraceBenchmarks(Report& report, const Options&)
+{
+    RunFormatChecks(report);
+    RunWrapAroundChecks(report);
+    RunCompiledLevelChecks(report);
+    Trace::clear();
+}
@@ -0,0 +1,499 @@
+//
+//  WaiterBenchmarks.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <optional>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <Awaken/FileDescriptorWaiter.hpp>
+#include <Awaken/Metrics.hpp>
+#include <Awaken/ProcessWaiter.hpp>
+#include <Awaken/ThreadWaiter.hpp>
+#include <Awaken/TimerWheelWaiter.hpp>
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+/// Cancelling must reach the timeout handler within this latency
+constexpr chrono::milliseconds CancelLatencyLimit { 1 };
+
+/// How long an indefinite hold idles before it is cancelled, longer
+/// than the one-second polling interval waiters used to wake up with
+constexpr chrono::milliseconds IdleHoldDuration { 1500 };
+
+/// A process exit or a closed descriptor must
+/// reach the timeout handler within this latency
+constexpr chrono::milliseconds ExitLatencyLimit { 5 };
+
+/// The number of child processes spawned to measure the exit latency
+constexpr size_t ExitSampleCount = 100;
+
+/// The number of bytes sent through a pass-through waiter
+constexpr size_t PassThroughByteCount = 4 * 1024 * 1024;
+
+/// How long a slow timeout handler blocks its executor thread
+constexpr chrono::milliseconds SlowHandlerDuration { 100 };
+
+/// The number of runs of one waiter that must share its thread
+constexpr size_t RepeatedRunCount = 100;
+
+/// Calls work items immediately and counts them
+class CountingExecutor : public Executor
+{
+public:
+    void execute(function<void()>&& work) noexcept override
+    {
+        this->_count.fetch_add(1, memory_order_release);
+        work();
+    }
+
+    size_t count() const noexcept { return this->_count.load(memory_order_acquire); }
+
+private:
+    atomic<size_t> _count { 0 };
+};
+
+template<typename WaiterClass>
+void RunCancelBenchmark(const string& waiterName, Report& report, const Options& options)
+{
+    WaiterClass waiter;
+    atomic<bool> didFire { false };
+    atomic<Clock::rep> firedAt { 0 };
+    
+    waiter.setTimeout(60s);
+    waiter.setTimeoutHandler([&] {
+        firedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        didFire.store(true, memory_order_release);
+    });
+    
+    vector<chrono::nanoseconds> samples;
+    samples.reserve(options.iterations);
+    size_t missedCount = 0;
+    
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        didFire.store(false, memory_order_relaxed);
+        waiter.run();
+        
+        const auto start = Clock::now();
+        waiter.cancel();
+        if(!SpinUntil(didFire))
+        {
+            missedCount++;
+            continue;
+        }
+        samples.push_back(Clock::duration { firedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+    }
+    
+    const auto median = Percentile(samples, 0.5);
+    const auto tail = Percentile(samples, 0.99);
+    report.addCheck(format("cancel reaches the handler [{}]", waiterName),
+                    missedCount == 0,
+                    format("{} of {} cancellations did not call the handler", missedCount, options.iterations));
+    report.addCheck(format("cancel-to-handler p50 below {} ms [{}]", CancelLatencyLimit.count(), waiterName),
+                    median < CancelLatencyLimit,
+                    format("p50 {} ns", median.count()));
+    report.addCheck(format("cancel-to-handler p99 below {} ms [{}]", CancelLatencyLimit.count(), waiterName),
+                    tail < CancelLatencyLimit,
+                    format("p99 {} ns", tail.count()));
+    report.addLatencies(format("cancel-to-handler [{}]", waiterName), std::move(samples));
+}
+
+void RunIdleHoldBenchmark(Report& report)
+{
+    ThreadWaiter waiter;
+    atomic<bool> didFire { false };
+    waiter.setTimeout(0s);
+    waiter.setTimeoutHandler([&didFire] { didFire.store(true, memory_order_release); });
+    
+    // The waiting thread only wakes up once, when the hold is cancelled.
+    const auto wakeups = Metrics::shared().threadWaiterWakeups.value();
+    waiter.run();
+    this_thread::sleep_for(IdleHoldDuration);
+    const auto idleWakeups = Metrics::shared().threadWaiterWakeups.value() - wakeups;
+    
+    waiter.cancel();
+    const bool didCancel = SpinUntil(didFire);
+    const auto cancelWakeups = Metrics::shared().threadWaiterWakeups.value() - wakeups - idleWakeups;
+    report.addCheck("an indefinite hold does not wake up while idle [ThreadWaiter]",
+                    idleWakeups == 0 && didCancel && cancelWakeups == 1,
+                    format("{} wakeups in {} ms idle, {} on cancel", idleWakeups, IdleHoldDuration.count(), cancelWakeups));
+}
+
+template<typename WaiterClass>
+void RunRepeatedRunBenchmark(const string& waiterName, WaiterClass& waiter, const CountingExecutor& executor, Report& report)
+{
+    atomic<size_t> handlerCount { 0 };
+    waiter.setTimeoutHandler([&handlerCount] { handlerCount.fetch_add(1, memory_order_release); });
+    
+    // The first run starts the waiting thread, which all following runs reuse.
+    optional<size_t> threadCount = nullopt;
+    size_t missedCount = 0;
+    for(size_t run = 1; run <= RepeatedRunCount; run++)
+    {
+        waiter.run();
+        if(run == 1) { threadCount = ThreadCount(); }
+        waiter.cancel();
+        
+        const auto deadline = Clock::now() + 5s;
+        while(handlerCount.load(memory_order_acquire) < run && Clock::now() < deadline)
+        {
+            this_thread::yield();
+        }
+        missedCount += handlerCount.load(memory_order_acquire) < run ? 1 : 0;
+    }
+    const auto finalThreadCount = ThreadCount();
+    
+    report.addCheck(format("runs reuse one thread and call the handler through the executor [{}]", waiterName),
+                    threadCount == finalThreadCount && missedCount == 0 && executor.count() == RepeatedRunCount,
+                    format("{} threads after the first run, {} after {} runs, {} handlers missed, {} called by the executor",
+                           threadCount.value_or(0), finalThreadCount.value_or(0), RepeatedRunCount, missedCount, executor.count()));
+}
+
+void RunRepeatedRunBenchmarks(Report& report)
+{
+    {
+        // The benchmark process never exits while it is watched.
+        CountingExecutor executor;
+        ProcessWaiter waiter { { getpid() }, executor };
+        RunRepeatedRunBenchmark("ProcessWaiter", waiter, executor, report);
+    }
+    
+    int fds[2];
+    if(pipe(fds) != 0) { return; }
+    {
+        CountingExecutor executor;
+        FileDescriptorWaiter waiter { fds[0], FileDescriptorWaiter::Input::Keep, executor };
+        RunRepeatedRunBenchmark("FileDescriptorWaiter", waiter, executor, report);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+
+void RunSlowHandlerBenchmark(Report& report, const Options& options)
+{
+    WorkerPoolExecutor executor;
+    TimerWheelWaiter slowWaiter { TimerWheel::shared(), executor };
+    TimerWheelWaiter waiter { TimerWheel::shared(), executor };
+    atomic<bool> isSlowHandlerRunning { false };
+    atomic<bool> didFire { false };
+    atomic<Clock::rep> firedAt { 0 };
+    
+    slowWaiter.setTimeout(60s);
+    waiter.setTimeout(60s);
+    slowWaiter.setTimeoutHandler([&] {
+        isSlowHandlerRunning.store(true, memory_order_release);
+        this_thread::sleep_for(SlowHandlerDuration);
+        isSlowHandlerRunning.store(false, memory_order_release);
+    });
+    waiter.setTimeoutHandler([&] {
+        firedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        didFire.store(true, memory_order_release);
+    });
+    
+    // Each round blocks one executor thread with the slow handler,
+    // the other waiter's handler must not queue up behind it.
+    vector<chrono::nanoseconds> samples;
+    size_t delayedCount = 0;
+    const auto rounds = min<size_t>(options.iterations, 10);
+    for(size_t round = 0; round < rounds; round++)
+    {
+        didFire.store(false, memory_order_relaxed);
+        slowWaiter.run();
+        waiter.run();
+        
+        slowWaiter.cancel();
+        SpinUntil(isSlowHandlerRunning);
+        
+        const auto start = Clock::now();
+        waiter.cancel();
+        if(!SpinUntil(didFire) || isSlowHandlerRunning.load(memory_order_acquire) == false)
+        {
+            delayedCount++;
+        }
+        samples.push_back(Clock::duration { firedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+        
+        while(isSlowHandlerRunning.load(memory_order_acquire))
+        {
+            this_thread::yield();
+        }
+    }
+    
+    const auto queueLatency = executor.metrics().queueLatency.snapshot().percentile(0.99);
+    report.addCheck("a slow handler does not delay other waiters [TimerWheelWaiter]",
+                    delayedCount == 0,
+                    format("{} of {} handlers waited for a {} ms handler, p99 queue latency {} ns",
+                           delayedCount, rounds, SlowHandlerDuration.count(), queueLatency.count()));
+    report.addLatencies("cancel-to-handler [TimerWheelWaiter, slow neighbour]", std::move(samples));
+}
+
+
+/// A child process that exits once its pipe is closed
+struct ChildProcess
+{
+    pid_t pid = -1;
+    int pipeFD = -1;
+    
+    static ChildProcess spawn()
+    {
+        int fds[2];
+        if(pipe(fds) != 0) { return {}; }
+        
+        const auto pid = fork();
+        if(pid == 0)
+        {
+            close(fds[1]);
+            char byte;
+            [[maybe_unused]] const auto result = read(fds[0], &byte, 1);
+            _exit(0);
+        }
+        close(fds[0]);
+        return { pid, fds[1] };
+    }
+    
+    void exit() const
+    {
+        close(this->pipeFD);
+    }
+    
+    void reap() const
+    {
+        waitpid(this->pid, nullptr, 0);
+    }
+};
+
+void RunProcessExitBenchmark(Report& report)
+{
+    ProcessWaiter waiter;
+    atomic<bool> didFire { false };
+    atomic<Clock::rep> firedAt { 0 };
+    waiter.setTimeoutHandler([&] {
+        firedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        didFire.store(true, memory_order_release);
+    });
+    
+    vector<chrono::nanoseconds> samples;
+    samples.reserve(ExitSampleCount);
+    size_t missedCount = 0;
+    for(size_t iteration = 0; iteration < ExitSampleCount; iteration++)
+    {
+        const auto child = ChildProcess::spawn();
+        didFire.store(false, memory_order_relaxed);
+        waiter.setProcesses({ child.pid });
+        waiter.run();
+        
+        const auto start = Clock::now();
+        child.exit();
+        if(!SpinUntil(didFire))
+        {
+            missedCount++;
+        }
+        samples.push_back(Clock::duration { firedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+        child.reap();
+    }
+    
+    const auto median = Percentile(samples, 0.5);
+    report.addCheck("process exit reaches the handler [ProcessWaiter]",
+                    missedCount == 0,
+                    format("{} of {} exits did not call the handler", missedCount, ExitSampleCount));
+    report.addCheck(format("exit-to-handler p50 below {} ms [ProcessWaiter]", ExitLatencyLimit.count()),
+                    median < ExitLatencyLimit,
+                    format("p50 {} ns", median.count()));
+    report.addLatencies("exit-to-handler [ProcessWaiter]", std::move(samples));
+    
+    // Waits until every process exited
+    const array children { ChildProcess::spawn(), ChildProcess::spawn(), ChildProcess::spawn() };
+    didFire.store(false, memory_order_relaxed);
+    waiter.setProcesses({ children[0].pid, children[1].pid, children[2].pid });
+    waiter.run();
+    children[0].exit();
+    children[1].exit();
+    const bool didFireEarly = SpinUntil(didFire, 20ms);
+    children[2].exit();
+    const bool didFireLast = SpinUntil(didFire);
+    for(const auto& child : children)
+    {
+        child.reap();
+    }
+    report.addCheck("waits for all processes to exit [ProcessWaiter]",
+                    !didFireEarly && didFireLast,
+                    format("handler called {}", didFireEarly ? "before the last exit" : didFireLast ? "after the last exit" : "never"));
+    
+    // Duplicates are watched once, kqueue only reports one exit for them
+    const array duplicates { ChildProcess::spawn(), ChildProcess::spawn() };
+    didFire.store(false, memory_order_relaxed);
+    waiter.setProcesses({ duplicates[1].pid, duplicates[0].pid, duplicates[1].pid });
+    const auto processes = waiter.processes();
+    const auto constructedProcesses = ProcessWaiter { { duplicates[0].pid, duplicates[0].pid } }.processes();
+    waiter.run();
+    for(const auto& child : duplicates)
+    {
+        child.exit();
+    }
+    const bool didFireDuplicates = SpinUntil(didFire);
+    for(const auto& child : duplicates)
+    {
+        child.reap();
+    }
+    report.addCheck("duplicate processes are waited for once [ProcessWaiter]",
+                    didFireDuplicates && processes.size() == 2 && is_sorted(processes.begin(), processes.end())
+                        && constructedProcesses.size() == 1,
+                    format("{} of 3 processes kept, {} of 2 by the constructor, handler {}",
+                           processes.size(), constructedProcesses.size(), didFireDuplicates ? "called" : "never called"));
+    
+    // A process that is already gone ends the wait right away
+    const auto exited = ChildProcess::spawn();
+    exited.exit();
+    exited.reap();
+    didFire.store(false, memory_order_relaxed);
+    waiter.setProcesses({ exited.pid });
+    const bool didRun = waiter.run();
+    report.addCheck("an exited process ends the wait [ProcessWaiter]",
+                    didRun && SpinUntil(didFire),
+                    format("pid {}", exited.pid));
+}
+
+
+void RunDescriptorBenchmark(Report& report, const Options& options)
+{
+    atomic<bool> didFire { false };
+    atomic<Clock::rep> firedAt { 0 };
+    const auto timeoutHandler = [&] {
+        firedAt.store(Clock::now().time_since_epoch().count(), memory_order_relaxed);
+        didFire.store(true, memory_order_release);
+    };
+    
+    vector<chrono::nanoseconds> samples;
+    samples.reserve(options.iterations);
+    size_t missedCount = 0;
+    size_t earlyCount = 0;
+    for(size_t iteration = 0; iteration < options.iterations; iteration++)
+    {
+        int fds[2];
+        if(pipe(fds) != 0) { break; }
+        
+        FileDescriptorWaiter waiter { fds[0] };
+        waiter.setTimeoutHandler(timeoutHandler);
+        didFire.store(false, memory_order_relaxed);
+        waiter.run();
+        
+        // Data keeps the waiter running, only the end finishes it.
+        [[maybe_unused]] const auto written = write(fds[1], "data", 4);
+        if(iteration == 0 && SpinUntil(didFire, 20ms))
+        {
+            earlyCount++;
+        }
+        
+        const auto start = Clock::now();
+        close(fds[1]);
+        if(!SpinUntil(didFire))
+        {
+            missedCount++;
+        }
+        samples.push_back(Clock::duration { firedAt.load(memory_order_relaxed) } - start.time_since_epoch());
+        close(fds[0]);
+    }
+    
+    const auto median = Percentile(samples, 0.5);
+    report.addCheck("end-of-file reaches the handler [FileDescriptorWaiter]",
+                    missedCount == 0 && earlyCount == 0,
+                    format("{} of {} closes did not call the handler, data did {}", missedCount, options.iterations, earlyCount == 0 ? "not" : "too"));
+    report.addCheck(format("close-to-handler p50 below {} ms [FileDescriptorWaiter]", ExitLatencyLimit.count()),
+                    median < ExitLatencyLimit,
+                    format("p50 {} ns", median.count()));
+    report.addLatencies("close-to-handler [FileDescriptorWaiter]", std::move(samples));
+    
+    // Only a consuming waiter reads the data written before the end
+    const auto unreadBytes = [&](FileDescriptorWaiter::Input input) -> optional<ssize_t> {
+        int fds[2];
+        if(pipe(fds) != 0) { return nullopt; }
+        
+        FileDescriptorWaiter waiter { fds[0], input };
+        waiter.setTimeoutHandler(timeoutHandler);
+        didFire.store(false, memory_order_relaxed);
+        waiter.run();
+        [[maybe_unused]] const auto written = write(fds[1], "data", 4);
+        close(fds[1]);
+        
+        optional<ssize_t> count = nullopt;
+        if(SpinUntil(didFire))
+        {
+            char buffer[8];
+            count = read(fds[0], buffer, sizeof(buffer));
+        }
+        close(fds[0]);
+        return count;
+    };
+    const auto keptBytes = unreadBytes(FileDescriptorWaiter::Input::Keep);
+    const auto consumedBytes = unreadBytes(FileDescriptorWaiter::Input::Consume);
+    report.addCheck("only a consuming waiter reads the descriptor [FileDescriptorWaiter]",
+                    keptBytes == 4 && consumedBytes == 0,
+                    format("{} of 4 bytes left unread when kept, {} when consumed",
+                           keptBytes.value_or(-1), consumedBytes.value_or(-1)));
+    
+    // Everything written upstream arrives downstream
+    int input[2], output[2];
+    if(pipe(input) != 0 || pipe(output) != 0) { return; }
+    
+    FileDescriptorWaiter waiter { input[0], output[1] };
+    didFire.store(false, memory_order_relaxed);
+    waiter.setTimeoutHandler(timeoutHandler);
+    waiter.run();
+    
+    thread producer { [fd = input[1]] {
+        const vector<char> chunk(64 * 1024, 'a');
+        for(size_t offset = 0; offset < PassThroughByteCount; offset += chunk.size())
+        {
+            [[maybe_unused]] const auto written = write(fd, chunk.data(), chunk.size());
+        }
+        close(fd);
+    } };
+    
+    const auto start = Clock::now();
+    size_t receivedCount = 0;
+    vector<char> buffer(64 * 1024);
+    while(receivedCount < PassThroughByteCount)
+    {
+        const auto count = read(output[0], buffer.data(), buffer.size());
+        if(count <= 0) { break; }
+        receivedCount += static_cast<size_t>(count);
+    }
+    const auto elapsed = Clock::now() - start;
+    producer.join();
+    const bool didFinish = SpinUntil(didFire);
+    close(input[0]);
+    close(output[0]);
+    close(output[1]);
+    
+    report.addCounter("pass-through throughput [FileDescriptorWaiter]",
+                      static_cast<double>(receivedCount) / (1024 * 1024) / chrono::duration<double>(elapsed).count(), "MiB/s");
+    report.addCheck("pass-through forwards all data until the end [FileDescriptorWaiter]",
+                    didFinish && receivedCount == PassThroughByteCount && waiter.transferredBytes() == PassThroughByteCount,
+                    format("{} of {} bytes received, {} transferred", receivedCount, PassThroughByteCount, waiter.transferredBytes()));
+}
+
+}
+
+void Awaken::Benchmarks::RunWaiterBenchmarks(Report& report, const Options& options)
+{
+    RunCancelBenchmark<ThreadWaiter>("ThreadWaiter", report, options);
+    RunCancelBenchmark<TimerWheelWaiter>("TimerWheelWaiter", report, options);
+    RunIdleHoldBenchmark(report);
+    RunSlowHandlerBenchmark(report, options);
+    RunProcessExitBenchmark(report);
+    RunDescriptorBenchmark(report, options);
+    RunRepeatedRunBenchmarks(report);
+}
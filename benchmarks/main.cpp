@@ -0,0 +1,106 @@
+//
+//  main.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include "Benchmark.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+using namespace std;
+using namespace Awaken::Benchmarks;
+
+namespace
+{
+
+struct Benchmark
+{
+    string_view name;
+    void (*run)(Report&, const Options&);
+};
+
+constexpr Benchmark AllBenchmarks[] = {
+    { "awaken", RunAwakenBenchmarks },
+    { "waiter", RunWaiterBenchmarks },
+    { "powersource", RunPowerSourceBenchmarks },
+    { "registry", RunRegistryBenchmarks },
+    { "stress", RunStressBenchmarks },
+    { "lease", RunLeaseBenchmarks },
+    { "heartbeat", RunHeartbeatBenchmarks },
+    { "simulation", RunSimulationBenchmarks },
+    { "metrics", RunMetricsBenchmarks },
+    { "trace", RunTraceBenchmarks },
+};
+
+void PrintUsage(const char* executable)
+{
+    fprintf(stderr,
+            "usage: %s [--iterations N] [--filter NAME] [--json PATH|-]\n"
+            "benchmarks: awaken, waiter, powersource, registry, stress, lease, heartbeat, simulation, metrics, trace\n",
+            executable);
+}
+
+Options ParseOptions(int argc, char** argv)
+{
+    Options options;
+    for(int index = 1; index < argc; index++)
+    {
+        const string_view argument = argv[index];
+        const bool hasValue = index + 1 < argc;
+        
+        if(argument == "--iterations" && hasValue)
+        {
+            options.iterations = max<size_t>(1, strtoull(argv[++index], nullptr, 10));
+        }
+        else if(argument == "--filter" && hasValue)
+        {
+            options.filter = argv[++index];
+        }
+        else if(argument == "--json" && hasValue)
+        {
+            options.jsonPath = argv[++index];
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            exit(argument == "--help" || argument == "-h" ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    const auto options = ParseOptions(argc, argv);
+    
+    Report report;
+    for(const auto& benchmark : AllBenchmarks)
+    {
+        if(benchmark.name.find(options.filter) == string_view::npos) { continue; }
+        benchmark.run(report, options);
+    }
+    
+    if(options.jsonPath == "-")
+    {
+        report.writeJSON(cout);
+    }
+    else
+    {
+        report.printText(stdout);
+        if(const auto& jsonPath = options.jsonPath)
+        {
+            ofstream file { *jsonPath };
+            report.writeJSON(file);
+        }
+    }
+    
+    return report.passed() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
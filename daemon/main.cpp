@@ -0,0 +1,89 @@
+//
+//  main.cpp
+//  awakend
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <stdlib.h>
+#include <print>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <Awaken/Awaken.hpp>
+#include <Awaken/LeaseServer.hpp>
+#include <cxxopts.hpp>
+
+cxxopts::ParseResult ParseArguments(int argc, char* argv[])
+{
+    try
+    {
+        cxxopts::Options options { argv[0], "awakend - serves sleep assertion leases to local clients." };
+        
+        options.add_options()
+        ("socket", "the path of the Unix domain socket clients connect to", cxxopts::value<std::string>()->default_value(Awaken::LeaseProtocol::DefaultSocketPath()), "PATH")
+        ;
+        
+        options.add_options("Help")
+        ("h,help", "print this help")
+        ("v,version", "print version information")
+        ;
+        
+        const auto result = options.parse(argc, argv);
+        
+        if(result.count("version"))
+        {
+            std::println("awakend {}", Awaken::Awaken::version());
+            exit(EXIT_SUCCESS);
+        }
+        
+        if(result.count("help"))
+        {
+            std::println("{}", options.help());
+            exit(EXIT_SUCCESS);
+        }
+        
+        return result;
+    }
+    catch (const cxxopts::exceptions::exception& e)
+    {
+        std::println("Failed parsing options: {}", e.what());
+        exit(EXIT_FAILURE);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const auto result = ParseArguments(argc, argv);
+    const auto socketPath = result["socket"].as<std::string>();
+    
+    // Termination signals are taken by a dedicated thread,
+    // the server stops and releases all leases before exiting.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+    
+    Awaken::LeaseServer server { socketPath };
+    if(!server.listen())
+    {
+        std::println(stderr, "Failed listening on '{}'.", socketPath);
+        return EXIT_FAILURE;
+    }
+    
+    std::thread signalThread { [&server, signals] {
+        int received = 0;
+        sigwait(&signals, &received);
+        server.stop();
+    } };
+    signalThread.detach();
+    
+    std::println("Serving leases on '{}'.", socketPath);
+    server.run();
+    
+    return EXIT_SUCCESS;
+}
@@ -11,18 +11,29 @@
 
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <functional>
+#include <Awaken/Executor.hpp>
+#include <Awaken/HandlerList.hpp>
+#include <Awaken/HoldAwaiter.hpp>
 
 namespace Awaken
 {
+class AnyWaiter;
 class IOPowerAssertion;
 class IOPowerSource;
+class PowerAssertionBackend;
 class Waiter;
+struct SessionMetrics;
+template<typename AssertionPolicy, typename PowerSourcePolicy, typename WaiterPolicy> class BasicAwaken;
 
 /// Represents an infinite timeout duration
 constexpr std::chrono::seconds InfiniteTimeout { 0 };
 
+/// Keeps the system awake with components chosen at runtime, see
+/// `BasicAwaken` to choose them at compile time and store them inline.
+/// The session is kept on the heap, so instances can be moved.
 class Awaken
 {
 public:
@@ -32,6 +43,19 @@ public:
     /// The designated initializer
     /// @param name The current tool's name used in system logs
     Awaken(std::string name) noexcept;
+    /// Creates an instance that waits for its timeout using a custom waiter,
+    /// e.g. a `TimerWheelWaiter` to share one thread between many instances.
+    /// @param name The current tool's name used in system logs
+    /// @param waiter The waiter used for timeouts
+    Awaken(std::string name, std::unique_ptr<Waiter> waiter) noexcept;
+    /// Creates an instance with a custom power assertion backend,
+    /// e.g. an `InMemoryPowerAssertionBackend` for benchmarks.
+    /// @param name The current tool's name used in system logs
+    /// @param backend The backend that creates the actual power assertions
+    /// @param waiter The waiter used for timeouts
+    Awaken(std::string name,
+           std::shared_ptr<PowerAssertionBackend> backend,
+           std::unique_ptr<Waiter> waiter) noexcept;
     Awaken() noexcept;
     ~Awaken() noexcept;
     
@@ -69,6 +93,15 @@ public:
     /// Prevents the display from dimming automatically if true.
     bool preventUserIdleDisplaySleep() const noexcept;
     
+    /// Keeps the power assertions held for a grace period after `cancel()`.
+    /// A `run()` within that period re-attaches to the held assertions
+    /// instead of creating new ones, which avoids create/release storms
+    /// when sessions are started and stopped in rapid bursts.
+    /// @param linger The grace period, 0 releases immediately (default)
+    void setReleaseLinger(std::chrono::milliseconds linger) noexcept;
+    /// The grace period power assertions are kept after `cancel()`.
+    std::chrono::milliseconds releaseLinger() const noexcept;
+    
     /// @}
     
 #pragma mark - Timeout
@@ -87,10 +120,35 @@ public:
     /// an indefinite timeout.
     std::chrono::seconds timeout() const noexcept;
     
-    /// Sets an optional timeout handler that will be called
-    /// on a private thread when the timeout is reached.
+    /// Sets an optional handler that will be called when a running
+    /// session ends, on a private thread when the timeout is reached
+    /// or on the thread that ended the session otherwise.
+    /// The power assertions are released before it is called.
+    /// It is called along with all handlers added with `subscribeToEnd()`.
     void setTimeoutHandler(std::function<void()>&&) noexcept;
     
+    /// Adds a handler that will be called with the reason
+    /// whenever a running session ends, like the timeout handler.
+    /// @returns the subscription to remove the handler with `unsubscribe()`
+    Subscription subscribeToEnd(std::function<void(HoldEndReason)>&&) noexcept;
+    
+    /// Moves the deadline of a running session. The waiter is re-armed
+    /// and the power assertions are extended in place, without releasing
+    /// and re-creating them.
+    /// @param deadline The new deadline in the time of the waiter's `timeSource()`,
+    ///                 may be earlier or later than the current one
+    /// @returns false if not running or the deadline could not be moved
+    bool setDeadline(std::chrono::steady_clock::time_point deadline) noexcept;
+    
+    /// Extends the deadline of a running session by the given duration.
+    /// Sessions with an indefinite timeout are left unchanged.
+    /// @returns false if not running or the deadline could not be moved
+    bool extendBy(std::chrono::seconds duration) noexcept;
+    
+    /// The deadline of the running session, or nullopt if
+    /// the session is not running or waits indefinitely.
+    std::optional<std::chrono::steady_clock::time_point> deadline() const noexcept;
+    
     /// @}
     
 #pragma mark - Minimum Battery Capacity
@@ -116,14 +174,43 @@ public:
     /// will be released. (e.g. 20.0f for 20 % capacity)
     float minimumBatteryCapacity() const noexcept;
     
+    /// Releases the sleep assertions early, once the battery is predicted
+    /// to reach the `minimumBatteryCapacity()` within the margin.
+    /// The prediction is based on the recent discharge rate, a margin
+    /// of zero, the default, only releases when the capacity is reached.
+    void setMinimumBatteryCapacityMargin(std::chrono::seconds margin) noexcept;
+    
+    /// Returns the margin of the early release before
+    /// the minimum battery capacity is reached
+    std::chrono::seconds minimumBatteryCapacityMargin() const noexcept;
+    
+    /// Returns the predicted time until the battery reaches the
+    /// `minimumBatteryCapacity()`, if the battery is discharging and
+    /// a handler for the minimum battery capacity is set.
+    std::optional<std::chrono::seconds> timeUntilMinimumBatteryCapacity() const noexcept;
+    
     /// An optional handler that will be called when the battery
-    /// capacity reaches the `minimumBatteryCapacity()`.
+    /// capacity reaches the `minimumBatteryCapacity()` while running.
     /// Any sleep assertions will be cancelled when the minimum
     /// battery capacity is reached.
     void setMinimumBatteryCapacityReachedHandler(std::function<void(float)>&&) noexcept;
     
+    /// Adds a handler that will be called when the battery capacity
+    /// reaches the `minimumBatteryCapacity()` while running, like the
+    /// handler set with `setMinimumBatteryCapacityReachedHandler()`.
+    /// @returns the subscription to remove the handler with `unsubscribe()`
+    ///          or an empty subscription if the device has no battery
+    Subscription subscribeToMinimumBatteryCapacityReached(std::function<void(float)>&&) noexcept;
+    
     /// @}
     
+#pragma mark - Subscriptions
+    
+    /// Removes a handler added with one of the `subscribeTo…()` methods.
+    /// Handlers may be removed from any thread, also from within a handler.
+    /// @returns false if the subscription is unknown
+    bool unsubscribe(Subscription) noexcept;
+    
 #pragma mark - Running
     
     /// @name Running
@@ -135,19 +222,42 @@ public:
     
     /// Runs all configured sleep assertions and
     /// keeps the current process awake.
-    /// @returns false if the sleep assertions cannot be created.
+    /// @note `run()` and `cancel()` may be called concurrently from
+    ///       any thread, including from within the handlers.
+    /// @returns false if already running or the sleep
+    ///          assertions cannot be created.
     bool run() noexcept;
     
-    /// Cancels any sleep assertions.
+    /// Cancels any sleep assertions. The session has ended
+    /// when it returns, unless another thread is ending it.
     void cancel() noexcept;
     
+    /// Returns an awaitable that runs all configured sleep assertions
+    /// for the timeout and completes with the reason the hold ended,
+    /// e.g. `auto reason = co_await awaken.holdFor(30min);`
+    /// @param timeout The hold duration, `InfiniteTimeout` holds until cancelled,
+    ///                the timeout set with `setTimeout()` is kept for `run()`
+    /// @param executor Resumes the awaiting coroutine, by default on
+    ///                 the thread that ended the hold
+    /// @note The instance must outlive the awaiting coroutine.
+    HoldAwaiter holdFor(std::chrono::seconds timeout,
+                        Executor& executor = InlineExecutor::shared()) noexcept;
+    
     /// @}
     
+#pragma mark - Metrics
+    
+    /// Returns the metrics of all sessions run by this instance,
+    /// see `Metrics::shared()` for the metrics of the whole process.
+    const SessionMetrics& metrics() const noexcept;
+    
 private:
-    std::unique_ptr<IOPowerAssertion> _powerAssertion;
-    std::unique_ptr<IOPowerSource> _powerSource;
-    std::unique_ptr<Waiter> _waiter;
-    float _minimumBatteryCapacity;
+    friend class HoldAwaiter;
+    using Session = BasicAwaken<IOPowerAssertion, IOPowerSource, AnyWaiter>;
+    
+    std::unique_ptr<Session> _session;
+    
+    bool beginHold(HoldAwaiter&) noexcept;
 };
 
 }
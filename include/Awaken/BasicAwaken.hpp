@@ -0,0 +1,679 @@
+//
+//  BasicAwaken.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef BasicAwaken_hpp
+#define BasicAwaken_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <Awaken/Executor.hpp>
+#include <Awaken/HandlerList.hpp>
+#include <Awaken/HoldAwaiter.hpp>
+#include <Awaken/Metrics.hpp>
+#include <Awaken/Trace.hpp>
+#include <Awaken/Waiter.hpp>
+
+namespace Awaken
+{
+class Awaken;
+
+/// A power source policy for devices without a battery,
+/// it compiles out the minimum battery capacity.
+struct NoPowerSource
+{
+    bool hasBattery() const noexcept { return false; }
+};
+
+/// A waiter policy that forwards to a waiter chosen at runtime
+class AnyWaiter
+{
+public:
+    explicit AnyWaiter(std::unique_ptr<Waiter> waiter) noexcept : _waiter(std::move(waiter)) {}
+
+    void setTimeout(std::chrono::seconds timeout) noexcept { this->_waiter->setTimeout(timeout); }
+    void setTimeoutHandler(std::function<void()>&& handler) noexcept { this->_waiter->setTimeoutHandler(std::move(handler)); }
+    TimeSource& timeSource() const noexcept { return this->_waiter->timeSource(); }
+
+    bool isRunning() const noexcept { return this->_waiter->isRunning(); }
+    bool run() noexcept { return this->_waiter->run(); }
+    bool cancel() noexcept { return this->_waiter->cancel(); }
+    bool setDeadline(std::chrono::steady_clock::time_point deadline) noexcept { return this->_waiter->setDeadline(deadline); }
+
+private:
+    std::unique_ptr<Waiter> _waiter;
+};
+
+/// Keeps the system awake like `Awaken`, with its components chosen
+/// at compile time and stored inline, e.g.
+/// `BasicAwaken<IOPowerAssertion, NoPowerSource, TimerWheelWaiter>`.
+///
+/// The assertion policy has the interface of `IOPowerAssertion`, the
+/// power source policy the one of `IOPowerSource` or is `NoPowerSource`
+/// and the waiter policy the one of `Waiter`. Waiters are called without
+/// virtual dispatch and running or cancelling a session allocates
+/// nothing beyond what its components allocate. `Awaken` wraps a
+/// `BasicAwaken` with components chosen at runtime.
+///
+/// A session moves through Idle → Arming → Held → Releasing → Idle.
+/// Every transition is a compare-and-swap of a single word that also
+/// carries the end reason, so concurrent `run()` and `cancel()` calls
+/// are linearized without a lock. Exactly one thread wins the switch
+/// to Releasing and releases the session, or leaves that to the
+/// arming thread if the session is not held yet.
+template<typename AssertionPolicy, typename PowerSourcePolicy, typename WaiterPolicy>
+class BasicAwaken
+{
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    /// False for `NoPowerSource`, which compiles out the
+    /// minimum battery capacity and its capacity observer
+    constexpr static bool MonitorsBatteryCapacity = !std::is_same_v<PowerSourcePolicy, NoPowerSource>;
+
+#pragma mark - Life Cycle
+
+    /// Creates an instance with default constructed components
+    /// @param name The current tool's name used in system logs
+    explicit BasicAwaken(std::string name = "Awaken") noexcept
+        : BasicAwaken(std::move(name), std::piecewise_construct, std::tuple {}, std::tuple {}, std::tuple {})
+    {
+    }
+
+    /// Creates an instance constructing each component from a tuple
+    /// of arguments, e.g. `std::forward_as_tuple(backend)` to create
+    /// the power assertions with a custom backend.
+    /// @param name The current tool's name used in system logs
+    template<typename... AssertionArguments, typename... PowerSourceArguments, typename... WaiterArguments>
+    BasicAwaken(std::string name,
+                std::piecewise_construct_t,
+                std::tuple<AssertionArguments...> assertionArguments,
+                std::tuple<PowerSourceArguments...> powerSourceArguments,
+                std::tuple<WaiterArguments...> waiterArguments) noexcept
+        : _powerAssertion(std::make_from_tuple<AssertionPolicy>(std::move(assertionArguments)))
+        , _powerSource(std::make_from_tuple<PowerSourcePolicy>(std::move(powerSourceArguments)))
+        , _waiter(std::make_from_tuple<WaiterPolicy>(std::move(waiterArguments)))
+    {
+        this->_powerAssertion.name = std::move(name);
+        this->_waiter.WaiterPolicy::setTimeoutHandler([this]{
+            this->waiterDidFinish();
+        });
+    }
+
+    ~BasicAwaken() noexcept
+    {
+        this->end(HoldEndReason::Cancelled);
+    }
+
+    BasicAwaken(const BasicAwaken&) = delete;
+    BasicAwaken& operator=(const BasicAwaken&) = delete;
+
+    BasicAwaken(BasicAwaken&&) = delete;
+    BasicAwaken& operator=(BasicAwaken&&) = delete;
+
+#pragma mark - Properties
+
+    /// Returns the tool name used in system logs
+    const std::string& name() const noexcept { return this->_powerAssertion.name; }
+
+    /// See `Awaken::setPreventUserIdleSystemSleep()`
+    bool setPreventUserIdleSystemSleep(bool value) noexcept
+    {
+        if(this->isRunning())
+        {
+            AWAKEN_TRACE(Info, "The idle system sleep value cannot be modified while running.");
+            return false;
+        }
+
+        this->_powerAssertion.preventUserIdleSystemSleep = value;
+        return true;
+    }
+
+    bool preventUserIdleSystemSleep() const noexcept { return this->_powerAssertion.preventUserIdleSystemSleep; }
+
+    /// See `Awaken::setPreventUserIdleDisplaySleep()`
+    bool setPreventUserIdleDisplaySleep(bool value) noexcept
+    {
+        if(this->isRunning())
+        {
+            AWAKEN_TRACE(Info, "The idle display sleep value cannot be modified while running.");
+            return false;
+        }
+
+        this->_powerAssertion.preventUserIdleDisplaySleep = value;
+        return true;
+    }
+
+    bool preventUserIdleDisplaySleep() const noexcept { return this->_powerAssertion.preventUserIdleDisplaySleep; }
+
+    /// See `Awaken::setReleaseLinger()`
+    void setReleaseLinger(std::chrono::milliseconds linger) noexcept { this->_powerAssertion.releaseLinger = linger; }
+
+    std::chrono::milliseconds releaseLinger() const noexcept { return this->_powerAssertion.releaseLinger; }
+
+#pragma mark - Timeout
+
+    /// See `Awaken::setTimeout()`
+    bool setTimeout(std::chrono::seconds timeout) noexcept
+    {
+        if(this->isRunning())
+        {
+            AWAKEN_TRACE(Info, "The timeout cannot be modified while running.");
+            return false;
+        }
+
+        this->_timeout = timeout;
+        return true;
+    }
+
+    std::chrono::seconds timeout() const noexcept { return this->_timeout; }
+
+    /// See `Awaken::setTimeoutHandler()`
+    void setTimeoutHandler(std::function<void()>&& timeoutHandler) noexcept
+    {
+        auto handler = HandlerList<HoldEndReason>::Handler {};
+        if(timeoutHandler != nullptr)
+        {
+            handler = [timeoutHandler = std::move(timeoutHandler)](HoldEndReason) {
+                timeoutHandler();
+            };
+        }
+        this->_endHandlers.replace(this->_timeoutHandlerSubscription, std::move(handler));
+    }
+
+    /// See `Awaken::subscribeToEnd()`
+    Subscription subscribeToEnd(std::function<void(HoldEndReason)>&& handler) noexcept
+    {
+        return this->_endHandlers.subscribe(std::move(handler));
+    }
+
+    /// See `Awaken::setDeadline()`
+    bool setDeadline(TimePoint deadline) noexcept
+    {
+        if(!this->isRunning())
+        {
+            AWAKEN_TRACE(Info, "The deadline can only be moved while running.");
+            return false;
+        }
+
+        if(!this->_waiter.WaiterPolicy::setDeadline(deadline))
+        {
+            AWAKEN_TRACE(Error, "Failed to move the waiter deadline.");
+            return false;
+        }
+        this->storeDeadline(deadline);
+
+        // The deadline is in the time of the waiter, the backend
+        // assertion is extended by the time remaining until then.
+        if(!this->_powerAssertion.extend(deadline - this->now()))
+        {
+            AWAKEN_TRACE(Error, "Failed to extend power assertion.");
+            return false;
+        }
+        return true;
+    }
+
+    /// See `Awaken::extendBy()`
+    bool extendBy(std::chrono::seconds duration) noexcept
+    {
+        if(!this->isRunning())
+        {
+            AWAKEN_TRACE(Info, "The deadline can only be extended while running.");
+            return false;
+        }
+
+        if(const auto deadline = this->loadDeadline())
+        {
+            return this->setDeadline(*deadline + duration);
+        }
+        return true;
+    }
+
+    /// See `Awaken::deadline()`
+    std::optional<TimePoint> deadline() const noexcept
+    {
+        if(!this->isRunning()) { return std::nullopt; }
+        return this->loadDeadline();
+    }
+
+#pragma mark - Minimum Battery Capacity
+
+    bool hasBattery() const noexcept { return this->_powerSource.hasBattery(); }
+
+    /// See `Awaken::setMinimumBatteryCapacity()`
+    void setMinimumBatteryCapacity(float capacity) noexcept requires MonitorsBatteryCapacity
+    {
+        AWAKEN_TRACE(Info, "Setting minimum battery capacity to %{public}.00f…", capacity);
+        this->_battery.minimumCapacity = capacity;
+    }
+
+    float minimumBatteryCapacity() const noexcept requires MonitorsBatteryCapacity
+    {
+        return this->_battery.minimumCapacity;
+    }
+
+    /// See `Awaken::setMinimumBatteryCapacityMargin()`
+    void setMinimumBatteryCapacityMargin(std::chrono::seconds margin) noexcept requires MonitorsBatteryCapacity
+    {
+        this->_battery.margin.store(margin.count(), std::memory_order_relaxed);
+    }
+
+    std::chrono::seconds minimumBatteryCapacityMargin() const noexcept requires MonitorsBatteryCapacity
+    {
+        return std::chrono::seconds(this->_battery.margin.load(std::memory_order_relaxed));
+    }
+
+    /// See `Awaken::timeUntilMinimumBatteryCapacity()`
+    std::optional<std::chrono::seconds> timeUntilMinimumBatteryCapacity() const noexcept requires MonitorsBatteryCapacity
+    {
+        return this->_powerSource.timeUntilCapacity(this->_battery.minimumCapacity);
+    }
+
+    /// See `Awaken::setMinimumBatteryCapacityReachedHandler()`
+    void setMinimumBatteryCapacityReachedHandler(std::function<void(float)>&& handler) noexcept requires MonitorsBatteryCapacity
+    {
+        if(handler != nullptr && !this->_powerSource.hasBattery())
+        {
+            AWAKEN_TRACE(Info, "Current device does not support a minimum battery capacity.");
+            return;
+        }
+
+        auto& battery = this->_battery;
+        battery.thresholdHandlers.replace(battery.thresholdHandlerSubscription, std::move(handler));
+        this->updateCapacityObserver();
+    }
+
+    /// See `Awaken::subscribeToMinimumBatteryCapacityReached()`
+    Subscription subscribeToMinimumBatteryCapacityReached(std::function<void(float)>&& handler) noexcept requires MonitorsBatteryCapacity
+    {
+        if(!this->_powerSource.hasBattery())
+        {
+            AWAKEN_TRACE(Info, "Current device does not support a minimum battery capacity.");
+            return {};
+        }
+
+        const auto subscription = this->_battery.thresholdHandlers.subscribe(std::move(handler));
+        this->updateCapacityObserver();
+        return subscription;
+    }
+
+#pragma mark - Subscriptions
+
+    /// See `Awaken::unsubscribe()`
+    bool unsubscribe(Subscription subscription) noexcept
+    {
+        if(this->_endHandlers.unsubscribe(subscription)) { return true; }
+        if constexpr(MonitorsBatteryCapacity)
+        {
+            if(this->_battery.thresholdHandlers.unsubscribe(subscription))
+            {
+                this->updateCapacityObserver();
+                return true;
+            }
+        }
+        return false;
+    }
+
+#pragma mark - Running
+
+    bool isRunning() const noexcept
+    {
+        return this->_state.load(std::memory_order_acquire).phase != Phase::Idle;
+    }
+
+    /// See `Awaken::run()`
+    bool run() noexcept
+    {
+        return this->start(this->_timeout, nullptr) == Start::Started;
+    }
+
+    /// See `Awaken::cancel()`
+    void cancel() noexcept
+    {
+        this->end(HoldEndReason::Cancelled);
+    }
+
+#pragma mark - Metrics
+
+    /// Returns the metrics of all sessions run by this instance
+    const SessionMetrics& metrics() const noexcept { return this->_metrics; }
+
+private:
+    friend class Awaken;
+
+    enum class Phase : uint8_t { Idle, Arming, Held, Releasing };
+
+    /// The outcome of starting a session
+    enum class Start : uint8_t
+    {
+        Started,
+        /// Another session is running
+        Busy,
+        /// Nothing was acquired and the session is idle again
+        Failed,
+        /// The session failed and was released, its awaiter was resumed
+        Released,
+    };
+
+    struct State
+    {
+        Phase phase = Phase::Idle;
+        HoldEndReason reason = HoldEndReason::Failed;
+    };
+
+    constexpr static typename TimePoint::rep NoDeadline = std::numeric_limits<typename TimePoint::rep>::max();
+
+    struct BatteryMonitor
+    {
+        HandlerList<float> thresholdHandlers;
+        Subscription thresholdHandlerSubscription;
+        std::atomic<float> threshold = 0.0f;
+        float minimumCapacity = 0.0f;
+        /// Ends a session this many seconds before the threshold is predicted to be reached
+        std::atomic<std::chrono::seconds::rep> margin = 0;
+
+        /// Serializes observing the power source, it
+        /// is never taken while handlers are called
+        std::mutex observerMutex;
+        Subscription capacitySubscription;
+    };
+
+    struct NoBatteryMonitor {};
+
+    std::atomic<State> _state;
+    static_assert(std::atomic<State>::is_always_lock_free);
+
+    std::atomic<typename TimePoint::rep> _deadline { NoDeadline };
+    std::atomic<HoldAwaiter*> _awaiter = nullptr;
+    /// Set once the waiter of the arming session runs, so a handler
+    /// of the previous run is not taken for the end of this one
+    std::atomic<bool> _isWaiting = false;
+    /// The timeout of sessions started with `run()`
+    std::chrono::seconds _timeout { 0 };
+
+    /// Only accessed by the thread that owns the current phase
+    TimePoint _startedAt;
+
+    HandlerList<HoldEndReason> _endHandlers;
+    Subscription _timeoutHandlerSubscription;
+    [[no_unique_address]] std::conditional_t<MonitorsBatteryCapacity, BatteryMonitor, NoBatteryMonitor> _battery;
+
+    SessionMetrics _metrics;
+
+    // The components call back into the session state above,
+    // so they are declared last to be destroyed first.
+    AssertionPolicy _powerAssertion;
+    PowerSourcePolicy _powerSource;
+    /// Called with qualified names, so waiters deriving
+    /// from `Waiter` are not dispatched virtually
+    WaiterPolicy _waiter;
+
+    /// Tries to end the session with the reason.
+    /// @returns true if the caller has to release the session
+    bool requestEnd(HoldEndReason reason) noexcept
+    {
+        auto state = this->_state.load(std::memory_order_acquire);
+        while(true)
+        {
+            switch(state.phase)
+            {
+                case Phase::Idle:
+                case Phase::Releasing:
+                    return false;
+                case Phase::Arming:
+                case Phase::Held:
+                    if(this->_state.compare_exchange_weak(state, { Phase::Releasing, reason }, std::memory_order_acq_rel))
+                    {
+                        return state.phase == Phase::Held;
+                    }
+                    break;
+            }
+        }
+    }
+
+    /// Returns the time of the waiter's time source, deadlines refer to it
+    TimePoint now() const noexcept { return this->_waiter.WaiterPolicy::timeSource().now(); }
+
+    std::optional<TimePoint> loadDeadline() const noexcept
+    {
+        const auto deadline = this->_deadline.load(std::memory_order_acquire);
+        if(deadline == NoDeadline) { return std::nullopt; }
+        return TimePoint(typename TimePoint::duration(deadline));
+    }
+
+    void storeDeadline(std::optional<TimePoint> deadline) noexcept
+    {
+        this->_deadline.store(deadline ? deadline->time_since_epoch().count() : NoDeadline, std::memory_order_release);
+    }
+
+    /// Records the metrics of this instance and of the process
+    template<typename Function>
+    void record(Function&& function) noexcept
+    {
+        function(this->_metrics);
+        function(Metrics::shared().sessions);
+    }
+
+    void end(HoldEndReason reason) noexcept
+    {
+        if(this->requestEnd(reason))
+        {
+            this->release(reason);
+        }
+    }
+
+    /// Starts a session with the timeout, the configured timeout is kept.
+    /// The awaiter is resumed when the session ends, no member may be
+    /// accessed after it was started or released.
+    Start start(std::chrono::seconds timeout, HoldAwaiter* awaiter) noexcept
+    {
+        auto state = State { Phase::Idle };
+        if(!this->_state.compare_exchange_strong(state, { Phase::Arming }, std::memory_order_acq_rel))
+        {
+            AWAKEN_TRACE(Info, "Awaken is already running.");
+            return Start::Busy;
+        }
+
+        // The components are only configured by the arming thread.
+        this->_awaiter.store(awaiter, std::memory_order_release);
+        this->_waiter.WaiterPolicy::setTimeout(timeout);
+        this->_powerAssertion.timeout = timeout;
+
+        const auto now = this->now();
+        this->storeDeadline(timeout > std::chrono::seconds::zero() ? std::optional(now + timeout) : std::nullopt);
+        this->_startedAt = now;
+        this->record([](SessionMetrics& metrics) {
+            metrics.started.increment();
+            metrics.active.increment();
+        });
+
+        if(!this->_waiter.WaiterPolicy::run())
+        {
+            AWAKEN_TRACE(Error, "Failed to wait for power assertion.");
+            this->storeDeadline(std::nullopt);
+            this->record([](SessionMetrics& metrics) {
+                metrics.active.decrement();
+                metrics.endedCounter(HoldEndReason::Failed).increment();
+            });
+
+            // Nothing was acquired yet, a concurrent end
+            // request only needs to be discarded.
+            this->_awaiter.store(nullptr, std::memory_order_release);
+            this->_state.store({ Phase::Idle }, std::memory_order_release);
+            return Start::Failed;
+        }
+        this->_isWaiting.store(true, std::memory_order_release);
+
+        if(!this->_powerAssertion.run())
+        {
+            AWAKEN_TRACE(Error, "Failed to run power assertion.");
+
+            state = { Phase::Arming };
+            this->_state.compare_exchange_strong(state, { Phase::Releasing, HoldEndReason::Failed }, std::memory_order_acq_rel);
+            this->release(state.phase == Phase::Arming ? HoldEndReason::Failed : state.reason);
+            return Start::Released;
+        }
+
+        // The waiter may have finished while arming, e.g. a `ProcessWaiter`
+        // whose processes already exited. Its handler ends the session
+        // unless this check already did, since another thread may release
+        // a held session, nothing is accessed after publishing it.
+        const auto held = this->_waiter.WaiterPolicy::isRunning()
+            ? State { Phase::Held }
+            : State { Phase::Releasing, HoldEndReason::Timeout };
+        state = { Phase::Arming };
+        if(!this->_state.compare_exchange_strong(state, held, std::memory_order_acq_rel))
+        {
+            // The session was ended while arming,
+            // which leaves releasing it to this thread.
+            this->release(state.reason);
+        }
+        else if(held.phase == Phase::Releasing)
+        {
+            this->release(HoldEndReason::Timeout);
+        }
+        return Start::Started;
+    }
+
+    /// Runs the session for a `HoldAwaiter` of the wrapping `Awaken`
+    /// @returns false if the awaiting coroutine is not suspended
+    bool beginHold(HoldAwaiter& awaiter) noexcept
+    {
+        awaiter._reason = HoldEndReason::Failed;
+
+        // The coroutine may be resumed and destroy the instance before
+        // `start()` returns, only its result is used afterwards.
+        const auto result = this->start(awaiter._timeout, &awaiter);
+        return result == Start::Started || result == Start::Released;
+    }
+
+    void updateCapacityObserver() noexcept requires MonitorsBatteryCapacity
+    {
+        auto& battery = this->_battery;
+        std::lock_guard lock { battery.observerMutex };
+
+        if(battery.thresholdHandlers.empty())
+        {
+            if(battery.capacitySubscription)
+            {
+                this->_powerSource.unregisterFromCapacityChanges();
+                this->_powerSource.unsubscribe(battery.capacitySubscription);
+                battery.capacitySubscription = {};
+            }
+            return;
+        }
+
+        // The threshold is taken whenever the handlers change.
+        battery.threshold.store(battery.minimumCapacity, std::memory_order_relaxed);
+        this->_powerSource.setPollingThreshold(battery.minimumCapacity);
+        if(battery.capacitySubscription) { return; }
+
+        battery.capacitySubscription = this->_powerSource.subscribeToCapacityChanges([this](float capacity) {
+            if(capacity == PowerSourcePolicy::CapacityUnavailable) { return; }
+            if(!this->isBelowMinimumBatteryCapacity(capacity)) { return; }
+
+            const auto phase = this->_state.load(std::memory_order_acquire).phase;
+            if(phase != Phase::Arming && phase != Phase::Held) { return; }
+
+            AWAKEN_TRACE(Info, "Minimum battery capacity reached: %{public}.00f", capacity);
+            this->_battery.thresholdHandlers(capacity);
+            this->end(HoldEndReason::BatteryThreshold);
+        });
+        this->_powerSource.registerForCapacityChanges();
+    }
+
+    /// Returns true if the capacity reached the threshold
+    /// or is predicted to reach it within the margin
+    bool isBelowMinimumBatteryCapacity(float capacity) const noexcept requires MonitorsBatteryCapacity
+    {
+        const auto threshold = this->_battery.threshold.load(std::memory_order_relaxed);
+        if(capacity <= threshold) { return true; }
+
+        const auto margin = std::chrono::seconds(this->_battery.margin.load(std::memory_order_relaxed));
+        if(margin <= std::chrono::seconds::zero()) { return false; }
+
+        const auto remaining = this->_powerSource.timeUntilCapacity(threshold);
+        return remaining && *remaining <= margin;
+    }
+
+    void waiterDidFinish() noexcept
+    {
+        // The waiter also finishes when it is cancelled by a release, only
+        // a held session or a finished run of the arming one is a timeout.
+        const auto state = this->_state.load(std::memory_order_acquire);
+        if(state.phase == Phase::Arming)
+        {
+            if(!this->_isWaiting.load(std::memory_order_acquire)) { return; }
+            if(this->_waiter.WaiterPolicy::isRunning()) { return; }
+        }
+        else if(state.phase != Phase::Held)
+        {
+            return;
+        }
+
+        this->end(HoldEndReason::Timeout);
+    }
+
+    void release(HoldEndReason reason) noexcept
+    {
+        const auto endedAt = reason == HoldEndReason::Timeout
+            ? this->loadDeadline().value_or(this->now())
+            : this->now();
+
+        if(this->_powerAssertion.isRunning() && !this->_powerAssertion.cancel())
+        {
+            AWAKEN_TRACE(Error, "Failed to cancel power assertion.");
+        }
+        if(reason != HoldEndReason::Timeout && !this->_waiter.WaiterPolicy::cancel())
+        {
+            AWAKEN_TRACE(Error, "Failed to cancel power assertion waiter.");
+        }
+
+        const auto awaiter = this->_awaiter.exchange(nullptr, std::memory_order_acq_rel);
+
+        const auto now = this->now();
+        const auto holdDuration = now - this->_startedAt;
+        this->record([&](SessionMetrics& metrics) {
+            metrics.active.decrement();
+            metrics.endedCounter(reason).increment();
+            metrics.holdDuration.record(holdDuration);
+            metrics.handlerLatency.record(now - endedAt);
+        });
+
+        this->storeDeadline(std::nullopt);
+        this->_isWaiting.store(false, std::memory_order_release);
+        this->_state.store({ Phase::Idle }, std::memory_order_release);
+
+        // The handlers may run the next session, the awaiting
+        // coroutine may also destroy the instance, so no member
+        // must be accessed after resuming it.
+        this->_endHandlers(reason);
+
+        if(awaiter != nullptr)
+        {
+            awaiter->_reason = reason;
+            auto& executor = awaiter->_executor;
+            executor.execute([continuation = awaiter->_continuation]{
+                continuation.resume();
+            });
+        }
+    }
+};
+
+}
+
+#endif /* BasicAwaken_hpp */
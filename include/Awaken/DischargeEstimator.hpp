@@ -0,0 +1,84 @@
+//
+//  DischargeEstimator.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef DischargeEstimator_hpp
+#define DischargeEstimator_hpp
+
+#include <chrono>
+#include <optional>
+#include <Awaken/PowerSourceSnapshot.hpp>
+
+namespace Awaken
+{
+
+/// Estimates the discharge rate of a battery from consecutive capacity
+/// samples and predicts when it reaches a capacity.
+///
+/// Power sources report whole percents, so a rate is measured between
+/// two samples that show a drop and predictions start from the latest
+/// drop. The rate is an exponentially weighted moving average whose
+/// weight depends on the time between drops, so irregular notifications
+/// and polls are smoothed over the same time constant. A capacity that
+/// stays unchanged for longer than the rate allows slows the estimate
+/// down. Charging, a rising and an unavailable capacity reset it.
+class DischargeEstimator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /// Rates measured this long before the latest one weigh about a third as much
+    constexpr static std::chrono::seconds DefaultTimeConstant { 600 };
+    
+    /// The bounds of `samplingInterval()`
+    constexpr static std::chrono::seconds MinimumSamplingInterval { 5 };
+    constexpr static std::chrono::seconds MaximumSamplingInterval { 600 };
+    /// Returned by `samplingInterval()` while there is no prediction
+    constexpr static std::chrono::seconds DefaultSamplingInterval { 60 };
+    
+    explicit DischargeEstimator(std::chrono::seconds timeConstant = DefaultTimeConstant) noexcept;
+    
+    /// Adds the aggregate capacity of the snapshot taken at the time point
+    void record(const PowerSourceSnapshot&, Clock::time_point) noexcept;
+    
+    /// Discards all samples
+    void reset() noexcept;
+    
+    /// Returns the discharge rate in percent per hour,
+    /// if at least two drops of the capacity were recorded
+    std::optional<float> dischargeRate() const noexcept;
+    
+    /// Returns the predicted time from `now` until the capacity is reached,
+    /// zero if it already was or nothing if the battery is not discharging
+    std::optional<Clock::duration> timeUntil(float capacity, Clock::time_point now) const noexcept;
+    
+    /// Returns the interval to sample a power source at that does not report
+    /// changes, half the time until the capacity is reached at the earliest,
+    /// so samples become more frequent as the capacity approaches.
+    Clock::duration samplingInterval(float capacity, Clock::time_point now) const noexcept;
+    
+private:
+    const double _timeConstant;
+    
+    /// The rate in percent per second
+    std::optional<double> _rate;
+    float _capacity = PowerSourceSnapshot::CapacityUnavailable;
+    /// The size of the latest drop
+    float _drop = 0;
+    /// When the capacity dropped to `_capacity`, unknown for the first sample
+    std::optional<Clock::time_point> _droppedAt;
+    /// The time since the sample before the drop, it may have happened any time in between
+    Clock::duration _dropUncertainty { 0 };
+    Clock::time_point _sampledAt;
+    
+    /// Returns the rate bounded by the time since the latest drop
+    std::optional<double> rate(Clock::time_point now) const noexcept;
+};
+
+}
+
+#endif /* DischargeEstimator_hpp */
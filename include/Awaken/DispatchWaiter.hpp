@@ -9,6 +9,7 @@
 #ifndef DispatchWaiter_hpp
 #define DispatchWaiter_hpp
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <optional>
@@ -46,11 +47,12 @@ public:
     bool isRunning() const noexcept override;
     bool run() noexcept override;
     bool cancel() noexcept override;
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
     
 private:
     std::chrono::seconds _timeout { 0 };
     std::optional<std::function<void()>> _timeoutHandler = std::nullopt;
-    bool _running = false;
+    std::atomic<bool> _running = false;
     dispatch_queue_t _dispatchQueue;
 };
 
@@ -0,0 +1,155 @@
+//
+//  Executor.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef Executor_hpp
+#define Executor_hpp
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Awaken/Metrics.hpp>
+
+namespace Awaken
+{
+
+/// Runs work items, e.g. the continuation of a suspended coroutine,
+/// on a context chosen by the embedding application.
+class Executor
+{
+public:
+    virtual ~Executor() = default;
+
+    /// Schedules the work item, it may be called before this returns.
+    virtual void execute(std::function<void()>&& work) noexcept = 0;
+};
+
+/// An executor that calls each work item immediately
+/// on the thread that schedules it.
+class InlineExecutor : public Executor
+{
+public:
+    /// Returns the process-wide inline executor
+    static InlineExecutor& shared() noexcept;
+
+    void execute(std::function<void()>&& work) noexcept override;
+};
+
+/// An executor that runs work items on a small pool of reusable threads,
+/// the default for the handlers of waiters and power sources.
+///
+/// Work items wait in a bounded queue. If it is full, a work item runs
+/// on the scheduling thread instead, so scheduling never blocks. The
+/// threads are started with the first work item. How long each work
+/// item waited and ran is recorded in `metrics()` and `Metrics::shared()`.
+class WorkerPoolExecutor : public Executor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    constexpr static std::size_t DefaultThreadCount = 2;
+    constexpr static std::size_t DefaultQueueCapacity = 1024;
+
+#pragma mark - Life Cycle
+
+    /// Returns the process-wide worker pool
+    static WorkerPoolExecutor& shared() noexcept;
+
+    explicit WorkerPoolExecutor(std::size_t threadCount = DefaultThreadCount,
+                                std::size_t queueCapacity = DefaultQueueCapacity) noexcept;
+    /// Runs the queued work items before the threads are stopped
+    ~WorkerPoolExecutor() noexcept;
+
+    WorkerPoolExecutor(const WorkerPoolExecutor&) = delete;
+    WorkerPoolExecutor& operator=(const WorkerPoolExecutor&) = delete;
+
+    WorkerPoolExecutor(WorkerPoolExecutor&&) = delete;
+    WorkerPoolExecutor& operator=(WorkerPoolExecutor&&) = delete;
+
+#pragma mark - Executing
+
+    void execute(std::function<void()>&& work) noexcept override;
+
+    /// Returns the metrics of the work items run by this executor
+    const ExecutorMetrics& metrics() const noexcept { return this->_metrics; }
+
+private:
+    struct WorkItem
+    {
+        std::function<void()> work;
+        Clock::time_point scheduledAt;
+    };
+
+    const std::size_t _threadCount;
+
+    /// A ring buffer of `_count` work items starting at `_head`
+    std::vector<WorkItem> _queue;
+    std::size_t _head = 0;
+    std::size_t _count = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+    std::vector<std::thread> _threads;
+
+    ExecutorMetrics _metrics;
+
+    void run(WorkItem&) noexcept;
+    void workerLoop() noexcept;
+};
+
+/// Calls a handler through an executor, e.g. the timeout handler of a
+/// waiter, without allocating.
+///
+/// Scheduling is coalesced, a handler that is scheduled again before it
+/// is called is only called once. Calls are serialized, a call scheduled
+/// while the handler is running follows on the same thread. Queued calls
+/// are dropped by `discard()` and when the instance is destroyed, both
+/// wait for a call in progress on another thread, so the handler is
+/// never called after its owner is gone.
+class ScheduledHandler
+{
+public:
+
+#pragma mark - Life Cycle
+
+    /// @param executor Calls the handler, defaults to the process-wide worker pool
+    explicit ScheduledHandler(Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    ~ScheduledHandler() noexcept;
+
+    ScheduledHandler(const ScheduledHandler&) = delete;
+    ScheduledHandler& operator=(const ScheduledHandler&) = delete;
+
+    ScheduledHandler(ScheduledHandler&&) = delete;
+    ScheduledHandler& operator=(ScheduledHandler&&) = delete;
+
+#pragma mark - Scheduling
+
+    /// Replaces the handler, must not be called from within the handler
+    void setHandler(std::function<void()>&&) noexcept;
+
+    /// Schedules a call of the handler unless one is already queued
+    void schedule() noexcept;
+
+    /// Drops a queued call and waits for a call in progress
+    /// on another thread to return
+    void discard() noexcept;
+
+private:
+    struct State;
+
+    Executor& _executor;
+    State* _state;
+};
+
+}
+
+#endif /* Executor_hpp */
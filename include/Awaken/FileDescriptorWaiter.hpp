@@ -0,0 +1,105 @@
+//
+//  FileDescriptorWaiter.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef FileDescriptorWaiter_hpp
+#define FileDescriptorWaiter_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <Awaken/Executor.hpp>
+#include <Awaken/Waiter.hpp>
+
+namespace Awaken
+{
+
+/// A waiter that finishes once a file descriptor reaches end-of-file or
+/// is hung up, e.g. when the upstream stage of a pipeline exits, or when
+/// its timeout is reached.
+///
+/// A private thread blocks on the descriptor and a wake-up pipe, it only
+/// wakes up when the descriptor is ready, the deadline is reached or the
+/// waiter is cancelled. It is started by the first run and reused by all
+/// following runs, the timeout handler is called through the executor.
+///
+/// By default the data on the descriptor is left for its other readers
+/// and the waiter finishes when the descriptor is hung up, e.g. when the
+/// writing end of a pipe or socket is closed, with `POLLHUP`/`POLLRDHUP`
+/// on Linux and `EV_EOF` on macOS. A descriptor that cannot hang up, like
+/// a regular file or a terminal, only finishes by timing out. Consuming
+/// waiters read the descriptor until end-of-file instead, discarding the
+/// data or passing it through to another descriptor, using `splice()` on
+/// Linux to avoid copying it through user space.
+class FileDescriptorWaiter : public Waiter
+{
+public:
+
+    /// What the waiter does with data arriving on the descriptor
+    enum class Input : uint8_t
+    {
+        /// Leaves the data unread and waits for the descriptor to hang up
+        Keep,
+        /// Reads and discards the data until end-of-file
+        Consume,
+    };
+
+#pragma mark - Life Cycle
+
+    /// @param fd The descriptor to wait for, it is not closed by the waiter
+    /// @param input Whether the data on `fd` is left unread or consumed
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    explicit FileDescriptorWaiter(int fd, Input input = Input::Keep,
+                                  Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    /// Consumes the descriptor until end-of-file and passes its data through
+    /// @param fd The descriptor to wait for, it is not closed by the waiter
+    /// @param passThroughFD Receives all data read from `fd`.
+    ///                      Writing blocks while the receiver does not read.
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    FileDescriptorWaiter(int fd, int passThroughFD,
+                         Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    ~FileDescriptorWaiter() noexcept;
+
+    FileDescriptorWaiter(const FileDescriptorWaiter&) = delete;
+    FileDescriptorWaiter& operator=(const FileDescriptorWaiter&) = delete;
+
+    FileDescriptorWaiter(FileDescriptorWaiter&&) = delete;
+    FileDescriptorWaiter& operator=(FileDescriptorWaiter&&) = delete;
+
+#pragma mark - Properties
+
+    /// Sets a timeout in addition to the descriptor, 0 waits until it closes
+    void setTimeout(std::chrono::seconds) noexcept override;
+    void setTimeoutHandler(std::function<void()>&&) noexcept override;
+
+    /// Returns the number of bytes consumed from the descriptor so far
+    uint64_t transferredBytes() const noexcept;
+
+#pragma mark - Running
+
+    bool isRunning() const noexcept override;
+    bool run() noexcept override;
+    bool cancel() noexcept override;
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
+
+private:
+    struct State;
+
+    std::chrono::seconds _timeout { 0 };
+    /// Shared with the thread, which outlives the waiter
+    /// if the waiter is destroyed from its own thread
+    std::shared_ptr<State> _state;
+    std::thread _thread;
+
+    static void wait(State&) noexcept;
+};
+
+}
+
+#endif /* FileDescriptorWaiter_hpp */
@@ -0,0 +1,195 @@
+//
+//  HandlerList.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef HandlerList_hpp
+#define HandlerList_hpp
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Awaken
+{
+
+/// Identifies a handler added to a `HandlerList`,
+/// identifiers are unique within the process.
+class Subscription
+{
+public:
+    /// An empty subscription
+    Subscription() noexcept = default;
+
+    /// Returns a new process-wide unique subscription
+    static Subscription make() noexcept
+    {
+        static std::atomic<uint64_t> lastIdentifier { 0 };
+        return Subscription(lastIdentifier.fetch_add(1, std::memory_order_relaxed) + 1);
+    }
+
+    uint64_t identifier() const noexcept { return this->_identifier; }
+    explicit operator bool() const noexcept { return this->_identifier != 0; }
+    bool operator==(const Subscription&) const noexcept = default;
+
+private:
+    explicit Subscription(uint64_t identifier) noexcept : _identifier(identifier) {}
+
+    uint64_t _identifier = 0;
+};
+
+/// A list of handlers that is read far more often than it is modified.
+///
+/// Subscribing and unsubscribing copy the list and publish the copy
+/// with a single atomic store, writers are serialized. Calling the
+/// handlers never takes a lock and never copies a handler, it counts
+/// itself as a reader, loads the current list and iterates it.
+/// Handlers may subscribe or unsubscribe while they are being called,
+/// a replaced list is kept until no reader can still be iterating it.
+template<typename... Arguments>
+class HandlerList
+{
+public:
+    using Handler = std::function<void(Arguments...)>;
+
+    HandlerList() noexcept = default;
+
+    ~HandlerList() noexcept
+    {
+        delete this->_handlers.load(std::memory_order_relaxed);
+        for(auto handlers : this->_retired)
+        {
+            delete handlers;
+        }
+    }
+
+    HandlerList(const HandlerList&) = delete;
+    HandlerList& operator=(const HandlerList&) = delete;
+
+    HandlerList(HandlerList&&) = delete;
+    HandlerList& operator=(HandlerList&&) = delete;
+
+#pragma mark - Subscribing
+
+    /// Adds the handler to the list
+    /// @returns the subscription to remove the handler again
+    Subscription subscribe(Handler&& handler) noexcept
+    {
+        auto subscription = Subscription {};
+        this->replace(subscription, std::move(handler));
+        return subscription;
+    }
+
+    /// Removes the handler of the subscription from the list
+    /// @returns false if the subscription is not part of the list
+    bool unsubscribe(Subscription subscription) noexcept
+    {
+        return this->replace(subscription, nullptr);
+    }
+
+    /// Replaces the handler of the subscription in a single step and
+    /// updates the subscription, a `nullptr` handler removes it.
+    /// Callers never observe both or neither of the handlers.
+    /// @returns false if the subscription was not part of the list
+    bool replace(Subscription& subscription, Handler&& handler) noexcept
+    {
+        std::lock_guard lock { this->_writerMutex };
+
+        const auto current = this->_handlers.load(std::memory_order_relaxed);
+        auto entries = current != nullptr ? current->entries : std::vector<Entry> {};
+
+        const auto entry = std::find_if(entries.begin(), entries.end(), [&subscription](const Entry& entry) {
+            return entry.subscription == subscription;
+        });
+        const bool didContain = subscription && entry != entries.end();
+        if(didContain)
+        {
+            entries.erase(entry);
+        }
+
+        subscription = Subscription {};
+        if(handler != nullptr)
+        {
+            subscription = Subscription::make();
+            entries.push_back({ subscription, std::move(handler) });
+        }
+
+        const auto handlers = entries.empty() ? nullptr : new Handlers { std::move(entries) };
+        this->publish(current, handlers);
+        return didContain;
+    }
+
+    /// Returns true if no handler is subscribed
+    bool empty() const noexcept
+    {
+        return this->_handlers.load(std::memory_order_acquire) == nullptr;
+    }
+
+#pragma mark - Calling
+
+    /// Calls all subscribed handlers on the current thread
+    void operator()(Arguments... arguments) const noexcept
+    {
+        if(this->_handlers.load(std::memory_order_relaxed) == nullptr) { return; }
+
+        this->_readerCount.fetch_add(1, std::memory_order_seq_cst);
+        if(const auto handlers = this->_handlers.load(std::memory_order_seq_cst))
+        {
+            for(const auto& entry : handlers->entries)
+            {
+                entry.handler(arguments...);
+            }
+        }
+        this->_readerCount.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    struct Entry
+    {
+        Subscription subscription;
+        Handler handler;
+    };
+
+    struct Handlers
+    {
+        std::vector<Entry> entries;
+    };
+
+    std::atomic<const Handlers*> _handlers = nullptr;
+    mutable std::atomic<std::size_t> _readerCount = 0;
+
+    std::mutex _writerMutex;
+    std::vector<const Handlers*> _retired;
+
+    void publish(const Handlers* current, const Handlers* handlers) noexcept
+    {
+        this->_handlers.store(handlers, std::memory_order_seq_cst);
+        if(current != nullptr)
+        {
+            this->_retired.push_back(current);
+        }
+
+        // A caller that starts after the store only sees the new
+        // list, so retired lists are unreachable once no caller is
+        // left. Otherwise they are reclaimed by a later write.
+        if(this->_readerCount.load(std::memory_order_seq_cst) == 0)
+        {
+            for(auto retired : this->_retired)
+            {
+                delete retired;
+            }
+            this->_retired.clear();
+        }
+    }
+};
+
+}
+
+#endif /* HandlerList_hpp */
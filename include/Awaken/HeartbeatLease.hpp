@@ -0,0 +1,101 @@
+//
+//  HeartbeatLease.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef HeartbeatLease_hpp
+#define HeartbeatLease_hpp
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <Awaken/Awaken.hpp>
+#include <Awaken/HandlerList.hpp>
+#include <Awaken/HeartbeatWaiter.hpp>
+#include <Awaken/PowerAssertionBackend.hpp>
+#include <Awaken/TimerWheel.hpp>
+
+namespace Awaken
+{
+
+/// A hold that its owner keeps alive by renewing it within a TTL,
+/// so a stalled holder cannot keep the machine awake forever.
+///
+/// All leases are checked by the shared timing wheel through a
+/// `HeartbeatWaiter`. A lease that is not renewed in time ends its
+/// session like a timeout, with `HoldEndReason::Timeout`, and its owner
+/// is reported to the missed heartbeat handlers.
+class HeartbeatLease
+{
+public:
+
+#pragma mark - Life Cycle
+
+    /// @param owner Identifies the holder in reports and system logs
+    /// @param ttl The time the holder may go without renewing the lease
+    /// @param backend The backend that creates the actual power assertions
+    /// @param wheel The timing wheel checking the heartbeats
+    HeartbeatLease(std::string owner,
+                   std::chrono::milliseconds ttl,
+                   std::shared_ptr<PowerAssertionBackend> backend = PowerAssertionBackend::systemDefault(),
+                   TimerWheel& wheel = TimerWheel::shared()) noexcept;
+    ~HeartbeatLease() noexcept;
+
+    HeartbeatLease(const HeartbeatLease&) = delete;
+    HeartbeatLease& operator=(const HeartbeatLease&) = delete;
+
+    HeartbeatLease(HeartbeatLease&&) = delete;
+    HeartbeatLease& operator=(HeartbeatLease&&) = delete;
+
+#pragma mark - Properties
+
+    const std::string& owner() const noexcept { return this->_owner; }
+    std::chrono::milliseconds ttl() const noexcept { return this->_waiter->ttl(); }
+
+    /// The session holding the power assertions, e.g. to select the
+    /// assertion types, set an overall timeout or subscribe to its end
+    ::Awaken::Awaken& session() noexcept { return this->_session; }
+
+#pragma mark - Heartbeats
+
+    /// Takes the lease, which counts as the first heartbeat
+    /// @returns false if already held or the power assertions cannot be created
+    bool acquire() noexcept;
+
+    /// Renews the lease for another TTL, may be called from any thread.
+    /// A single atomic store, it neither allocates, locks nor makes a syscall.
+    void renew() noexcept { this->_waiter->renew(); }
+
+    /// Releases the lease before it expires
+    void release() noexcept;
+
+    bool isHeld() const noexcept;
+
+    /// Adds a handler that will be called with the owner when the lease
+    /// ended because it was not renewed in time, on the wheel's service
+    /// thread after the power assertions were released.
+    /// @returns the subscription to remove the handler with `unsubscribe()`
+    Subscription subscribeToMissedHeartbeat(std::function<void(const std::string&)>&&) noexcept;
+
+    /// Removes a handler added with `subscribeToMissedHeartbeat()`
+    /// @returns false if the subscription is unknown
+    bool unsubscribe(Subscription) noexcept;
+
+private:
+    const std::string _owner;
+    // Outlives the session, whose waiter waits for a running handler.
+    HandlerList<const std::string&> _missedHeartbeatHandlers;
+    HeartbeatWaiter* _waiter;
+    ::Awaken::Awaken _session;
+    Subscription _endSubscription;
+
+    void sessionDidEnd(HoldEndReason) noexcept;
+};
+
+}
+
+#endif /* HeartbeatLease_hpp */
@@ -0,0 +1,101 @@
+//
+//  HeartbeatWaiter.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef HeartbeatWaiter_hpp
+#define HeartbeatWaiter_hpp
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <Awaken/Executor.hpp>
+#include <Awaken/TimerWheel.hpp>
+#include <Awaken/Waiter.hpp>
+
+namespace Awaken
+{
+
+/// A waiter that also times out when it is not renewed within its TTL,
+/// see `HeartbeatLease`.
+///
+/// Renewing only stores the current time. The timer on the shared timing
+/// wheel stays armed for the expiry it was scheduled with, when it fires
+/// it compares against the last heartbeat and re-arms itself, so a steady
+/// holder costs at most one re-arm per TTL on the wheel's service thread.
+/// The timeout handler is called through the executor.
+class HeartbeatWaiter : public Waiter
+{
+public:
+    using Clock = TimerWheel::Clock;
+
+#pragma mark - Life Cycle
+
+    /// @param ttl The time the waiter may go without being renewed
+    /// @param wheel The timing wheel, defaults to the process-wide wheel
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    explicit HeartbeatWaiter(std::chrono::milliseconds ttl,
+                             TimerWheel& wheel = TimerWheel::shared(),
+                             Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    ~HeartbeatWaiter() noexcept;
+
+    HeartbeatWaiter(const HeartbeatWaiter&) = delete;
+    HeartbeatWaiter& operator=(const HeartbeatWaiter&) = delete;
+
+    HeartbeatWaiter(HeartbeatWaiter&&) = delete;
+    HeartbeatWaiter& operator=(HeartbeatWaiter&&) = delete;
+
+#pragma mark - Properties
+
+    /// Sets an overall timeout in addition to the TTL, 0 waits until cancelled
+    void setTimeout(std::chrono::seconds) noexcept override;
+    void setTimeoutHandler(std::function<void()>&&) noexcept override;
+    /// Returns the time source of the wheel
+    TimeSource& timeSource() const noexcept override { return this->_wheel.timeSource(); }
+
+    std::chrono::milliseconds ttl() const noexcept { return this->_ttl; }
+
+#pragma mark - Heartbeats
+
+    /// Moves the heartbeat expiry to now plus the TTL, may be called from
+    /// any thread. A single atomic store, it neither locks nor re-arms the timer.
+    void renew() noexcept
+    {
+        this->_lastHeartbeat.store(this->_wheel.now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    /// Returns true if the last run ended because it was not renewed in time
+    bool didMissHeartbeat() const noexcept;
+
+#pragma mark - Running
+
+    bool isRunning() const noexcept override;
+    bool run() noexcept override;
+    bool cancel() noexcept override;
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
+
+private:
+    constexpr static Clock::rep NoDeadline = std::numeric_limits<Clock::rep>::max();
+
+    TimerWheel& _wheel;
+    const std::chrono::milliseconds _ttl;
+    std::chrono::seconds _timeout { 0 };
+    ScheduledHandler _timeoutHandler;
+    std::atomic<bool> _running = false;
+    std::atomic<bool> _didMissHeartbeat = false;
+    std::atomic<Clock::rep> _lastHeartbeat { 0 };
+    std::atomic<Clock::rep> _deadline { NoDeadline };
+    TimerWheel::Timer _timer;
+
+    void timerDidFire() noexcept;
+    Clock::time_point heartbeatExpiry() const noexcept;
+    Clock::time_point nextExpiry() const noexcept;
+};
+
+}
+
+#endif /* HeartbeatWaiter_hpp */
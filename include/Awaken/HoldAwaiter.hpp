@@ -0,0 +1,62 @@
+//
+//  HoldAwaiter.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef HoldAwaiter_hpp
+#define HoldAwaiter_hpp
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+
+namespace Awaken
+{
+class Awaken;
+class Executor;
+template<typename AssertionPolicy, typename PowerSourcePolicy, typename WaiterPolicy> class BasicAwaken;
+
+/// Describes why a hold of power assertions ended
+enum class HoldEndReason : uint8_t
+{
+    /// The timeout was reached
+    Timeout,
+    /// The hold was cancelled with `Awaken::cancel()`
+    Cancelled,
+    /// The minimum battery capacity was reached
+    BatteryThreshold,
+    /// The power assertions could not be created
+    Failed,
+};
+
+/// An awaitable that runs an `Awaken` instance and completes
+/// when its hold ends, see `Awaken::holdFor()`.
+///
+/// The awaiting coroutine is suspended without blocking any thread
+/// and resumed on the given executor with the `HoldEndReason`.
+class HoldAwaiter
+{
+public:
+    HoldAwaiter(Awaken& awaken, std::chrono::seconds timeout, Executor& executor) noexcept;
+    
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> continuation) noexcept;
+    HoldEndReason await_resume() const noexcept { return this->_reason; }
+    
+private:
+    friend class Awaken;
+    template<typename, typename, typename> friend class BasicAwaken;
+    
+    Awaken& _awaken;
+    std::chrono::seconds _timeout;
+    Executor& _executor;
+    std::coroutine_handle<> _continuation;
+    HoldEndReason _reason;
+};
+
+}
+
+#endif /* HoldAwaiter_hpp */
@@ -0,0 +1,40 @@
+//
+//  IOKitPowerAssertionBackend.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef IOKitPowerAssertionBackend_hpp
+#define IOKitPowerAssertionBackend_hpp
+
+#include <memory>
+#include <Awaken/PowerAssertionBackend.hpp>
+
+namespace Awaken
+{
+
+/// Creates power assertions using IOKit, only available on macOS.
+class IOKitPowerAssertionBackend : public PowerAssertionBackend
+{
+public:
+    IOKitPowerAssertionBackend() noexcept;
+    ~IOKitPowerAssertionBackend() noexcept;
+    
+    std::optional<PowerAssertionID> create(PowerAssertionType type,
+                                           const std::string& name,
+                                           std::chrono::seconds timeout) noexcept override;
+    bool release(PowerAssertionID) noexcept override;
+    bool setTimeout(PowerAssertionID, std::chrono::seconds) noexcept override;
+    
+private:
+    /// The assertion names converted to CoreFoundation strings,
+    /// each name is only converted once.
+    struct Names;
+    std::unique_ptr<Names> _names;
+};
+
+}
+
+#endif /* IOKitPowerAssertionBackend_hpp */
@@ -0,0 +1,41 @@
+//
+//  IOKitPowerSourceProvider.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef IOKitPowerSourceProvider_hpp
+#define IOKitPowerSourceProvider_hpp
+
+#include <functional>
+#include <optional>
+#include <Awaken/PowerSourceProvider.hpp>
+
+namespace Awaken
+{
+
+/// Reads power sources using IOKit, only available on macOS.
+class IOKitPowerSourceProvider : public PowerSourceProvider
+{
+public:
+    IOKitPowerSourceProvider() noexcept;
+    ~IOKitPowerSourceProvider() noexcept;
+    
+    IOKitPowerSourceProvider(const IOKitPowerSourceProvider&) = delete;
+    IOKitPowerSourceProvider& operator=(const IOKitPowerSourceProvider&) = delete;
+    
+    PowerSourceSnapshot copySnapshot() noexcept override;
+    bool startObserving(std::function<void()>&& changeHandler) noexcept override;
+    void stopObserving() noexcept override;
+    
+private:
+    std::optional<std::function<void()>> _changeHandler;
+    void* _dispatchQueue;
+    int _notificationToken;
+};
+
+}
+
+#endif /* IOKitPowerSourceProvider_hpp */
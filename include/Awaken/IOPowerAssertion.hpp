@@ -11,7 +11,11 @@
 
 #include <string>
 #include <chrono>
+#include <memory>
+#include <atomic>
 #include <optional>
+#include <Awaken/PowerAssertionBackend.hpp>
+#include <Awaken/PowerAssertionRegistry.hpp>
 
 namespace Awaken
 {
@@ -24,19 +28,25 @@ public:
     
     std::string name { "Awaken" };
     std::chrono::seconds timeout { 0 };
+    std::chrono::milliseconds releaseLinger { 0 };
     bool preventUserIdleSystemSleep = false;
     bool preventUserIdleDisplaySleep = false;
     
 #pragma mark - Life Cycle
     
     IOPowerAssertion() noexcept;
+    /// @param backend The backend that creates the actual power assertions,
+    ///                assertions are shared with all instances using the same backend.
+    explicit IOPowerAssertion(std::shared_ptr<PowerAssertionBackend> backend) noexcept;
+    /// @param registry The registry used to share power assertions
+    explicit IOPowerAssertion(std::shared_ptr<PowerAssertionRegistry> registry) noexcept;
     ~IOPowerAssertion() noexcept;
     
     IOPowerAssertion(const IOPowerAssertion&) = delete;
     IOPowerAssertion& operator=(const IOPowerAssertion&) = delete;
     
-    IOPowerAssertion(IOPowerAssertion&&) = default;
-    IOPowerAssertion& operator=(IOPowerAssertion&&) = default;
+    IOPowerAssertion(IOPowerAssertion&&) = delete;
+    IOPowerAssertion& operator=(IOPowerAssertion&&) = delete;
     
 #pragma mark - Running
     
@@ -44,9 +54,25 @@ public:
     bool run() noexcept;
     bool cancel() noexcept;
     
+    /// Makes sure the running assertions do not time out within the
+    /// duration from now, may be called concurrently with `cancel()`.
+    /// Sessions measure the duration with their own time source.
+    /// @returns false if not running or the assertions could not be extended
+    bool extend(std::chrono::steady_clock::duration remaining) noexcept;
+    
 private:
-    std::optional<uint32_t> _systemAssertionID;
-    std::optional<uint32_t> _displayAssertionID;
+    std::shared_ptr<PowerAssertionRegistry> _registry;
+    /// The entries of the last run, only resolved again when the timeout
+    /// changes, so running does not take the registry's entries mutex
+    std::chrono::seconds _entryTimeout { 0 };
+    PowerAssertionRegistry::Entry* _systemEntry = nullptr;
+    PowerAssertionRegistry::Entry* _displayEntry = nullptr;
+    std::atomic<PowerAssertionRegistry::Entry*> _systemAssertion;
+    std::atomic<PowerAssertionRegistry::Entry*> _displayAssertion;
+    
+    /// Returns the cached entry for the type and the current timeout
+    PowerAssertionRegistry::Entry& entry(PowerAssertionRegistry::Entry*& cachedEntry, PowerAssertionType) noexcept;
+    void forgetEntries() noexcept;
 };
 
 }
@@ -9,50 +9,119 @@
 #ifndef IOPowerSource_hpp
 #define IOPowerSource_hpp
 
+#include <atomic>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <Awaken/DischargeEstimator.hpp>
+#include <Awaken/Executor.hpp>
+#include <Awaken/HandlerList.hpp>
+#include <Awaken/PowerSourceAggregator.hpp>
+#include <Awaken/PowerSourceProvider.hpp>
+#include <Awaken/PowerSourceSnapshot.hpp>
+#include <Awaken/SeqLock.hpp>
+#include <Awaken/TimerWheel.hpp>
 
 namespace Awaken
 {
 
-/// Represents the device power source with a battery capacity
-/// if available.
+/// Represents the device power sources with an aggregate battery
+/// capacity if available.
+///
+/// Every attached power source is tracked individually, the sources
+/// selected by the source filter are combined into one capacity.
+///
+/// The power source description is decoded once into a cached
+/// `PowerSourceSnapshot` that is only refreshed by change
+/// notifications, repeated queries read the cached value.
+///
+/// Capacity change handlers are called through the executor, changes
+/// that arrive while a call is pending are folded into that call.
+/// Providers without change notifications are polled instead, at an
+/// interval that shrinks as the predicted time until the polling
+/// threshold does, see `DischargeEstimator`.
 class IOPowerSource
 {
 public:
     
     /// A return value representing the unavailability
     /// of a power source capacity.
-    constexpr static float CapacityUnavailable = -1.0;
+    constexpr static float CapacityUnavailable = PowerSourceSnapshot::CapacityUnavailable;
     
 #pragma mark - Life Cycle
     
     IOPowerSource() noexcept;
+    /// @param provider The provider reading the actual power sources
+    /// @param executor Calls the capacity change handlers, defaults to the process-wide worker pool
+    explicit IOPowerSource(std::shared_ptr<PowerSourceProvider> provider,
+                           Executor& executor = WorkerPoolExecutor::shared()) noexcept;
     ~IOPowerSource() noexcept;
     
     IOPowerSource(const IOPowerSource&) = delete;
     IOPowerSource& operator=(const IOPowerSource&) = delete;
     
-    IOPowerSource(IOPowerSource&&) = default;
-    IOPowerSource& operator=(IOPowerSource&&) = default;
+    IOPowerSource(IOPowerSource&&) = delete;
+    IOPowerSource& operator=(IOPowerSource&&) = delete;
     
 #pragma mark - Battery Capacity
     
-    /// Returns true if the current device has a built-in battery.
+    /// Returns the current power source description.
+    PowerSourceSnapshot snapshot() const noexcept;
+    
+    /// Returns true if a power source matching the
+    /// source filter reports a capacity.
     bool hasBattery() const noexcept;
     
-    /// Returns the power source battery capacity or
-    /// `CapacityUnavailable` if no capacity is available.
+    /// Returns the aggregate battery capacity of the matching power
+    /// sources or `CapacityUnavailable` if no capacity is available.
     float capacity() const noexcept;
     
+#pragma mark - Discharge Prediction
+    
+    /// Returns the estimated discharge rate in percent per hour,
+    /// if the battery has been discharging for at least two samples.
+    std::optional<float> dischargeRate() const noexcept;
+    
+    /// Returns the predicted time until the aggregate capacity reaches
+    /// the capacity, if the battery is discharging.
+    std::optional<std::chrono::seconds> timeUntilCapacity(float capacity) const noexcept;
+    
+    /// Sets the capacity whose predicted crossing the polling interval
+    /// adapts to, if the provider does not report changes.
+    void setPollingThreshold(float capacity) noexcept;
+    
+#pragma mark - Source Filter
+    
+    /// Selects the power sources that contribute to the capacity,
+    /// defaults to `PowerSourceFilter::InternalBattery`.
+    void setSourceFilter(PowerSourceFilter) noexcept;
+    
+    /// Returns the filter selecting the aggregated power sources
+    PowerSourceFilter sourceFilter() const noexcept;
+    
 #pragma mark - Capacity Changes
     
     /// An optional handler that will be called when the power source capacity
-    /// changes and `registerForCapacityChanges()` was called.
+    /// changes and `registerForCapacityChanges()` was called. It may be
+    /// replaced from any thread, also from within the handler itself.
+    /// It is called along with all handlers added with
+    /// `subscribeToCapacityChanges()`.
     void setCapacityChangeHandler(std::function<void(float)>&&) noexcept;
     
+    /// Adds a handler that will be called when the power source capacity
+    /// changes and `registerForCapacityChanges()` was called.
+    /// @returns the subscription to remove the handler with `unsubscribe()`
+    Subscription subscribeToCapacityChanges(std::function<void(float)>&&) noexcept;
+    
+    /// Removes a handler added with `subscribeToCapacityChanges()`
+    /// @returns false if the subscription is unknown
+    bool unsubscribe(Subscription) noexcept;
+    
     /// Registers the instance to receive power source capacity change
-    /// events using the handler set with `setCapacityChangeHandler()`.
+    /// events using the subscribed handlers. The provider is polled
+    /// if it does not report changes.
     /// @returns false if already registered for capacity changes
     bool registerForCapacityChanges() noexcept;
     
@@ -62,10 +131,37 @@ public:
     bool unregisterFromCapacityChanges() noexcept;
     
 private:
-    float _capacity;
-    std::optional<std::function<void(float)>> _capacityChangeHandler;
-    void* _dispatchQueue;
-    int _notificationToken;
+    struct CachedSnapshot
+    {
+        bool isValid = false;
+        PowerSourceSnapshot snapshot;
+    };
+    
+    std::shared_ptr<PowerSourceProvider> _provider;
+    mutable SeqLock<CachedSnapshot> _cachedSnapshot;
+    mutable std::mutex _refreshMutex;
+    mutable PowerSourceAggregator _aggregator;
+    mutable DischargeEstimator _estimator;
+    mutable std::mutex _observingMutex;
+    mutable bool _isObserving;
+    bool _isPolling = false;
+    std::atomic<bool> _isRegistered;
+    std::atomic<float> _capacity;
+    std::atomic<float> _pollingThreshold;
+    HandlerList<float> _capacityChangeHandlers;
+    Subscription _capacityChangeHandlerSubscription;
+    TimerWheel::Timer _pollTimer;
+    /// Declared last, so no call is in progress while the members above are destroyed
+    ScheduledHandler _capacityChangeNotification;
+    ScheduledHandler _poll;
+    
+    bool startObservingIfNeeded() const noexcept;
+    /// Reads the provider into the aggregate and the estimator,
+    /// must be called with the refresh mutex held
+    PowerSourceSnapshot refresh() const noexcept;
+    void powerSourceDidChange() noexcept;
+    void poll() noexcept;
+    void notifyCapacityChangeHandlers(float capacity) noexcept;
 };
 
 }
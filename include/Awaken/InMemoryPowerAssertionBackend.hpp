@@ -0,0 +1,116 @@
+//
+//  InMemoryPowerAssertionBackend.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef InMemoryPowerAssertionBackend_hpp
+#define InMemoryPowerAssertionBackend_hpp
+
+#include <chrono>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <Awaken/PowerAssertionBackend.hpp>
+
+namespace Awaken
+{
+
+/// An in-process backend that does not hold any real power assertions,
+/// but counts every call and optionally records the latest ones
+/// for benchmarks and tests.
+class InMemoryPowerAssertionBackend : public PowerAssertionBackend
+{
+public:
+
+    /// A recorded backend call
+    struct Call
+    {
+        enum class Kind : uint8_t { Create, Release, Update };
+
+        Kind kind;
+        PowerAssertionType type;
+        PowerAssertionID assertionID;
+        bool succeeded;
+        std::chrono::steady_clock::time_point time;
+        std::chrono::nanoseconds duration;
+    };
+
+#pragma mark - Backend
+
+    std::optional<PowerAssertionID> create(PowerAssertionType type,
+                                           const std::string& name,
+                                           std::chrono::seconds timeout) noexcept override;
+    bool release(PowerAssertionID) noexcept override;
+    bool setTimeout(PowerAssertionID, std::chrono::seconds) noexcept override;
+
+#pragma mark - Simulation
+
+    /// Simulates the round-trip latency of a real backend call
+    void setLatency(std::chrono::nanoseconds) noexcept;
+
+    /// Lets all following calls for the assertion type fail if true
+    void setFailing(PowerAssertionType, bool failing) noexcept;
+
+#pragma mark - Recorded Calls
+
+    /// Returns the number of successful `create()` calls
+    std::size_t createCount() const noexcept;
+    /// Returns the number of successful `release()` calls
+    std::size_t releaseCount() const noexcept;
+    /// Returns the number of successful `setTimeout()` calls
+    std::size_t updateCount() const noexcept;
+    /// Returns the number of assertions that are currently held
+    std::size_t activeCount() const noexcept;
+
+    /// Records the latest calls up to the capacity, older ones are dropped.
+    /// Recording is off by default, a capacity of 0 turns it off again.
+    void setRecordedCallCapacity(std::size_t) noexcept;
+
+    /// Returns a copy of the recorded calls, oldest first
+    std::vector<Call> calls() const noexcept;
+
+    /// Discards all recorded calls and counters,
+    /// active assertions are kept.
+    void reset() noexcept;
+
+private:
+    struct Assertion
+    {
+        PowerAssertionID assertionID;
+        PowerAssertionType type;
+        /// Interned in `_names`
+        const std::string* name;
+        std::chrono::seconds timeout;
+    };
+
+    mutable std::mutex _mutex;
+    std::chrono::nanoseconds _latency { 0 };
+    bool _failing[2] = { false, false };
+    PowerAssertionID _nextAssertionID = 1;
+    /// Names are kept for the lifetime of the backend, so creating another
+    /// assertion with a known name does not allocate.
+    std::unordered_set<std::string> _names;
+    /// Unordered, released assertions are replaced by the last one,
+    /// so the storage is reused.
+    std::vector<Assertion> _assertions;
+    /// Reserved for the capacity, recording a call never allocates
+    std::vector<Call> _calls;
+    std::size_t _callCapacity = 0;
+    std::size_t _recordedCallCount = 0;
+    std::size_t _createCount = 0;
+    std::size_t _releaseCount = 0;
+    std::size_t _updateCount = 0;
+
+    void simulateLatency() const noexcept;
+    /// Must be called with `_mutex` held
+    void record(const Call&) noexcept;
+    std::vector<Assertion>::iterator find(PowerAssertionID) noexcept;
+};
+
+}
+
+#endif /* InMemoryPowerAssertionBackend_hpp */
@@ -0,0 +1,52 @@
+//
+//  InMemoryPowerSourceProvider.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef InMemoryPowerSourceProvider_hpp
+#define InMemoryPowerSourceProvider_hpp
+
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <Awaken/PowerSourceProvider.hpp>
+
+namespace Awaken
+{
+
+/// An in-process provider that reports a simulated power source
+/// for benchmarks and tests. Change handlers are called
+/// synchronously on the thread that updates the snapshot.
+class InMemoryPowerSourceProvider : public PowerSourceProvider
+{
+public:
+    
+#pragma mark - Provider
+    
+    PowerSourceSnapshot copySnapshot() noexcept override;
+    bool startObserving(std::function<void()>&& changeHandler) noexcept override;
+    void stopObserving() noexcept override;
+    
+#pragma mark - Simulation
+    
+    /// Replaces the simulated power source and
+    /// calls the change handler if observing.
+    void setSnapshot(const PowerSourceSnapshot&) noexcept;
+    
+    /// Returns the number of `copySnapshot()` calls
+    std::size_t copyCount() const noexcept;
+    
+private:
+    mutable std::mutex _mutex;
+    std::recursive_mutex _notificationMutex;
+    PowerSourceSnapshot _snapshot;
+    std::optional<std::function<void()>> _changeHandler;
+    std::size_t _copyCount = 0;
+};
+
+}
+
+#endif /* InMemoryPowerSourceProvider_hpp */
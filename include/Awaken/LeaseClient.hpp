@@ -0,0 +1,92 @@
+//
+//  LeaseClient.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef LeaseClient_hpp
+#define LeaseClient_hpp
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <Awaken/LeaseProtocol.hpp>
+
+namespace Awaken
+{
+
+/// Takes power assertion leases from a `LeaseServer`.
+///
+/// The convenience calls send a request and wait for its response.
+/// `send()` and `receive()` allow pipelining several requests before
+/// reading the responses, which arrive in request order.
+class LeaseClient
+{
+public:
+    using LeaseID = LeaseProtocol::LeaseID;
+
+#pragma mark - Life Cycle
+
+    LeaseClient() noexcept = default;
+    ~LeaseClient() noexcept;
+
+    LeaseClient(const LeaseClient&) = delete;
+    LeaseClient& operator=(const LeaseClient&) = delete;
+
+    LeaseClient(LeaseClient&&) noexcept;
+    LeaseClient& operator=(LeaseClient&&) noexcept;
+
+#pragma mark - Connection
+
+    /// Connects to the server, closing a previous connection.
+    /// The server releases all leases of a client when it disconnects.
+    /// @returns false if the server could not be reached
+    bool connect(const std::string& socketPath = LeaseProtocol::DefaultSocketPath()) noexcept;
+
+    /// Closes the connection, the server releases all of its leases
+    void disconnect() noexcept;
+
+    bool isConnected() const noexcept { return this->_fd >= 0; }
+
+#pragma mark - Leases
+
+    /// Takes a lease that prevents the assertion type until the duration passed.
+    /// @param owner Identifies the lease holder in the power assertion,
+    ///              truncated to `LeaseProtocol::MaximumOwnerLength` bytes
+    /// @returns the lease or nullopt if it could not be taken
+    std::optional<LeaseID> acquire(PowerAssertionType type, std::chrono::milliseconds duration, std::string_view owner) noexcept;
+
+    /// Moves the expiry of the lease to now plus the duration
+    /// @returns false if the lease already ended
+    bool renew(LeaseID lease, std::chrono::milliseconds duration) noexcept;
+
+    /// Ends the lease before it expires
+    /// @returns false if the lease already ended
+    bool release(LeaseID lease) noexcept;
+
+#pragma mark - Pipelining
+
+    /// Writes a request without waiting for its response
+    /// @returns false if the request could not be written
+    bool send(LeaseProtocol::Opcode opcode,
+              PowerAssertionType type,
+              LeaseID lease,
+              std::chrono::milliseconds duration,
+              std::string_view owner = {}) noexcept;
+
+    /// Waits for the response of the oldest unanswered request
+    /// @returns nullopt if the connection was closed
+    std::optional<LeaseProtocol::Response> receive() noexcept;
+
+private:
+    int _fd = -1;
+    std::vector<uint8_t> _request;
+};
+
+}
+
+#endif /* LeaseClient_hpp */
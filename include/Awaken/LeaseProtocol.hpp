@@ -0,0 +1,93 @@
+//
+//  LeaseProtocol.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef LeaseProtocol_hpp
+#define LeaseProtocol_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <Awaken/PowerAssertionBackend.hpp>
+
+/// The binary protocol spoken between `LeaseClient` and `LeaseServer`
+/// over a local Unix domain socket.
+///
+/// A client sends requests, each a fixed header followed by the owner
+/// name for `Acquire`. The server answers every request in order with
+/// a fixed response. All fields use the host byte order, both ends
+/// run on the same machine.
+namespace Awaken::LeaseProtocol
+{
+
+using LeaseID = uint32_t;
+
+/// Never assigned to a lease
+constexpr LeaseID InvalidLeaseID = 0;
+
+/// The maximum length of an owner name in bytes
+constexpr std::size_t MaximumOwnerLength = 64;
+
+/// The maximum duration of a single lease
+constexpr std::chrono::milliseconds MaximumDuration { UINT32_MAX };
+
+enum class Opcode : uint8_t
+{
+    /// Takes a new lease on the assertion type for the duration
+    Acquire = 1,
+    /// Moves the expiry of a lease to now plus the duration
+    Renew = 2,
+    /// Drops a lease before it expires
+    Release = 3,
+};
+
+enum class Status : uint8_t
+{
+    Ok = 0,
+    /// The power assertion could not be created
+    Failed = 1,
+    /// The lease expired, was released or belongs to another client
+    UnknownLease = 2,
+    /// The request could not be decoded, the server closes the connection
+    InvalidRequest = 3,
+};
+
+struct RequestHeader
+{
+    Opcode opcode;
+    PowerAssertionType type;
+    /// The number of owner bytes following the header
+    uint8_t ownerLength;
+    uint8_t reserved;
+    /// The lease to renew or release, ignored by `Acquire`
+    LeaseID lease;
+    uint32_t durationMilliseconds;
+};
+
+struct Response
+{
+    Opcode opcode;
+    Status status;
+    uint16_t reserved;
+    /// The new lease for `Acquire`, otherwise the requested lease
+    LeaseID lease;
+};
+
+static_assert(sizeof(RequestHeader) == 12 && std::is_trivially_copyable_v<RequestHeader>);
+static_assert(sizeof(Response) == 8 && std::is_trivially_copyable_v<Response>);
+
+/// The maximum size of an encoded request
+constexpr std::size_t MaximumRequestSize = sizeof(RequestHeader) + MaximumOwnerLength;
+
+/// Returns the socket path used if none is configured,
+/// `$XDG_RUNTIME_DIR/awakend.sock` or `/tmp/awakend-<uid>.sock`
+std::string DefaultSocketPath() noexcept;
+
+}
+
+#endif /* LeaseProtocol_hpp */
@@ -0,0 +1,163 @@
+//
+//  LeaseServer.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef LeaseServer_hpp
+#define LeaseServer_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <Awaken/LeaseProtocol.hpp>
+#include <Awaken/PowerAssertionRegistry.hpp>
+
+namespace Awaken
+{
+
+/// Serves power assertion leases to many clients over a Unix domain
+/// socket, see `LeaseProtocol` and `LeaseClient`.
+///
+/// All clients are multiplexed on the thread calling `run()` through
+/// epoll on Linux and kqueue on macOS. Leases of the same type are
+/// folded into a single registry reference, so one power assertion per
+/// type is held while any lease is active and released when the last
+/// lease expires, is released or its client disconnects.
+class LeaseServer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Counters describing the server state
+    struct Statistics
+    {
+        uint64_t clients = 0;
+        uint64_t leases = 0;
+        uint64_t acquisitions = 0;
+        uint64_t renewals = 0;
+        uint64_t releases = 0;
+        uint64_t expirations = 0;
+        uint64_t invalidRequests = 0;
+    };
+
+#pragma mark - Life Cycle
+
+    /// @param socketPath The path of the Unix domain socket
+    /// @param registry The registry used to hold the power assertions
+    explicit LeaseServer(std::string socketPath = LeaseProtocol::DefaultSocketPath(),
+                         std::shared_ptr<PowerAssertionRegistry> registry = PowerAssertionRegistry::shared()) noexcept;
+    ~LeaseServer() noexcept;
+
+    LeaseServer(const LeaseServer&) = delete;
+    LeaseServer& operator=(const LeaseServer&) = delete;
+
+    LeaseServer(LeaseServer&&) = delete;
+    LeaseServer& operator=(LeaseServer&&) = delete;
+
+#pragma mark - Running
+
+    /// Binds the socket, replacing a stale socket file at the path.
+    /// @returns false if the socket could not be bound
+    bool listen() noexcept;
+
+    /// Serves clients on the current thread until `stop()` is called,
+    /// all remaining leases are released before it returns.
+    /// @returns false if the server is not listening
+    bool run() noexcept;
+
+    /// Makes `run()` return, may be called from any thread
+    void stop() noexcept;
+
+    /// Returns a snapshot of the server counters, may be called from any thread
+    Statistics statistics() const noexcept;
+
+private:
+    using LeaseID = LeaseProtocol::LeaseID;
+
+    /// Pipelined requests are read in batches of this size
+    constexpr static std::size_t InputCapacity = 8 * LeaseProtocol::MaximumRequestSize;
+
+    /// Clients that stop reading their responses are disconnected
+    constexpr static std::size_t MaximumPendingOutput = 64 * 1024;
+
+    struct Client
+    {
+        int fd = -1;
+        std::array<uint8_t, InputCapacity> input {};
+        std::size_t inputLength = 0;
+        std::vector<uint8_t> output;
+        bool isWaitingForWritability = false;
+        std::vector<LeaseID> leases;
+    };
+
+    struct Lease
+    {
+        int client;
+        PowerAssertionType type;
+        Clock::time_point expiry;
+        std::string owner;
+    };
+
+    struct Expiry
+    {
+        Clock::time_point time;
+        LeaseID lease;
+
+        auto operator<=>(const Expiry&) const noexcept = default;
+    };
+
+    const std::string _socketPath;
+    std::shared_ptr<PowerAssertionRegistry> _registry;
+    std::array<PowerAssertionRegistry::Entry*, 2> _entries;
+
+    int _listenFD = -1;
+    int _eventFD = -1;
+    std::array<int, 2> _wakeFDs { -1, -1 };
+    std::atomic<bool> _stopping = false;
+
+    std::unordered_map<int, Client> _clients;
+    std::unordered_map<LeaseID, Lease> _leases;
+    /// One entry per lease, ordered by time
+    std::set<Expiry> _expiries;
+    LeaseID _lastLeaseID = LeaseProtocol::InvalidLeaseID;
+
+    std::atomic<uint64_t> _clientCount { 0 };
+    std::atomic<uint64_t> _leaseCount { 0 };
+    std::atomic<uint64_t> _acquisitions { 0 };
+    std::atomic<uint64_t> _renewals { 0 };
+    std::atomic<uint64_t> _releases { 0 };
+    std::atomic<uint64_t> _expirations { 0 };
+    std::atomic<uint64_t> _invalidRequests { 0 };
+
+    bool watch(int fd, bool writable) noexcept;
+    void unwatch(int fd) noexcept;
+
+    void acceptClients() noexcept;
+    /// @returns false if the client was closed
+    bool readClient(Client&) noexcept;
+    /// @returns false if the client was closed
+    bool writeClient(Client&) noexcept;
+    void closeClient(int fd) noexcept;
+
+    bool handleRequest(Client&, const LeaseProtocol::RequestHeader&, std::string_view owner) noexcept;
+    void respond(Client&, LeaseProtocol::Opcode, LeaseProtocol::Status, LeaseID) noexcept;
+
+    LeaseID nextLeaseID() noexcept;
+    void endLease(LeaseID) noexcept;
+    void expireLeases(Clock::time_point now) noexcept;
+    int timeoutUntilNextExpiry(Clock::time_point now) const noexcept;
+};
+
+}
+
+#endif /* LeaseServer_hpp */
@@ -0,0 +1,171 @@
+//
+//  Metrics.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef Metrics_hpp
+#define Metrics_hpp
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <Awaken/HoldAwaiter.hpp>
+#include <Awaken/PowerAssertionBackend.hpp>
+
+namespace Awaken
+{
+
+/// A monotonically increasing lock-free counter
+class Counter
+{
+public:
+    void increment(uint64_t amount = 1) noexcept { this->_value.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t value() const noexcept { return this->_value.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<uint64_t> _value { 0 };
+};
+
+/// A lock-free value that can go up and down
+class Gauge
+{
+public:
+    void increment() noexcept { this->_value.fetch_add(1, std::memory_order_relaxed); }
+    void decrement() noexcept { this->_value.fetch_sub(1, std::memory_order_relaxed); }
+    int64_t value() const noexcept { return this->_value.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<int64_t> _value { 0 };
+};
+
+/// A lock-free log-linear histogram of durations.
+///
+/// Each power of two is split into four linear buckets, so every
+/// bucket is at most 25 % wide, from nanoseconds up to centuries.
+class Histogram
+{
+public:
+    constexpr static unsigned SubBucketBits = 2;
+    constexpr static std::size_t SubBucketCount = std::size_t { 1 } << SubBucketBits;
+    constexpr static std::size_t GroupCount = 64 - SubBucketBits + 1;
+    constexpr static std::size_t BucketCount = GroupCount * SubBucketCount;
+    
+    /// A copy of the histogram at one point in time
+    struct Snapshot
+    {
+        std::array<uint64_t, BucketCount> counts {};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        
+        /// Returns the upper bound of the bucket containing the
+        /// fraction of all values, e.g. 0.99 for the 99th percentile
+        std::chrono::nanoseconds percentile(double fraction) const noexcept;
+    };
+    
+    void record(std::chrono::nanoseconds) noexcept;
+    
+    /// Copies the histogram without blocking concurrent recordings.
+    /// The counts may be off by recordings that happen while copying.
+    Snapshot snapshot() const noexcept;
+    
+    /// Returns the bucket index of the value in nanoseconds
+    static std::size_t bucketIndex(uint64_t value) noexcept;
+    /// Returns the largest value in nanoseconds of the bucket
+    static uint64_t bucketUpperBound(std::size_t index) noexcept;
+    
+private:
+    std::array<std::atomic<uint64_t>, BucketCount> _counts {};
+    std::atomic<uint64_t> _count { 0 };
+    std::atomic<uint64_t> _sum { 0 };
+};
+
+/// The number of `HoldEndReason` values
+constexpr std::size_t HoldEndReasonCount = 4;
+/// The number of `PowerAssertionType` values
+constexpr std::size_t PowerAssertionTypeCount = 2;
+
+/// Metrics of the sessions of one `Awaken` instance, or all of them
+struct SessionMetrics
+{
+    /// Sessions started with `run()`
+    Counter started;
+    /// Sessions that are currently running
+    Gauge active;
+    /// Sessions that ended, indexed by `HoldEndReason`
+    std::array<Counter, HoldEndReasonCount> ended;
+    /// How long sessions were running
+    Histogram holdDuration;
+    /// How late the waiter handler was called after the
+    /// deadline was reached or the session was cancelled
+    Histogram handlerLatency;
+    
+    Counter& endedCounter(HoldEndReason reason) noexcept { return this->ended[static_cast<std::size_t>(reason)]; }
+};
+
+/// Metrics of the work items run by one `WorkerPoolExecutor`, or all of them
+struct ExecutorMetrics
+{
+    /// Work items that were run
+    Counter executed;
+    /// Work items run on the scheduling thread because the queue was full
+    Counter overflows;
+    /// How long work items waited in the queue
+    Histogram queueLatency;
+    /// How long work items ran, e.g. to find slow handlers
+    Histogram runDuration;
+};
+
+/// Process-wide runtime metrics. All values are updated with relaxed
+/// atomics and can be read at any time without stopping sessions.
+class Metrics
+{
+public:
+    /// Returns the process-wide metrics
+    static Metrics& shared() noexcept;
+    
+    /// Backend calls and held assertions of one assertion type
+    struct AssertionMetrics
+    {
+        /// Backend assertions that are currently held
+        Gauge held;
+        Counter creates;
+        Counter releases;
+        Counter updates;
+        Counter failures;
+    };
+    
+    /// All sessions of the process
+    SessionMetrics sessions;
+    /// Indexed by `PowerAssertionType`
+    std::array<AssertionMetrics, PowerAssertionTypeCount> assertions;
+    
+    /// @name Wakeups
+    /// Counts the thread wakeups caused by the library
+    /// @{
+    Counter threadWaiterWakeups;
+    Counter timerWheelWakeups;
+    Counter powerSourceNotifications;
+    Counter powerSourcePolls;
+    /// @}
+    
+    /// Heartbeat leases that ended because their owner stopped renewing them
+    Counter missedHeartbeats;
+    
+    /// All work items run by worker pool executors
+    ExecutorMetrics executors;
+    
+    AssertionMetrics& assertion(PowerAssertionType type) noexcept { return this->assertions[static_cast<std::size_t>(type)]; }
+    
+    /// Returns all metrics in the Prometheus text exposition format
+    std::string prometheusText() const;
+};
+
+}
+
+#endif /* Metrics_hpp */
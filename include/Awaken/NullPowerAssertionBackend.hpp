@@ -0,0 +1,36 @@
+//
+//  NullPowerAssertionBackend.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef NullPowerAssertionBackend_hpp
+#define NullPowerAssertionBackend_hpp
+
+#include <atomic>
+#include <Awaken/PowerAssertionBackend.hpp>
+
+namespace Awaken
+{
+
+/// A backend for platforms without power assertions. Every call
+/// succeeds without holding anything, nothing is recorded, so it
+/// neither allocates nor grows in long-running processes.
+class NullPowerAssertionBackend : public PowerAssertionBackend
+{
+public:
+    std::optional<PowerAssertionID> create(PowerAssertionType type,
+                                           const std::string& name,
+                                           std::chrono::seconds timeout) noexcept override;
+    bool release(PowerAssertionID) noexcept override;
+    bool setTimeout(PowerAssertionID, std::chrono::seconds) noexcept override;
+
+private:
+    std::atomic<PowerAssertionID> _nextAssertionID { 1 };
+};
+
+}
+
+#endif /* NullPowerAssertionBackend_hpp */
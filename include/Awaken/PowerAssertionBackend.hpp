@@ -0,0 +1,65 @@
+//
+//  PowerAssertionBackend.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef PowerAssertionBackend_hpp
+#define PowerAssertionBackend_hpp
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace Awaken
+{
+
+/// The kinds of power assertions a backend can hold
+enum class PowerAssertionType : uint8_t
+{
+    PreventUserIdleSystemSleep,
+    PreventUserIdleDisplaySleep,
+};
+
+/// Identifies a power assertion created by a backend
+using PowerAssertionID = uint32_t;
+
+/// Creates and releases the actual power assertions,
+/// e.g. through IOKit on macOS.
+class PowerAssertionBackend
+{
+public:
+    virtual ~PowerAssertionBackend() = default;
+
+    /// Returns the shared backend for the current platform.
+    /// This is the IOKit backend on macOS and a null
+    /// backend on platforms without power assertions.
+    static std::shared_ptr<PowerAssertionBackend> systemDefault() noexcept;
+
+    /// Creates a power assertion.
+    /// @param type The assertion type
+    /// @param name The assertion name used in system logs
+    /// @param timeout The assertion timeout or InfiniteTimeout
+    /// @returns the assertion ID or nullopt if the assertion could not be created
+    virtual std::optional<PowerAssertionID> create(PowerAssertionType type,
+                                                   const std::string& name,
+                                                   std::chrono::seconds timeout) noexcept = 0;
+
+    /// Releases a power assertion created with `create()`.
+    /// @returns false if the assertion could not be released
+    virtual bool release(PowerAssertionID) noexcept = 0;
+    
+    /// Updates the timeout of a power assertion in place,
+    /// the new timeout starts when it is set.
+    /// @returns false if the timeout could not be updated or
+    ///          the backend does not support timeout updates
+    virtual bool setTimeout(PowerAssertionID, std::chrono::seconds) noexcept { return false; }
+};
+
+}
+
+#endif /* PowerAssertionBackend_hpp */
@@ -0,0 +1,176 @@
+//
+//  PowerAssertionRegistry.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef PowerAssertionRegistry_hpp
+#define PowerAssertionRegistry_hpp
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include <Awaken/PowerAssertionBackend.hpp>
+#include <Awaken/TimerWheel.hpp>
+
+namespace Awaken
+{
+
+/// Coalesces power assertions of all sessions in the process.
+///
+/// The registry keeps at most one backend assertion per type and timeout.
+/// Sessions share it through a reference count: only the first acquire
+/// creates the backend assertion and only the last release releases it,
+/// every other acquire and release is a lock-free atomic update.
+///
+/// A release can linger: the backend assertion is kept for a grace
+/// period after the last reference is dropped, an acquire within that
+/// period re-attaches to it without calling the backend.
+///
+/// Every session gets the full backend timeout of its entry: a session
+/// that joins a timed assertion extends it to `now + timeout`, which only
+/// calls the backend if the assertion would expire before that.
+class PowerAssertionRegistry
+{
+public:
+
+    /// A shared assertion for one type and timeout.
+    /// Entries are owned by the registry and live as long as it does,
+    /// an entry that is no longer used may be reused for another key.
+    class Entry
+    {
+    public:
+        Entry(PowerAssertionRegistry& registry, PowerAssertionType type, std::chrono::seconds timeout) noexcept;
+
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+
+        PowerAssertionType type() const noexcept { return this->_type; }
+        std::chrono::seconds timeout() const noexcept { return this->_timeout; }
+
+        /// Returns the number of sessions holding the assertion
+        uint32_t references() const noexcept { return this->_references.load(std::memory_order_relaxed); }
+
+    private:
+        friend class PowerAssertionRegistry;
+
+        /// Only changed while the entry is unused, see `entry()`
+        PowerAssertionType _type;
+        std::chrono::seconds _timeout;
+        /// The callers of `entry()` that did not `forget()` it yet,
+        /// guarded by the registry's entries mutex
+        uint32_t _users = 0;
+        std::atomic<uint32_t> _references { 0 };
+        std::mutex _mutex;
+        std::optional<PowerAssertionID> _assertionID;
+        std::atomic<TimerWheel::Clock::rep> _backendExpiry { 0 };
+        std::optional<TimerWheel::Clock::time_point> _lingerDeadline;
+        TimerWheel::Timer _lingerTimer;
+    };
+
+    /// Counters describing how many calls reached the backend
+    struct Statistics
+    {
+        uint64_t acquisitions = 0;
+        uint64_t releases = 0;
+        uint64_t backendCreates = 0;
+        uint64_t backendReleases = 0;
+        uint64_t backendUpdates = 0;
+        uint64_t backendFailures = 0;
+        /// Acquisitions that re-attached to a lingering assertion
+        uint64_t lingerReattachments = 0;
+        /// Backend creates and releases saved by lingering
+        uint64_t avoidedBackendCalls = 0;
+        /// The entries kept by the registry, used or not
+        uint64_t entries = 0;
+    };
+
+#pragma mark - Life Cycle
+
+    /// Returns the process-wide registry for the system default backend
+    static std::shared_ptr<PowerAssertionRegistry> shared() noexcept;
+
+    /// Returns the process-wide registry for the given backend,
+    /// all sessions using the same backend share one registry.
+    static std::shared_ptr<PowerAssertionRegistry> forBackend(const std::shared_ptr<PowerAssertionBackend>&) noexcept;
+
+    explicit PowerAssertionRegistry(std::shared_ptr<PowerAssertionBackend> backend) noexcept;
+    ~PowerAssertionRegistry() noexcept;
+
+    PowerAssertionRegistry(const PowerAssertionRegistry&) = delete;
+    PowerAssertionRegistry& operator=(const PowerAssertionRegistry&) = delete;
+
+#pragma mark - Entries
+
+    /// Returns the entry for the type and timeout, creating it if needed.
+    /// Callers should keep the returned reference instead of looking it up
+    /// again and pass it to `forget()` once they no longer use it.
+    Entry& entry(PowerAssertionType type, std::chrono::seconds timeout) noexcept;
+
+    /// Gives up an entry returned by `entry()`. Once no caller uses it and
+    /// its backend assertion was released, it is reused for the next key
+    /// that has no entry, so varying timeouts do not grow the registry.
+    void forget(Entry&) noexcept;
+
+    /// Takes a reference on the entry, creating the backend assertion if
+    /// this is the first reference or extending a timed one for the session.
+    /// @param name The assertion name used if the backend assertion is created
+    /// @returns false if the backend assertion could not be created or extended
+    bool acquire(Entry&, const std::string& name) noexcept;
+
+    /// Drops a reference on the entry, releasing the backend
+    /// assertion if this was the last reference.
+    /// @param linger The grace period to keep the backend assertion
+    ///               after the last reference is dropped
+    void release(Entry&, std::chrono::milliseconds linger = std::chrono::milliseconds { 0 }) noexcept;
+
+    /// Makes sure the backend assertion of a held entry does not time
+    /// out before the deadline, extending its timeout in place if needed.
+    /// Shortening is left to the session's waiter, a shared backend
+    /// assertion is never cut short for other sessions.
+    /// @returns false if the backend assertion could not be extended
+    bool extend(Entry&, TimerWheel::Clock::time_point deadline) noexcept;
+
+#pragma mark - Statistics
+
+    /// Returns a snapshot of the registry counters
+    Statistics statistics() const noexcept;
+
+private:
+    std::shared_ptr<PowerAssertionBackend> _backend;
+    mutable std::mutex _entriesMutex;
+    std::map<std::pair<PowerAssertionType, std::chrono::seconds::rep>, std::unique_ptr<Entry>> _entries;
+    /// Entries without users, they are reused once idle
+    std::vector<Entry*> _unusedEntries;
+
+    std::atomic<uint64_t> _acquisitions { 0 };
+    std::atomic<uint64_t> _releases { 0 };
+    std::atomic<uint64_t> _backendCreates { 0 };
+    std::atomic<uint64_t> _backendReleases { 0 };
+    std::atomic<uint64_t> _backendUpdates { 0 };
+    std::atomic<uint64_t> _backendFailures { 0 };
+    std::atomic<uint64_t> _lingerReattachments { 0 };
+
+    enum class Reference { Failed, Created, Joined };
+
+    /// Takes a reference on the entry without extending a joined assertion
+    Reference reference(Entry&, const std::string& name) noexcept;
+    /// Re-keys an unused entry whose backend assertion was released,
+    /// must be called with `_entriesMutex` held
+    Entry* reuseEntry(PowerAssertionType, std::chrono::seconds timeout) noexcept;
+    void releaseBackendAssertion(Entry&) noexcept;
+    void lingerDidExpire(Entry&) noexcept;
+};
+
+}
+
+#endif /* PowerAssertionRegistry_hpp */
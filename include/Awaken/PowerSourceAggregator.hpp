@@ -0,0 +1,68 @@
+//
+//  PowerSourceAggregator.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef PowerSourceAggregator_hpp
+#define PowerSourceAggregator_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <Awaken/PowerSourceSnapshot.hpp>
+
+namespace Awaken
+{
+
+/// Combines the individual power sources of consecutive snapshots into
+/// a single aggregate.
+///
+/// The capacity is weighted by the energy of each source when all
+/// matching sources report one, otherwise every source counts equally.
+/// Running totals are kept, an update only re-accumulates the sources
+/// that differ from the previous snapshot.
+class PowerSourceAggregator
+{
+public:
+    explicit PowerSourceAggregator(PowerSourceFilter filter = PowerSourceFilter::InternalBattery) noexcept;
+    
+    /// Returns the filter selecting the aggregated sources
+    PowerSourceFilter filter() const noexcept;
+    
+    /// Replaces the filter and recomputes the aggregate from all sources.
+    void setFilter(PowerSourceFilter) noexcept;
+    
+    /// Updates the aggregate with the sources of a newly copied snapshot.
+    /// @returns the number of sources that changed
+    std::size_t update(const PowerSourceSnapshot&) noexcept;
+    
+    /// Returns the latest sources with the aggregate fields filled in.
+    PowerSourceSnapshot snapshot() const noexcept;
+    
+private:
+    struct Totals
+    {
+        double energyWeightedCapacity = 0;
+        double energy = 0;
+        double capacity = 0;
+        int64_t minutesRemaining = 0;
+        int32_t count = 0;
+        int32_t countWithoutEnergy = 0;
+        int32_t countWithoutTimeRemaining = 0;
+        int32_t chargingCount = 0;
+        int32_t batteryCount = 0;
+        int32_t upsCount = 0;
+    };
+    
+    PowerSourceFilter _filter;
+    PowerSourceSnapshot _snapshot;
+    Totals _totals;
+    
+    void accumulate(const PowerSourceSnapshot::Source&, int sign) noexcept;
+};
+
+}
+
+#endif /* PowerSourceAggregator_hpp */
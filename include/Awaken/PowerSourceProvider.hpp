@@ -0,0 +1,47 @@
+//
+//  PowerSourceProvider.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef PowerSourceProvider_hpp
+#define PowerSourceProvider_hpp
+
+#include <functional>
+#include <memory>
+#include <Awaken/PowerSourceSnapshot.hpp>
+
+namespace Awaken
+{
+
+/// Reads the device power sources and reports changes,
+/// e.g. through IOKit on macOS.
+class PowerSourceProvider
+{
+public:
+    virtual ~PowerSourceProvider() = default;
+
+    /// Returns a new provider for the current platform.
+    /// This is the IOKit provider on macOS, the sysfs provider on
+    /// Linux and an in-memory provider without any power source elsewhere.
+    static std::shared_ptr<PowerSourceProvider> systemDefault() noexcept;
+
+    /// Reads and decodes the current power source description.
+    virtual PowerSourceSnapshot copySnapshot() noexcept = 0;
+
+    /// Starts calling the handler on a private thread or queue
+    /// whenever the power sources change.
+    /// @returns false if already observing or change
+    ///          notifications are not supported
+    virtual bool startObserving(std::function<void()>&& changeHandler) noexcept = 0;
+
+    /// Stops calling the change handler, a handler that is
+    /// currently being called will finish first.
+    virtual void stopObserving() noexcept = 0;
+};
+
+}
+
+#endif /* PowerSourceProvider_hpp */
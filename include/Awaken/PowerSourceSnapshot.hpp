@@ -0,0 +1,115 @@
+//
+//  PowerSourceSnapshot.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef PowerSourceSnapshot_hpp
+#define PowerSourceSnapshot_hpp
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace Awaken
+{
+
+/// Selects the power sources that contribute to an aggregate.
+enum class PowerSourceFilter : uint8_t
+{
+    /// Only batteries built into the device
+    InternalBattery,
+    /// Only uninterruptible power supplies
+    UPS,
+    /// Every power source reporting a capacity
+    All,
+};
+
+/// A decoded description of the device power sources at one point in time.
+///
+/// The individual sources are stored inline, so a snapshot stays
+/// trivially copyable. The top-level fields describe the aggregate
+/// of all sources matching a `PowerSourceFilter`.
+struct PowerSourceSnapshot
+{
+    /// A capacity value representing the unavailability
+    /// of a power source capacity.
+    constexpr static float CapacityUnavailable = -1.0;
+    
+    /// The maximum number of individually tracked power sources
+    constexpr static std::size_t MaximumSourceCount = 8;
+
+    /// The kind of the power source
+    enum class Type : uint8_t
+    {
+        Unknown,
+        InternalBattery,
+        UPS,
+    };
+    
+    /// A single power source
+    struct Source
+    {
+        /// A stable identifier of the power source
+        uint32_t identifier = 0;
+        /// The kind of the power source
+        Type type = Type::Unknown;
+        /// The capacity in percent or `CapacityUnavailable`
+        float capacity = CapacityUnavailable;
+        /// The energy in watt-hours when fully charged or 0 if unknown
+        float energyCapacity = 0;
+        /// True if the power source is currently charging
+        bool isCharging = false;
+        /// The estimated time until the power source is empty, if known
+        std::optional<std::chrono::minutes> timeRemaining = std::nullopt;
+        
+        /// Returns true if the source contributes to an aggregate with the filter.
+        bool matches(PowerSourceFilter filter) const noexcept
+        {
+            if(this->capacity == CapacityUnavailable) { return false; }
+            
+            switch(filter)
+            {
+                case PowerSourceFilter::InternalBattery: return this->type == Type::InternalBattery;
+                case PowerSourceFilter::UPS: return this->type == Type::UPS;
+                case PowerSourceFilter::All: return true;
+            }
+            return false;
+        }
+        
+        bool operator==(const Source&) const noexcept = default;
+    };
+
+    /// The kind of the matching power sources, a built-in battery
+    /// takes precedence over a UPS
+    Type type = Type::Unknown;
+    /// The aggregate capacity in percent or `CapacityUnavailable`
+    float capacity = CapacityUnavailable;
+    /// True if any matching power source is currently charging
+    bool isCharging = false;
+    /// The estimated time until all matching power sources are empty, if known
+    std::optional<std::chrono::minutes> timeRemaining = std::nullopt;
+    /// The number of power sources attached to the device,
+    /// at most `MaximumSourceCount` are stored in `sources`
+    uint32_t sourceCount = 0;
+    /// The individual power sources
+    std::array<Source, MaximumSourceCount> sources {};
+
+    /// Returns true if the power source is a built-in battery.
+    bool hasBattery() const noexcept { return this->type == Type::InternalBattery; }
+    
+    /// Returns the number of sources stored in `sources`
+    std::size_t storedSourceCount() const noexcept
+    {
+        return std::min<std::size_t>(this->sourceCount, MaximumSourceCount);
+    }
+};
+
+}
+
+#endif /* PowerSourceSnapshot_hpp */
@@ -0,0 +1,86 @@
+//
+//  ProcessWaiter.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef ProcessWaiter_hpp
+#define ProcessWaiter_hpp
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/types.h>
+#include <Awaken/Executor.hpp>
+#include <Awaken/Waiter.hpp>
+
+namespace Awaken
+{
+
+/// A waiter that finishes once all of its processes have exited,
+/// like `caffeinate -w`, or when its timeout is reached.
+///
+/// A private thread blocks on pidfds in epoll on Linux and on kqueue
+/// `EVFILT_PROC` events on macOS, it only wakes up when a process exits,
+/// the deadline is reached or the waiter is cancelled. Processes that
+/// already exited when the waiter is run count as exited.
+///
+/// The thread and its event queue are created by the first run and reused
+/// by all following runs. The timeout handler is called through the
+/// executor, a handler of a previous run that was not called yet is
+/// dropped by the next run.
+class ProcessWaiter : public Waiter
+{
+public:
+
+#pragma mark - Life Cycle
+
+    /// @param processes The processes to wait for
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    explicit ProcessWaiter(std::vector<pid_t> processes = {},
+                           Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    ~ProcessWaiter() noexcept;
+
+    ProcessWaiter(const ProcessWaiter&) = delete;
+    ProcessWaiter& operator=(const ProcessWaiter&) = delete;
+
+    ProcessWaiter(ProcessWaiter&&) = delete;
+    ProcessWaiter& operator=(ProcessWaiter&&) = delete;
+
+#pragma mark - Properties
+
+    /// Sets the processes to wait for, used by the next run.
+    /// Duplicates are waited for once, `processes()` returns them sorted.
+    void setProcesses(std::vector<pid_t>) noexcept;
+    std::vector<pid_t> processes() const noexcept;
+
+    /// Sets a timeout in addition to the processes, 0 waits until they exited
+    void setTimeout(std::chrono::seconds) noexcept override;
+    void setTimeoutHandler(std::function<void()>&&) noexcept override;
+
+#pragma mark - Running
+
+    bool isRunning() const noexcept override;
+    bool run() noexcept override;
+    bool cancel() noexcept override;
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
+
+private:
+    struct State;
+
+    std::chrono::seconds _timeout { 0 };
+    /// Shared with the thread, which outlives the waiter
+    /// if the waiter is destroyed from its own thread
+    std::shared_ptr<State> _state;
+    std::thread _thread;
+
+    static void wait(State&) noexcept;
+};
+
+}
+
+#endif /* ProcessWaiter_hpp */
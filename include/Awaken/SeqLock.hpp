@@ -0,0 +1,97 @@
+//
+//  SeqLock.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef SeqLock_hpp
+#define SeqLock_hpp
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace Awaken
+{
+
+/// Stores a small trivially copyable value that is written rarely
+/// and read often. Readers never block writers and never take a lock,
+/// they retry if a write happened while they were copying the value.
+template<typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values must be trivially copyable");
+
+public:
+    SeqLock() noexcept : SeqLock(T {}) {}
+    explicit SeqLock(const T& value) noexcept { this->store(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// Returns a consistent copy of the stored value
+    T load() const noexcept
+    {
+        Words words;
+        uint64_t sequence = 0;
+        do {
+            sequence = this->_sequence.load(std::memory_order_acquire);
+            while(sequence & 1)
+            {
+                std::this_thread::yield();
+                sequence = this->_sequence.load(std::memory_order_acquire);
+            }
+
+            for(std::size_t index = 0; index < WordCount; index++)
+            {
+                words[index] = this->_words[index].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while(this->_sequence.load(std::memory_order_relaxed) != sequence);
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    /// Replaces the stored value, concurrent writers are serialized
+    void store(const T& value) noexcept
+    {
+        Words words {};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        auto sequence = this->_sequence.load(std::memory_order_relaxed);
+        do {
+            while(sequence & 1)
+            {
+                std::this_thread::yield();
+                sequence = this->_sequence.load(std::memory_order_relaxed);
+            }
+        } while(!this->_sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                        std::memory_order_acquire,
+                                                        std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for(std::size_t index = 0; index < WordCount; index++)
+        {
+            this->_words[index].store(words[index], std::memory_order_relaxed);
+        }
+        this->_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    constexpr static std::size_t WordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    using Words = std::array<uint64_t, WordCount>;
+
+    std::atomic<uint64_t> _sequence { 0 };
+    std::array<std::atomic<uint64_t>, WordCount> _words {};
+};
+
+}
+
+#endif /* SeqLock_hpp */
@@ -0,0 +1,323 @@
+//
+//  SessionPool.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef SessionPool_hpp
+#define SessionPool_hpp
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <Awaken/HandlerList.hpp>
+#include <Awaken/HoldAwaiter.hpp>
+
+namespace Awaken
+{
+
+/// Identifies a session acquired from a `SessionPool`.
+///
+/// A handle is two words that may be copied, stored in contiguous
+/// containers and captured by handlers. It becomes invalid when the
+/// session is released, also once the slot is used by another session.
+class SessionHandle
+{
+public:
+    /// An empty handle, it never resolves to a session
+    SessionHandle() noexcept = default;
+
+    uint32_t index() const noexcept { return this->_index; }
+    uint32_t generation() const noexcept { return this->_generation; }
+    explicit operator bool() const noexcept { return this->_generation != 0; }
+    bool operator==(const SessionHandle&) const noexcept = default;
+
+private:
+    template<typename Session> friend class SessionPool;
+
+    SessionHandle(uint32_t index, uint32_t generation) noexcept
+        : _index(index), _generation(generation) {}
+
+    uint32_t _index = 0;
+    uint32_t _generation = 0;
+};
+
+/// Keeps many sessions, e.g. `Awaken` or a `BasicAwaken`, in slots that
+/// are recycled between jobs and hands out generation-checked handles.
+///
+/// Slots live in blocks that double in size and are never moved, so the
+/// handlers sessions register with their components stay valid. A slot
+/// constructs its session the first time it is acquired and keeps it
+/// when it is released, with its configuration, for the next job.
+/// Acquiring and releasing a slot only allocates when the pool grows.
+///
+/// Handles are resolved with `visit()`, which checks the generation and
+/// keeps the session acquired while the function runs. Handlers should
+/// capture a handle instead of a session, a stale handle is rejected.
+/// Session ends are reported with the handle to `subscribeToEnd()`.
+template<typename Session>
+class SessionPool
+{
+public:
+    /// The number of slots of the first block
+    constexpr static std::size_t BlockSize = 64;
+
+#pragma mark - Life Cycle
+
+    /// Creates an empty pool that constructs its sessions from
+    /// copies of the arguments, e.g. a name and a backend.
+    template<typename... Arguments>
+    explicit SessionPool(Arguments... arguments) noexcept
+        : _construct([arguments...](void* storage) {
+            return new (storage) Session(arguments...);
+        })
+    {
+    }
+
+    /// Destroys all sessions, running ones are cancelled
+    ~SessionPool() noexcept
+    {
+        for(std::size_t index = 0; index < this->_slotCount; index++)
+        {
+            auto& slot = *this->slot(static_cast<uint32_t>(index));
+            const auto generation = slot.generation.load(std::memory_order_relaxed);
+            slot.generation.store((generation | 1) + 1, std::memory_order_seq_cst);
+            slot.waitForVisitors();
+            slot.session()->~Session();
+        }
+
+        for(auto& block : this->_blocks)
+        {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    SessionPool(SessionPool&&) = delete;
+    SessionPool& operator=(SessionPool&&) = delete;
+
+#pragma mark - Slots
+
+    /// Acquires an idle session, a new one is constructed if none is left.
+    /// The session keeps the configuration of its previous job.
+    /// @returns the handle of the session or an empty handle if the pool is full
+    SessionHandle acquire() noexcept
+    {
+        std::lock_guard lock { this->_mutex };
+
+        uint32_t index = 0;
+        if(!this->_idleIndices.empty())
+        {
+            index = this->_idleIndices.back();
+            this->_idleIndices.pop_back();
+        }
+        else if(auto slot = this->makeSlot())
+        {
+            index = *slot;
+        }
+        else
+        {
+            return SessionHandle {};
+        }
+
+        // Odd generations are acquired, even ones idle.
+        auto& slot = *this->slot(index);
+        const auto generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_seq_cst);
+        this->_size++;
+        return SessionHandle(index, generation);
+    }
+
+    /// Cancels the session and returns its slot to the pool, the handle
+    /// and all of its copies become invalid. Waits for the functions
+    /// visiting the session, so it must not be called from within one.
+    /// @returns false if the handle is invalid
+    bool release(SessionHandle handle) noexcept
+    {
+        auto slot = this->slot(handle);
+        if(slot == nullptr) { return false; }
+
+        auto generation = handle.generation();
+        if(!slot->generation.compare_exchange_strong(generation, generation + 1, std::memory_order_seq_cst))
+        {
+            return false;
+        }
+
+        // The session ended by cancelling is not reported,
+        // its handle is no longer valid.
+        slot->waitForVisitors();
+        slot->session()->cancel();
+
+        std::lock_guard lock { this->_mutex };
+        this->_idleIndices.push_back(handle.index());
+        this->_size--;
+        return true;
+    }
+
+    /// Returns true if the handle refers to an acquired session
+    bool contains(SessionHandle handle) const noexcept
+    {
+        const auto slot = this->slot(handle);
+        return slot != nullptr && slot->generation.load(std::memory_order_acquire) == handle.generation();
+    }
+
+    /// Calls the function with the session of the handle on the current thread,
+    /// the session is not released before it returns. May be called from any
+    /// thread, it neither allocates nor locks.
+    /// @returns false if the handle is invalid and the function was not called
+    template<typename Function>
+    bool visit(SessionHandle handle, Function&& function) noexcept
+    {
+        auto slot = this->slot(handle);
+        if(slot == nullptr) { return false; }
+
+        // Pairs with the generation change and visitor count check in
+        // `release()`, one of both threads sees the other's write.
+        slot->visitors.fetch_add(1, std::memory_order_seq_cst);
+        const bool isValid = slot->generation.load(std::memory_order_seq_cst) == handle.generation();
+        if(isValid)
+        {
+            std::forward<Function>(function)(*slot->session());
+        }
+        if(slot->visitors.fetch_sub(1, std::memory_order_release) == 1)
+        {
+            slot->visitors.notify_all();
+        }
+        return isValid;
+    }
+
+    /// Returns the number of acquired sessions
+    std::size_t size() const noexcept
+    {
+        std::lock_guard lock { this->_mutex };
+        return this->_size;
+    }
+
+    /// Returns the number of constructed sessions, acquired or idle
+    std::size_t capacity() const noexcept
+    {
+        std::lock_guard lock { this->_mutex };
+        return this->_slotCount;
+    }
+
+#pragma mark - Subscriptions
+
+    /// Adds a handler that will be called with the handle and the reason
+    /// whenever an acquired session ends, on the thread that ended it.
+    /// Sessions ended by `release()` are not reported. The handler may
+    /// release the session to recycle its slot, other threads may release
+    /// it concurrently, so it is resolved with `visit()`.
+    /// @returns the subscription to remove the handler with `unsubscribe()`
+    Subscription subscribeToEnd(std::function<void(SessionHandle, HoldEndReason)>&& handler) noexcept
+    {
+        return this->_endHandlers.subscribe(std::move(handler));
+    }
+
+    /// Removes a handler added with `subscribeToEnd()`
+    /// @returns false if the subscription is unknown
+    bool unsubscribe(Subscription subscription) noexcept
+    {
+        return this->_endHandlers.unsubscribe(subscription);
+    }
+
+private:
+    /// Block `n` holds `BlockSize << n` slots, which covers all 32 bit indices
+    constexpr static std::size_t MaximumBlockCount = 26;
+
+    struct Slot
+    {
+        std::atomic<uint32_t> generation { 0 };
+        std::atomic<uint32_t> visitors { 0 };
+        alignas(Session) std::byte storage[sizeof(Session)];
+
+        Session* session() noexcept { return std::launder(reinterpret_cast<Session*>(this->storage)); }
+
+        void waitForVisitors() noexcept
+        {
+            auto visitors = this->visitors.load(std::memory_order_seq_cst);
+            while(visitors != 0)
+            {
+                this->visitors.wait(visitors, std::memory_order_acquire);
+                visitors = this->visitors.load(std::memory_order_acquire);
+            }
+        }
+    };
+
+    const std::function<Session*(void*)> _construct;
+    HandlerList<SessionHandle, HoldEndReason> _endHandlers;
+
+    std::array<std::atomic<Slot*>, MaximumBlockCount> _blocks {};
+    mutable std::mutex _mutex;
+    std::size_t _slotCount = 0;
+    std::size_t _size = 0;
+    /// Reserved for all slots of the allocated blocks, releasing never allocates
+    std::vector<uint32_t> _idleIndices;
+
+    static std::pair<std::size_t, std::size_t> locate(uint32_t index) noexcept
+    {
+        const auto block = static_cast<std::size_t>(std::bit_width(index / BlockSize + 1) - 1);
+        return { block, index - BlockSize * ((std::size_t { 1 } << block) - 1) };
+    }
+
+    Slot* slot(uint32_t index) const noexcept
+    {
+        const auto [block, offset] = locate(index);
+        if(block >= MaximumBlockCount) { return nullptr; }
+
+        const auto slots = this->_blocks[block].load(std::memory_order_acquire);
+        return slots != nullptr ? &slots[offset] : nullptr;
+    }
+
+    /// Returns the slot of a handle, only a valid handle can still match its generation
+    Slot* slot(SessionHandle handle) const noexcept
+    {
+        return handle ? this->slot(handle.index()) : nullptr;
+    }
+
+    /// Constructs the session of the next unused slot, must be called with `_mutex` held
+    std::optional<uint32_t> makeSlot() noexcept
+    {
+        const auto index = static_cast<uint32_t>(this->_slotCount);
+        const auto [block, offset] = locate(index);
+        if(block >= MaximumBlockCount) { return std::nullopt; }
+
+        if(offset == 0)
+        {
+            const auto slotCount = BlockSize << block;
+            this->_idleIndices.reserve(this->_slotCount + slotCount);
+            this->_blocks[block].store(new Slot[slotCount], std::memory_order_release);
+        }
+
+        auto session = this->_construct(this->slot(index)->storage);
+        session->subscribeToEnd([this, index](HoldEndReason reason) {
+            this->sessionDidEnd(index, reason);
+        });
+        this->_slotCount++;
+        return index;
+    }
+
+    void sessionDidEnd(uint32_t index, HoldEndReason reason) const noexcept
+    {
+        const auto generation = this->slot(index)->generation.load(std::memory_order_acquire);
+        if(generation % 2 == 1)
+        {
+            this->_endHandlers(SessionHandle(index, generation), reason);
+        }
+    }
+};
+
+}
+
+#endif /* SessionPool_hpp */
@@ -0,0 +1,64 @@
+//
+//  SysfsPowerSourceProvider.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef SysfsPowerSourceProvider_hpp
+#define SysfsPowerSourceProvider_hpp
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <Awaken/PowerSourceProvider.hpp>
+
+namespace Awaken
+{
+
+/// Reads power sources from the Linux sysfs power_supply class.
+///
+/// Changes are observed through kernel power_supply uevents and
+/// inotify on the sysfs tree, the provider never polls. The root
+/// directory is configurable so a fake directory tree can drive it.
+class SysfsPowerSourceProvider : public PowerSourceProvider
+{
+public:
+    
+    /// The sysfs directory of the power_supply class
+    static const std::filesystem::path DefaultRoot;
+    
+#pragma mark - Life Cycle
+    
+    /// @param root The directory containing one directory per power supply
+    explicit SysfsPowerSourceProvider(std::filesystem::path root = DefaultRoot) noexcept;
+    ~SysfsPowerSourceProvider() noexcept;
+    
+    SysfsPowerSourceProvider(const SysfsPowerSourceProvider&) = delete;
+    SysfsPowerSourceProvider& operator=(const SysfsPowerSourceProvider&) = delete;
+    
+#pragma mark - Provider
+    
+    PowerSourceSnapshot copySnapshot() noexcept override;
+    bool startObserving(std::function<void()>&& changeHandler) noexcept override;
+    void stopObserving() noexcept override;
+    
+private:
+    struct Observer;
+    
+    const std::filesystem::path _root;
+    /// Shared with the thread, which outlives the observation
+    /// if observing is stopped from the change handler
+    std::shared_ptr<Observer> _observer;
+    std::thread _thread;
+    std::mutex _threadMutex;
+    
+    static void observe(Observer&) noexcept;
+};
+
+}
+
+#endif /* SysfsPowerSourceProvider_hpp */
@@ -11,37 +11,64 @@
 
 #include <chrono>
 #include <functional>
-#include <optional>
+#include <memory>
 #include <thread>
+#include <Awaken/Executor.hpp>
 #include <Awaken/Waiter.hpp>
 
 namespace Awaken
 {
 
+/// A waiter that blocks a private thread on a condition variable
+/// until a monotonic deadline is reached or the waiter is cancelled.
+/// The thread wakes up exactly once per run, there is no polling,
+/// unless it waits for the time of a `VirtualTimeSource`.
+///
+/// The thread is started by the first run and reused by all following
+/// runs. The timeout handler is called through the executor, a handler
+/// of a previous run that was not called yet is dropped by the next run.
 class ThreadWaiter : public Waiter
 {
 public:
-    
+
 #pragma mark - Life Cycle
-    
-    ThreadWaiter() noexcept = default;
-    
+
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    /// @param timeSource The time the timeout and deadlines refer to
+    explicit ThreadWaiter(Executor& executor = WorkerPoolExecutor::shared(),
+                          TimeSource& timeSource = SteadyTimeSource::shared()) noexcept;
+    ~ThreadWaiter() noexcept;
+
+    ThreadWaiter(const ThreadWaiter&) = delete;
+    ThreadWaiter& operator=(const ThreadWaiter&) = delete;
+
+    ThreadWaiter(ThreadWaiter&&) = delete;
+    ThreadWaiter& operator=(ThreadWaiter&&) = delete;
+
 #pragma mark - Properties
-    
+
     void setTimeout(std::chrono::seconds) noexcept override;
     void setTimeoutHandler(std::function<void()>&&) noexcept override;
-    
+    TimeSource& timeSource() const noexcept override { return this->_timeSource; }
+
 #pragma mark - Running
-    
+
     bool isRunning() const noexcept override;
     bool run() noexcept override;
     bool cancel() noexcept override;
-    
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
+
 private:
+    struct State;
+
+    TimeSource& _timeSource;
     std::chrono::seconds _timeout { 0 };
-    std::optional<std::function<void()>> _timeoutHandler = std::nullopt;
-    bool _running = false;
+    /// Shared with the thread, which outlives the waiter
+    /// if the waiter is destroyed from its own thread
+    std::shared_ptr<State> _state;
     std::thread _thread;
+
+    static void wait(State&) noexcept;
 };
 
 }
@@ -0,0 +1,110 @@
+//
+//  TimeSource.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef TimeSource_hpp
+#define TimeSource_hpp
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace Awaken
+{
+class TimerWheel;
+
+/// The monotonic time that waiters, timing wheels and sessions measure
+/// their timeouts and deadlines with, `SteadyTimeSource` by default.
+class TimeSource
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~TimeSource() = default;
+
+    virtual Clock::time_point now() const noexcept = 0;
+
+    /// Blocks on the condition until it is notified or the time point is
+    /// reached, the lock is held again when it returns. It may return
+    /// early, callers check their condition and the time again.
+    virtual void waitUntil(std::unique_lock<std::mutex>&, std::condition_variable&, Clock::time_point) const noexcept = 0;
+
+protected:
+    friend class TimerWheel;
+
+    /// Called by a timing wheel created with the time source
+    /// @returns true if the time source advances the wheel itself,
+    ///          which then does not start a service thread
+    virtual bool attach(TimerWheel&) noexcept { return false; }
+    /// Called by a timing wheel before it is destroyed
+    virtual void detach(TimerWheel&) noexcept {}
+};
+
+/// The time of `std::chrono::steady_clock`
+class SteadyTimeSource : public TimeSource
+{
+public:
+    /// Returns the process-wide steady time source
+    static SteadyTimeSource& shared() noexcept;
+
+    Clock::time_point now() const noexcept override { return Clock::now(); }
+    void waitUntil(std::unique_lock<std::mutex>&, std::condition_variable&, Clock::time_point) const noexcept override;
+};
+
+/// A time source that only moves when it is advanced,
+/// e.g. to simulate hours of sessions in a benchmark.
+///
+/// The timing wheels created with it have no service thread, `advance()`
+/// calls the handlers of their timers on the calling thread in the order
+/// of their deadlines, with `now()` at each deadline. Waiters that block
+/// a thread check the time again every `PollingInterval` of real time.
+class VirtualTimeSource : public TimeSource
+{
+public:
+    /// How often waiting threads check the virtual time
+    constexpr static std::chrono::milliseconds PollingInterval { 1 };
+
+#pragma mark - Life Cycle
+
+    /// @param start The initial time
+    explicit VirtualTimeSource(Clock::time_point start = Clock::time_point {}) noexcept;
+
+    VirtualTimeSource(const VirtualTimeSource&) = delete;
+    VirtualTimeSource& operator=(const VirtualTimeSource&) = delete;
+
+    VirtualTimeSource(VirtualTimeSource&&) = delete;
+    VirtualTimeSource& operator=(VirtualTimeSource&&) = delete;
+
+#pragma mark - Time
+
+    Clock::time_point now() const noexcept override;
+    void waitUntil(std::unique_lock<std::mutex>&, std::condition_variable&, Clock::time_point) const noexcept override;
+
+    /// Moves the time forward to the time point, firing the expired timers
+    /// of the attached wheels on the way. Handlers may schedule timers,
+    /// those that expire before the time point are fired as well. Wheels
+    /// must not be created or destroyed from within a handler.
+    void advance(Clock::time_point) noexcept;
+    /// Moves the time forward by the duration, see `advance(Clock::time_point)`
+    void advance(Clock::duration duration) noexcept { this->advance(this->now() + duration); }
+
+protected:
+    bool attach(TimerWheel&) noexcept override;
+    void detach(TimerWheel&) noexcept override;
+
+private:
+    std::atomic<Clock::rep> _now;
+
+    std::mutex _mutex;
+    std::vector<TimerWheel*> _wheels;
+};
+
+}
+
+#endif /* TimeSource_hpp */
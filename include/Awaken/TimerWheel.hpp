@@ -0,0 +1,171 @@
+//
+//  TimerWheel.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef TimerWheel_hpp
+#define TimerWheel_hpp
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <Awaken/TimeSource.hpp>
+
+namespace Awaken
+{
+
+/// A hierarchical timing wheel driven by a single service thread.
+///
+/// Timers are intrusive nodes owned by the caller, scheduling and
+/// cancelling a timer is O(1) and does not allocate. The service thread
+/// sleeps until the next occupied slot and does not wake up at all
+/// while no timer is scheduled. A wheel created with a
+/// `VirtualTimeSource` has no service thread, it is driven by the
+/// time source.
+class TimerWheel
+{
+public:
+    using Clock = TimeSource::Clock;
+
+    /// The granularity of a single wheel tick
+    constexpr static std::chrono::milliseconds Resolution { 1 };
+
+    /// An intrusive timer node. The handler is called on the wheel's
+    /// service thread when the timer expires or is fired, or on the
+    /// thread advancing its `VirtualTimeSource`.
+    class Timer
+    {
+    public:
+        explicit Timer(std::function<void()>&& handler) noexcept;
+        ~Timer() noexcept;
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        Timer(Timer&&) = delete;
+        Timer& operator=(Timer&&) = delete;
+
+    private:
+        friend class TimerWheel;
+
+        std::function<void()> _handler;
+        TimerWheel* _wheel = nullptr;
+        Timer* _previous = nullptr;
+        Timer* _next = nullptr;
+        uint64_t _expiry = 0;
+        uint16_t _bucket = 0;
+    };
+
+#pragma mark - Life Cycle
+
+    /// Returns the process-wide timing wheel
+    static TimerWheel& shared() noexcept;
+
+    /// @param timeSource The time the deadlines of the timers refer to
+    explicit TimerWheel(TimeSource& timeSource = SteadyTimeSource::shared()) noexcept;
+    ~TimerWheel() noexcept;
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+#pragma mark - Scheduling
+
+    /// Schedules the timer to fire at the deadline,
+    /// an already scheduled timer will be re-armed.
+    void schedule(Timer&, Clock::time_point deadline) noexcept;
+
+    /// Re-arms the timer to fire at the deadline, unless it already
+    /// expired and its handler is pending or being called.
+    /// @returns false if the timer could not be re-armed
+    bool reschedule(Timer&, Clock::time_point deadline) noexcept;
+
+    /// Fires the timer on the service thread as soon as possible,
+    /// unless its handler is already being called and did not re-arm it.
+    void fire(Timer&) noexcept;
+
+    /// Removes the timer from the wheel without calling its handler.
+    /// Waits for a handler that is currently being called to finish,
+    /// unless called from the service thread.
+    /// @returns true if the timer was scheduled
+    bool cancel(Timer&) noexcept;
+
+    /// Returns the number of scheduled timers
+    std::size_t count() const noexcept;
+
+    /// Returns the time source of the deadlines
+    TimeSource& timeSource() const noexcept { return this->_timeSource; }
+    /// Returns the current time of the time source
+    Clock::time_point now() const noexcept { return this->_timeSource.now(); }
+
+private:
+    constexpr static unsigned LevelBits = 6;
+    constexpr static unsigned SlotCount = 1u << LevelBits;
+    constexpr static unsigned LevelCount = 5;
+    constexpr static uint16_t OverflowBucket = LevelCount * SlotCount;
+    constexpr static uint16_t PendingBucket = OverflowBucket + 1;
+    constexpr static uint16_t NoBucket = PendingBucket + 1;
+
+    struct Bucket
+    {
+        Timer* head = nullptr;
+        Timer* tail = nullptr;
+    };
+
+    friend class VirtualTimeSource;
+
+    TimeSource& _timeSource;
+    /// True if the time source advances the wheel instead of a service thread
+    const bool _isDriven;
+    const Clock::time_point _epoch;
+    std::array<Bucket, NoBucket> _buckets {};
+    std::array<uint64_t, LevelCount> _occupied {};
+    uint64_t _currentTick = 0;
+    uint64_t _nextWakeTick = UINT64_MAX;
+    std::size_t _count = 0;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _firingCondition;
+    Timer* _firing = nullptr;
+    std::thread::id _firingThread;
+    bool _stopping = false;
+    std::thread _thread;
+
+    uint64_t tickFor(Clock::time_point) const noexcept;
+    Clock::time_point timeFor(uint64_t tick) const noexcept;
+
+    bool arm(Timer&, Clock::time_point deadline) noexcept;
+    void insert(Timer&) noexcept;
+    void append(Timer&, uint16_t bucket) noexcept;
+    void remove(Timer&) noexcept;
+
+    std::optional<uint64_t> nextEventTick() const noexcept;
+    void advance(uint64_t targetTick) noexcept;
+    void process(uint64_t tick) noexcept;
+    bool firePending(std::unique_lock<std::mutex>&) noexcept;
+
+    void startIfNeeded() noexcept;
+    void serviceLoop() noexcept;
+
+    /// Returns the time the wheel needs to be advanced to next,
+    /// used by a `VirtualTimeSource`
+    std::optional<Clock::time_point> nextDeadline() const noexcept;
+    /// Advances the wheel to the time and calls the handlers of the expired
+    /// timers on the calling thread, used by a `VirtualTimeSource`
+    void runUntil(Clock::time_point) noexcept;
+};
+
+}
+
+#endif /* TimerWheel_hpp */
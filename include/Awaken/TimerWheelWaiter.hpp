@@ -0,0 +1,68 @@
+//
+//  TimerWheelWaiter.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef TimerWheelWaiter_hpp
+#define TimerWheelWaiter_hpp
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <Awaken/Executor.hpp>
+#include <Awaken/TimerWheel.hpp>
+#include <Awaken/Waiter.hpp>
+
+namespace Awaken
+{
+
+/// A waiter that shares a timing wheel and its single service thread
+/// with all other instances, instead of spawning a thread per run.
+/// The timeout handler is called through the executor, so a slow
+/// handler does not delay the timers of other instances.
+class TimerWheelWaiter : public Waiter
+{
+public:
+
+#pragma mark - Life Cycle
+
+    /// @param wheel The timing wheel, defaults to the process-wide wheel
+    /// @param executor Calls the timeout handler, defaults to the process-wide worker pool
+    explicit TimerWheelWaiter(TimerWheel& wheel = TimerWheel::shared(),
+                              Executor& executor = WorkerPoolExecutor::shared()) noexcept;
+    ~TimerWheelWaiter() noexcept;
+
+    TimerWheelWaiter(const TimerWheelWaiter&) = delete;
+    TimerWheelWaiter& operator=(const TimerWheelWaiter&) = delete;
+
+    TimerWheelWaiter(TimerWheelWaiter&&) = delete;
+    TimerWheelWaiter& operator=(TimerWheelWaiter&&) = delete;
+
+#pragma mark - Properties
+
+    void setTimeout(std::chrono::seconds) noexcept override;
+    void setTimeoutHandler(std::function<void()>&&) noexcept override;
+    /// Returns the time source of the wheel
+    TimeSource& timeSource() const noexcept override { return this->_wheel.timeSource(); }
+
+#pragma mark - Running
+
+    bool isRunning() const noexcept override;
+    bool run() noexcept override;
+    bool cancel() noexcept override;
+    bool setDeadline(std::chrono::steady_clock::time_point) noexcept override;
+
+private:
+    TimerWheel& _wheel;
+    std::chrono::seconds _timeout { 0 };
+    ScheduledHandler _timeoutHandler;
+    std::atomic<bool> _running = false;
+    TimerWheel::Timer _timer;
+};
+
+}
+
+#endif /* TimerWheelWaiter_hpp */
@@ -0,0 +1,187 @@
+//
+//  Trace.hpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#ifndef Trace_hpp
+#define Trace_hpp
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// The lowest trace level that is compiled in, events below it compile
+/// away entirely: 0 debug, 1 info (default), 2 error, 3 off.
+#ifndef AWAKEN_TRACE_LEVEL
+#define AWAKEN_TRACE_LEVEL 1
+#endif
+
+namespace Awaken
+{
+
+/// The severity of a trace event
+enum class TraceLevel : uint8_t
+{
+    Debug,
+    Info,
+    Error,
+    Off,
+};
+
+/// The lowest trace level that is compiled in
+constexpr TraceLevel CompiledTraceLevel = static_cast<TraceLevel>(AWAKEN_TRACE_LEVEL);
+
+/// Describes a trace event call site. Descriptors are static,
+/// so recorded events only refer to them by address.
+struct TraceEventDescriptor
+{
+    TraceLevel level;
+    /// A printf-style format string for numeric arguments,
+    /// os_log style `%{public}` annotations are ignored
+    const char* format;
+    const char* file;
+    uint32_t line;
+};
+
+/// A fixed-size binary trace event
+struct TraceRecord
+{
+    constexpr static std::size_t MaximumArgumentCount = 3;
+    
+    /// How an argument is stored
+    enum class ArgumentKind : uint8_t { Signed, Unsigned, Floating };
+    
+    /// Nanoseconds of the steady clock
+    uint64_t timestamp;
+    const TraceEventDescriptor* descriptor;
+    uint64_t arguments[MaximumArgumentCount];
+    /// A small sequential number of the recording thread
+    uint32_t thread;
+    uint8_t argumentCount;
+    /// Two bits per argument with its `ArgumentKind`
+    uint8_t argumentKinds;
+    
+    ArgumentKind argumentKind(std::size_t index) const noexcept
+    {
+        return static_cast<ArgumentKind>((this->argumentKinds >> (2 * index)) & 0b11);
+    }
+};
+
+/// Called synchronously with every recorded trace event
+using TraceSink = void (*)(const TraceRecord&) noexcept;
+
+/// Records trace events into per-thread lock-free ring buffers.
+///
+/// Recording an event only stores its arguments and the address of its
+/// static descriptor, formatting happens lazily when dumping. Each thread
+/// owns a buffer, buffers of finished threads are reused by new threads.
+class Trace
+{
+public:
+    /// The number of events kept per thread
+    constexpr static std::size_t BufferCapacity = 1024;
+    /// The length of a formatted event including its terminator, longer ones are truncated
+    constexpr static std::size_t MaximumLineLength = 512;
+    
+    /// Records an event with up to three numeric arguments
+    template<typename... Arguments>
+    static void record(const TraceEventDescriptor& descriptor, Arguments... arguments) noexcept
+    {
+        static_assert(sizeof...(Arguments) <= TraceRecord::MaximumArgumentCount, "Too many trace arguments");
+        
+        TraceRecord record {};
+        record.descriptor = &descriptor;
+        (append(record, arguments), ...);
+        commit(record);
+    }
+    
+#pragma mark - Dumping
+    
+    /// Returns the events of all threads ordered by time
+    static std::vector<TraceRecord> records() noexcept;
+    
+    /// Formats an event as a single line without a trailing newline
+    static std::string format(const TraceRecord&);
+    
+    /// Formats an event into the buffer without allocating, see `format()`
+    /// @returns the length of the terminated line, which is truncated to the capacity
+    static std::size_t format(const TraceRecord&, char* buffer, std::size_t capacity) noexcept;
+    
+    /// Writes all events as text, one per line
+    static void dump(std::FILE*) noexcept;
+    
+    /// Discards all recorded events
+    static void clear() noexcept;
+    
+#pragma mark - Sinks
+    
+    /// Sets a sink called with every recorded event, nullptr disables it.
+    /// `osLogSink` is set by default on Apple platforms, elsewhere no sink is.
+    static void setSink(TraceSink) noexcept;
+    
+    /// Writes events to the unified log on Apple platforms,
+    /// the way the library logged before tracing was added.
+    /// Events are formatted on the stack, logging does not allocate.
+    static void osLogSink(const TraceRecord&) noexcept;
+    
+    /// Writes events to stderr
+    static void standardErrorSink(const TraceRecord&) noexcept;
+    
+private:
+    template<typename Argument>
+    static void append(TraceRecord& record, Argument argument) noexcept
+    {
+        using Kind = TraceRecord::ArgumentKind;
+        
+        uint64_t value = 0;
+        Kind kind = Kind::Unsigned;
+        if constexpr(std::is_enum_v<Argument>)
+        {
+            value = static_cast<uint64_t>(argument);
+        }
+        else if constexpr(std::is_floating_point_v<Argument>)
+        {
+            value = std::bit_cast<uint64_t>(static_cast<double>(argument));
+            kind = Kind::Floating;
+        }
+        else if constexpr(std::is_signed_v<Argument>)
+        {
+            value = static_cast<uint64_t>(static_cast<int64_t>(argument));
+            kind = Kind::Signed;
+        }
+        else
+        {
+            static_assert(std::is_integral_v<Argument>, "Only numeric trace arguments are supported");
+            value = static_cast<uint64_t>(argument);
+        }
+        
+        const auto index = record.argumentCount++;
+        record.arguments[index] = value;
+        record.argumentKinds |= static_cast<uint8_t>(static_cast<uint8_t>(kind) << (2 * index));
+    }
+    
+    static void commit(TraceRecord&) noexcept;
+};
+
+}
+
+/// Records a trace event if its level is compiled in, e.g.
+/// `AWAKEN_TRACE(Info, "Waiting for %{public}lld seconds.", timeout.count());`
+#define AWAKEN_TRACE(level, format, ...) \
+    do { \
+        if constexpr(::Awaken::TraceLevel::level >= ::Awaken::CompiledTraceLevel) { \
+            static constexpr ::Awaken::TraceEventDescriptor awakenTraceDescriptor { \
+                ::Awaken::TraceLevel::level, format, __FILE__, __LINE__ \
+            }; \
+            ::Awaken::Trace::record(awakenTraceDescriptor __VA_OPT__(,) __VA_ARGS__); \
+        } \
+    } while(false)
+
+#endif /* Trace_hpp */
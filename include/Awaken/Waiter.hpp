@@ -11,6 +11,7 @@
 
 #include <chrono>
 #include <functional>
+#include <Awaken/TimeSource.hpp>
 
 namespace Awaken
 {
@@ -23,11 +24,22 @@ public:
     virtual void setTimeout(std::chrono::seconds) noexcept = 0;
     virtual void setTimeoutHandler(std::function<void()>&&) noexcept = 0;
     
+    /// Returns the time source that timeouts and deadlines refer to
+    virtual TimeSource& timeSource() const noexcept { return SteadyTimeSource::shared(); }
+    
 #pragma mark - Running
     
     virtual bool isRunning() const noexcept = 0;
+    /// Starts waiting, the timeout handler is called once per run
+    /// when the timeout is reached or the waiter is cancelled.
+    /// @note Runs are started by one thread at a time, `cancel()`
+    ///       and `setDeadline()` may be called from any thread.
     virtual bool run() noexcept = 0;
     virtual bool cancel() noexcept = 0;
+    
+    /// Moves the deadline of a running waiter without restarting it.
+    /// @returns false if the waiter is not running or cannot be re-armed
+    virtual bool setDeadline(std::chrono::steady_clock::time_point) noexcept = 0;
 };
 
 }
@@ -7,16 +7,33 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
 #include <print>
 #include <chrono>
+#include <string>
+#include <vector>
+#include <spawn.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#if defined(__APPLE__)
 #include <dispatch/dispatch.h>
+#endif
 #include <Awaken/Awaken.hpp>
+#include <Awaken/FileDescriptorWaiter.hpp>
+#include <Awaken/ProcessWaiter.hpp>
 #include <cxxopts.hpp>
 
-void RunAwaken(std::chrono::seconds timeout, bool preventDisplaySleep, bool preventSystemSleep, std::optional<float> minimumBatteryCapacity)
+extern char** environ;
+
+void RunAwaken(std::chrono::seconds timeout, bool preventDisplaySleep, bool preventSystemSleep, std::optional<float> minimumBatteryCapacity, std::chrono::seconds batteryMargin, std::unique_ptr<Awaken::Waiter> waiter, std::optional<pid_t> command)
 {
 //    __block
-    auto awaken = Awaken::Awaken("awaken command-line tool");
+    // Holding for processes or a descriptor replaces the default
+    // waiter, the timeout still applies if one is set.
+    auto awaken = waiter == nullptr
+        ? Awaken::Awaken("awaken command-line tool")
+        : Awaken::Awaken("awaken command-line tool", std::move(waiter));
     awaken.setPreventUserIdleSystemSleep(preventSystemSleep);
     awaken.setPreventUserIdleDisplaySleep(preventDisplaySleep);
     
@@ -26,12 +43,27 @@ void RunAwaken(std::chrono::seconds timeout, bool preventDisplaySleep, bool prev
     if(const auto capacity = minimumBatteryCapacity)
     {
         awaken.setMinimumBatteryCapacity(*minimumBatteryCapacity);
+        awaken.setMinimumBatteryCapacityMargin(batteryMargin);
         awaken.setMinimumBatteryCapacityReachedHandler([](float capacity) {
-            std::println("Minimum battery capacity reached {:.0f}", capacity);
+            std::println(stderr, "Minimum battery capacity reached {:.0f}", capacity);
         });
     }
     
-    awaken.setTimeoutHandler([]{
+    awaken.setTimeoutHandler([command]{
+        // Exits with the status of a command that ended the hold,
+        // or like a shell with 128 plus the signal that killed it
+        int status = 0;
+        if(command && waitpid(*command, &status, WNOHANG) == *command)
+        {
+            if(WIFEXITED(status))
+            {
+                exit(WEXITSTATUS(status));
+            }
+            if(WIFSIGNALED(status))
+            {
+                exit(128 + WTERMSIG(status));
+            }
+        }
         exit(EXIT_SUCCESS);
     });
     awaken.run();
@@ -42,7 +74,16 @@ void RunAwaken(std::chrono::seconds timeout, bool preventDisplaySleep, bool prev
     
 // ------------
     
+#if defined(__APPLE__)
     dispatch_main();
+#else
+    // Handlers are called on the executor's threads, the
+    // main thread only needs to stay alive until exit().
+    while(true)
+    {
+        pause();
+    }
+#endif
 }
 
 cxxopts::ParseResult ParseArguments(int argc, char* argv[])
@@ -56,7 +97,14 @@ cxxopts::ParseResult ParseArguments(int argc, char* argv[])
         ("s,system-sleep", "prevent the system from idle sleeping", cxxopts::value<bool>()->default_value("true"))
         ("t,timeout", "timeout in seconds until the sleep assertion expires", cxxopts::value<int64_t>()->default_value("0"), "N")
         ("b,battery-level", "a minimum battery level on devices with a built-in battery that causes the sleep assertion to expire (e.g. 20 for <= 20% remaining battery). Values above 95 are unreliable and depend on the battery health.", cxxopts::value<uint8_t>()->default_value("0"), "N")
+        ("m,battery-margin", "expire the sleep assertion this many seconds before the battery level is predicted to be reached, based on the recent discharge rate", cxxopts::value<int64_t>()->default_value("0"), "N")
+        ("w,wait-for", "wait for the process with the given pid to exit, may be repeated to wait for all of them", cxxopts::value<std::vector<pid_t>>(), "PID")
+        ("e,until-eof", "wait for the standard input to reach its end, e.g. when the previous stage of a pipeline exits")
+        ("p,pass-through", "copy the standard input to the standard output while waiting for its end")
+        ("command", "a command that is run and held for until it exits (e.g. awaken -- make)", cxxopts::value<std::vector<std::string>>())
         ;
+        options.parse_positional({ "command" });
+        options.positional_help("[-- command [arguments...]]");
         
         options.add_options("Help")
         ("h,help", "print this help")
@@ -94,6 +142,7 @@ int main(int argc, char **argv)
     bool preventDisplaySleep = false;
     bool preventSystemSleep = false;
     std::optional<float> minimumBatteryCapacity = std::nullopt;
+    std::chrono::seconds batteryMargin { 0 };
     
     if(result.count("display-sleep"))
     {
@@ -128,7 +177,68 @@ int main(int argc, char **argv)
         minimumBatteryCapacity = static_cast<float>(batteryLevel);
     }
     
-    RunAwaken(timeout, preventDisplaySleep, preventSystemSleep, minimumBatteryCapacity);
+    if(result.count("battery-margin"))
+    {
+        batteryMargin = std::chrono::seconds { result["battery-margin"].as<int64_t>() };
+    }
+    
+    // Checked before spawning, so a failed check does not leave the command running
+    const bool waitsForInput = result.count("until-eof") || result.count("pass-through");
+    if(waitsForInput && (result.count("wait-for") || result.count("command")))
+    {
+        std::println(stderr, "Waiting for the end of the standard input cannot be combined with processes.");
+        exit(EXIT_FAILURE);
+    }
+    
+    std::vector<pid_t> processes;
+    if(result.count("wait-for"))
+    {
+        processes = result["wait-for"].as<std::vector<pid_t>>();
+    }
+    
+    std::optional<pid_t> command = std::nullopt;
+    if(result.count("command"))
+    {
+        auto arguments = result["command"].as<std::vector<std::string>>();
+        std::vector<char*> argumentPointers;
+        for(auto& argument : arguments)
+        {
+            argumentPointers.push_back(argument.data());
+        }
+        argumentPointers.push_back(nullptr);
+        
+        pid_t process = 0;
+        if(const auto error = posix_spawnp(&process, argumentPointers.front(), nullptr, nullptr, argumentPointers.data(), environ))
+        {
+            std::println(stderr, "Failed running '{}': {}", arguments.front(), strerror(error));
+            exit(EXIT_FAILURE);
+        }
+        command = process;
+        processes.push_back(process);
+    }
+    
+    std::unique_ptr<Awaken::Waiter> waiter = nullptr;
+    if(waitsForInput)
+    {
+        // The standard input is read until its end, which
+        // also ends when the terminal sends end-of-file.
+        if(result.count("pass-through"))
+        {
+            // A closed output ends the hold instead of terminating the process
+            signal(SIGPIPE, SIG_IGN);
+            waiter = std::make_unique<Awaken::FileDescriptorWaiter>(STDIN_FILENO, STDOUT_FILENO);
+        }
+        else
+        {
+            waiter = std::make_unique<Awaken::FileDescriptorWaiter>(STDIN_FILENO, Awaken::FileDescriptorWaiter::Input::Consume);
+        }
+    }
+    else if(!processes.empty())
+    {
+        waiter = std::make_unique<Awaken::ProcessWaiter>(std::move(processes));
+    }
+    
+    RunAwaken(timeout, preventDisplaySleep, preventSystemSleep, minimumBatteryCapacity, batteryMargin, std::move(waiter), command);
     
     return EXIT_SUCCESS;
 }
@@ -7,8 +7,10 @@
 //
 
 #include <Awaken/Awaken.hpp>
+#include <Awaken/BasicAwaken.hpp>
 #include <Awaken/IOPowerAssertion.hpp>
 #include <Awaken/IOPowerSource.hpp>
+#include <Awaken/PowerAssertionBackend.hpp>
 #include <Awaken/Waiter.hpp>
 #include "Log.hpp"
 
@@ -28,30 +30,39 @@ namespace Awaken { using WaiterClass = ThreadWaiter; }
 #endif
 
 using namespace std;
-using ::Awaken::DefaultLog;
 
 #pragma mark - Life Cycle
 
 Awaken::Awaken::Awaken(string name) noexcept
-    : _powerAssertion(make_unique<IOPowerAssertion>())
-    , _powerSource(make_unique<IOPowerSource>())
-    , _waiter(make_unique<WaiterClass>())
+    : Awaken::Awaken::Awaken(std::move(name), make_unique<WaiterClass>())
+{
+}
+
+Awaken::Awaken::Awaken(string name, unique_ptr<Waiter> waiter) noexcept
+    : Awaken::Awaken::Awaken(std::move(name), PowerAssertionBackend::systemDefault(), std::move(waiter))
+{
+}
+
+Awaken::Awaken::Awaken(string name,
+                       shared_ptr<PowerAssertionBackend> backend,
+                       unique_ptr<Waiter> waiter) noexcept
+    : _session(make_unique<Session>(std::move(name),
+                                    piecewise_construct,
+                                    forward_as_tuple(std::move(backend)),
+                                    tuple {},
+                                    forward_as_tuple(std::move(waiter))))
 {
-    this->_powerAssertion->name = name;
 }
 
 Awaken::Awaken::Awaken() noexcept : Awaken::Awaken::Awaken("Awaken") {};
 
+// A moved-from instance does not own a session.
 Awaken::Awaken::~Awaken() noexcept = default;
 
-Awaken::Awaken::Awaken(Awaken&& other) noexcept
-    : _powerAssertion(std::move(other._powerAssertion))
-    , _powerSource(std::move(other._powerSource))
-    , _waiter(std::move(other._waiter))
-{
-}
+Awaken::Awaken::Awaken(Awaken&&) noexcept = default;
 
-Awaken::Awaken& Awaken::Awaken::operator=(Awaken&& other) noexcept = default;
+// Destroying the replaced session cancels it.
+Awaken::Awaken& Awaken::Awaken::operator=(Awaken&&) noexcept = default;
 
 #pragma mark - Properties
 
@@ -60,146 +71,155 @@ string Awaken::Awaken::version() noexcept
     return AWAKEN_VERSION;
 }
 
+string Awaken::Awaken::name() const noexcept
+{
+    return this->_session->name();
+}
+
 bool Awaken::Awaken::setPreventUserIdleSystemSleep(bool preventUserIdleSystemSleep) noexcept
 {
-    if(this->isRunning())
-    {
-        os_log(DefaultLog, "The idle system sleep value cannot be modified while running.");
-        return false;
-    }
-    
-    this->_powerAssertion->preventUserIdleSystemSleep = std::move(preventUserIdleSystemSleep);
-    
-    return true;
+    return this->_session->setPreventUserIdleSystemSleep(preventUserIdleSystemSleep);
 }
 
 bool Awaken::Awaken::preventUserIdleSystemSleep() const noexcept
 {
-    return this->_powerAssertion->preventUserIdleSystemSleep;
+    return this->_session->preventUserIdleSystemSleep();
 }
 
 bool Awaken::Awaken::setPreventUserIdleDisplaySleep(bool preventUserIdleDisplaySleep) noexcept
 {
-    if(this->isRunning())
-    {
-        os_log(DefaultLog, "The idle display sleep value cannot be modified while running.");
-        return false;
-    }
-    
-    this->_powerAssertion->preventUserIdleDisplaySleep = std::move(preventUserIdleDisplaySleep);
-    
-    return true;
+    return this->_session->setPreventUserIdleDisplaySleep(preventUserIdleDisplaySleep);
 }
 
 bool Awaken::Awaken::preventUserIdleDisplaySleep() const noexcept
 {
-    return this->_powerAssertion->preventUserIdleDisplaySleep;
+    return this->_session->preventUserIdleDisplaySleep();
+}
+
+void Awaken::Awaken::setReleaseLinger(chrono::milliseconds linger) noexcept
+{
+    this->_session->setReleaseLinger(linger);
+}
+
+chrono::milliseconds Awaken::Awaken::releaseLinger() const noexcept
+{
+    return this->_session->releaseLinger();
 }
 
 #pragma mark - Timeout
 
 bool Awaken::Awaken::setTimeout(chrono::seconds timeout) noexcept
 {
-    if(this->isRunning())
-    {
-        os_log(DefaultLog, "The timeout cannot be modified while running.");
-        return false;
-    }
-    
-    this->_waiter->setTimeout(timeout);
-    this->_powerAssertion->timeout = std::move(timeout);
-    
-    return true;
+    return this->_session->setTimeout(timeout);
 }
 
 chrono::seconds Awaken::Awaken::timeout() const noexcept
 {
-    return this->_powerAssertion->timeout;
+    return this->_session->timeout();
 }
 
 void Awaken::Awaken::setTimeoutHandler(function<void()>&& timeoutHandler) noexcept
 {
-    this->_waiter->setTimeoutHandler(std::move(timeoutHandler));
+    this->_session->setTimeoutHandler(std::move(timeoutHandler));
+}
+
+Awaken::Subscription Awaken::Awaken::subscribeToEnd(function<void(HoldEndReason)>&& handler) noexcept
+{
+    return this->_session->subscribeToEnd(std::move(handler));
+}
+
+bool Awaken::Awaken::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    return this->_session->setDeadline(deadline);
+}
+
+bool Awaken::Awaken::extendBy(chrono::seconds duration) noexcept
+{
+    return this->_session->extendBy(duration);
+}
+
+optional<chrono::steady_clock::time_point> Awaken::Awaken::deadline() const noexcept
+{
+    return this->_session->deadline();
 }
 
 #pragma mark - Minimum Battery Capacity
 
 bool Awaken::Awaken::hasBattery() const noexcept
 {
-    return this->_powerSource->hasBattery();
+    return this->_session->hasBattery();
 }
 
 void Awaken::Awaken::setMinimumBatteryCapacity(float capacity) noexcept
 {
-    os_log(DefaultLog, "Setting minimum battery capacity to %{public}.00f…", capacity);
-    this->_minimumBatteryCapacity = capacity;
+    this->_session->setMinimumBatteryCapacity(capacity);
 }
 
 float Awaken::Awaken::minimumBatteryCapacity() const noexcept
 {
-    return this->_minimumBatteryCapacity;
+    return this->_session->minimumBatteryCapacity();
+}
+
+void Awaken::Awaken::setMinimumBatteryCapacityMargin(chrono::seconds margin) noexcept
+{
+    this->_session->setMinimumBatteryCapacityMargin(margin);
+}
+
+chrono::seconds Awaken::Awaken::minimumBatteryCapacityMargin() const noexcept
+{
+    return this->_session->minimumBatteryCapacityMargin();
+}
+
+optional<chrono::seconds> Awaken::Awaken::timeUntilMinimumBatteryCapacity() const noexcept
+{
+    return this->_session->timeUntilMinimumBatteryCapacity();
 }
 
 void Awaken::Awaken::setMinimumBatteryCapacityReachedHandler(std::function<void(float)>&& handler) noexcept
 {
-    if(handler != nullptr)
-    {
-        if(!this->_powerSource->hasBattery())
-        {
-            os_log(DefaultLog, "Current device does not support a minimum battery capacity.");
-            return;
-        }
-        
-        const float currentMinimumCapacity = this->_minimumBatteryCapacity;
-        this->_powerSource->setCapacityChangeHandler([handler, currentMinimumCapacity, this](float capacity) {
-            if(capacity <= currentMinimumCapacity)
-            {
-                os_log(DefaultLog, "Minimum battery capacity reached: %{public}.00f", capacity);
-                handler(capacity);
-                this->cancel();
-            }
-        });
-        this->_powerSource->registerForCapacityChanges();
-    }
-    else
-    {
-        this->_powerSource->unregisterFromCapacityChanges();
-        this->_powerSource->setCapacityChangeHandler(nullptr);
-    }
+    this->_session->setMinimumBatteryCapacityReachedHandler(std::move(handler));
+}
+
+Awaken::Subscription Awaken::Awaken::subscribeToMinimumBatteryCapacityReached(std::function<void(float)>&& handler) noexcept
+{
+    return this->_session->subscribeToMinimumBatteryCapacityReached(std::move(handler));
+}
+
+#pragma mark - Subscriptions
+
+bool Awaken::Awaken::unsubscribe(Subscription subscription) noexcept
+{
+    return this->_session->unsubscribe(subscription);
 }
 
 #pragma mark - Running
 
 bool Awaken::Awaken::isRunning() const noexcept
 {
-    return this->_powerAssertion->isRunning();
+    return this->_session->isRunning();
 }
 
 bool Awaken::Awaken::run() noexcept
 {
-    if(!this->_waiter->run())
-    {
-        os_log(DefaultLog, "Failed to wait for power assertion.");
-        return false;
-    }
-    if(!this->_powerAssertion->run())
-    {
-        os_log(DefaultLog, "Failed to run power assertion.");
-        this->_waiter->cancel();
-        return false;
-    }
-    return true;
+    return this->_session->run();
 }
 
 void Awaken::Awaken::cancel() noexcept
 {
-    if(!this->_waiter->cancel())
-    {
-        os_log(DefaultLog, "Failed to cancel power assertion waiter.");
-    }
-    if(!this->_powerAssertion->cancel())
-    {
-        os_log(DefaultLog, "Failed to cancel power assertion.");
-    }
-    this->_powerSource->setCapacityChangeHandler(nullptr);
+    this->_session->cancel();
+}
+
+const Awaken::SessionMetrics& Awaken::Awaken::metrics() const noexcept
+{
+    return this->_session->metrics();
+}
+
+Awaken::HoldAwaiter Awaken::Awaken::holdFor(chrono::seconds timeout, Executor& executor) noexcept
+{
+    return HoldAwaiter(*this, timeout, executor);
+}
+
+bool Awaken::Awaken::beginHold(HoldAwaiter& awaiter) noexcept
+{
+    return this->_session->beginHold(awaiter);
 }
@@ -0,0 +1,136 @@
+//
+//  IOKitPowerAssertionBackend.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#if defined(__APPLE__)
+
+#include <Awaken/IOKitPowerAssertionBackend.hpp>
+#include <CoreFoundation/CoreFoundation.h>
+#include <IOKit/pwr_mgt/IOPMLib.h>
+#include <mutex>
+#include <unordered_map>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Awaken::CoreFoundationString
+
+namespace Awaken
+{
+class CoreFoundationString
+{
+public:
+    CoreFoundationString(const std::string& stdString) noexcept
+    {
+        const auto data = reinterpret_cast<const UInt8*>(stdString.data());
+        const auto size = static_cast<CFIndex>(stdString.size());
+        this->_cfString = CFStringCreateWithBytes(kCFAllocatorDefault,
+                                                  data, size,
+                                                  kCFStringEncodingUTF8,
+                                                  false);
+    }
+    
+    ~CoreFoundationString() { CFRelease(this->_cfString); }
+    
+    CoreFoundationString(const CoreFoundationString&) = delete;
+    CoreFoundationString& operator=(const CoreFoundationString&) = delete;
+    
+    CFStringRef get() const noexcept { return this->_cfString; }
+    CFStringRef operator()() const noexcept { return this->_cfString; }
+    
+private:
+    CFStringRef _cfString;
+};
+}
+
+#pragma mark - Names
+
+struct IOKitPowerAssertionBackend::Names
+{
+    std::mutex mutex;
+    unordered_map<string, CoreFoundationString> strings;
+    
+    /// Returns the string for the name, which lives as long as the backend
+    CFStringRef intern(const string& name) noexcept
+    {
+        lock_guard lock { this->mutex };
+        auto entry = this->strings.find(name);
+        if(entry == this->strings.end())
+        {
+            entry = this->strings.try_emplace(name, name).first;
+        }
+        return entry->second();
+    }
+};
+
+#pragma mark - Life Cycle
+
+IOKitPowerAssertionBackend::IOKitPowerAssertionBackend() noexcept
+    : _names(make_unique<Names>())
+{
+}
+
+IOKitPowerAssertionBackend::~IOKitPowerAssertionBackend() noexcept = default;
+
+#pragma mark - Backend
+
+optional<PowerAssertionID> IOKitPowerAssertionBackend::create(PowerAssertionType type,
+                                                              const std::string& name,
+                                                              std::chrono::seconds timeout) noexcept
+{
+    CFStringRef assertionType = nullptr;
+    CFStringRef reason = nullptr;
+    switch(type)
+    {
+        case PowerAssertionType::PreventUserIdleSystemSleep:
+            assertionType = kIOPMAssertionTypePreventUserIdleSystemSleep;
+            reason = CFSTR("preventing user idle system sleep");
+            break;
+        case PowerAssertionType::PreventUserIdleDisplaySleep:
+            assertionType = kIOPMAssertionTypePreventUserIdleDisplaySleep;
+            reason = CFSTR("preventing user idle display sleep");
+            break;
+    }
+    
+    const auto interval = static_cast<CFTimeInterval>(timeout.count());
+    IOPMAssertionID assertionID = 0;
+    auto result = IOPMAssertionCreateWithDescription(assertionType,
+                                                     this->_names->intern(name),
+                                                     reason, nullptr, nullptr,
+                                                     interval,
+                                                     kIOPMAssertionTimeoutActionRelease,
+                                                     &assertionID);
+    if(result != kIOReturnSuccess)
+    {
+        AWAKEN_TRACE(Error, "Failed creating power assertion: %{public}d.", result);
+        return nullopt;
+    }
+    return assertionID;
+}
+
+bool IOKitPowerAssertionBackend::release(PowerAssertionID assertionID) noexcept
+{
+    return IOPMAssertionRelease(assertionID) == kIOReturnSuccess;
+}
+
+bool IOKitPowerAssertionBackend::setTimeout(PowerAssertionID assertionID, std::chrono::seconds timeout) noexcept
+{
+    const auto interval = static_cast<CFTimeInterval>(timeout.count());
+    auto value = CFNumberCreate(kCFAllocatorDefault, kCFNumberDoubleType, &interval);
+    auto result = IOPMAssertionSetProperty(assertionID, kIOPMAssertionTimeoutKey, value);
+    CFRelease(value);
+    
+    if(result != kIOReturnSuccess)
+    {
+        AWAKEN_TRACE(Error, "Failed updating power assertion timeout: %{public}d.", result);
+        return false;
+    }
+    return true;
+}
+
+#endif
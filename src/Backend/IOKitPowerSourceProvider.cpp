@@ -0,0 +1,175 @@
+//
+//  IOKitPowerSourceProvider.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#if defined(__APPLE__)
+
+#include <Awaken/IOKitPowerSourceProvider.hpp>
+#include <CoreFoundation/CoreFoundation.h>
+#include <dispatch/dispatch.h>
+#include <notify.h>
+#include <IOKit/ps/IOPSKeys.h>
+#include <IOKit/ps/IOPowerSources.h>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+namespace Awaken
+{
+/// Identifies the provider's queue to detect re-entrant calls
+static int DispatchQueueKey = 0;
+}
+
+#pragma mark - Life Cycle
+
+IOKitPowerSourceProvider::IOKitPowerSourceProvider() noexcept
+    : _changeHandler(nullopt)
+    , _dispatchQueue(nullptr)
+    , _notificationToken(0)
+{
+}
+
+IOKitPowerSourceProvider::~IOKitPowerSourceProvider() noexcept
+{
+    this->stopObserving();
+}
+
+#pragma mark - Snapshot
+
+PowerSourceSnapshot IOKitPowerSourceProvider::copySnapshot() noexcept
+{
+    PowerSourceSnapshot snapshot;
+    
+    auto powerSources = IOPSCopyPowerSourcesInfo();
+    auto sourcesList = IOPSCopyPowerSourcesList(powerSources);
+    
+    snapshot.sourceCount = static_cast<uint32_t>(CFArrayGetCount(sourcesList));
+    if(snapshot.sourceCount == 0)
+    {
+        AWAKEN_TRACE(Info, "No power sources found.");
+    }
+    
+    for(size_t index = 0; index < snapshot.storedSourceCount(); index++)
+    {
+        auto description = IOPSGetPowerSourceDescription(sourcesList, CFArrayGetValueAtIndex(sourcesList, static_cast<CFIndex>(index)));
+        if(description == nullptr) { continue; }
+        
+        // Decode everything in a single pass over the description.
+        auto& source = snapshot.sources[index];
+        source.identifier = static_cast<uint32_t>(index);
+        if(auto identifier = static_cast<CFNumberRef>(CFDictionaryGetValue(description, CFSTR(kIOPSPowerSourceIDKey))))
+        {
+            CFNumberGetValue(identifier, kCFNumberSInt32Type, &source.identifier);
+        }
+        
+        if(auto type = static_cast<CFStringRef>(CFDictionaryGetValue(description, CFSTR(kIOPSTypeKey))))
+        {
+            if(CFEqual(type, CFSTR(kIOPSInternalBatteryType)))
+            {
+                source.type = PowerSourceSnapshot::Type::InternalBattery;
+            }
+            else if(CFEqual(type, CFSTR(kIOPSUPSType)))
+            {
+                source.type = PowerSourceSnapshot::Type::UPS;
+            }
+        }
+        
+        if(auto capacity = static_cast<CFNumberRef>(CFDictionaryGetValue(description, CFSTR(kIOPSCurrentCapacityKey))))
+        {
+            CFNumberGetValue(capacity, kCFNumberFloatType, &source.capacity);
+            
+            // The current capacity is only a percentage if
+            // the maximum capacity is reported as 100.
+            float maximumCapacity = 0;
+            auto maximum = static_cast<CFNumberRef>(CFDictionaryGetValue(description, CFSTR(kIOPSMaxCapacityKey)));
+            if(maximum != nullptr && CFNumberGetValue(maximum, kCFNumberFloatType, &maximumCapacity) && maximumCapacity > 0)
+            {
+                source.capacity = source.capacity * 100.0f / maximumCapacity;
+            }
+        }
+        
+        if(auto isCharging = static_cast<CFBooleanRef>(CFDictionaryGetValue(description, CFSTR(kIOPSIsChargingKey))))
+        {
+            source.isCharging = CFBooleanGetValue(isCharging);
+        }
+        
+        if(auto timeToEmpty = static_cast<CFNumberRef>(CFDictionaryGetValue(description, CFSTR(kIOPSTimeToEmptyKey))))
+        {
+            int minutes = -1;
+            CFNumberGetValue(timeToEmpty, kCFNumberIntType, &minutes);
+            if(minutes >= 0)
+            {
+                source.timeRemaining = chrono::minutes { minutes };
+            }
+        }
+        
+        // IOKit does not describe the energy of a power source,
+        // so its sources are aggregated with equal weights.
+    }
+    
+    CFRelease(sourcesList);
+    CFRelease(powerSources);
+    
+    return snapshot;
+}
+
+#pragma mark - Observing
+
+bool IOKitPowerSourceProvider::startObserving(std::function<void()>&& changeHandler) noexcept
+{
+    if(this->_notificationToken != 0)
+    {
+        AWAKEN_TRACE(Info, "Already observing power source changes.");
+        return false;
+    }
+    
+    const auto dispatchQueue = dispatch_queue_create("info.marcel-dierkes.Awaken.IOPowerSourceQueue",
+                                                     DISPATCH_QUEUE_SERIAL);
+    dispatch_queue_set_specific(dispatchQueue, &DispatchQueueKey, this, nullptr);
+    this->_dispatchQueue = dispatchQueue;
+    this->_changeHandler = std::move(changeHandler);
+    
+    auto status = notify_register_dispatch(kIOPSNotifyAnyPowerSource, &this->_notificationToken, dispatchQueue, ^(int) {
+        if(const auto& changeHandler = this->_changeHandler)
+        {
+            (*changeHandler)();
+        }
+    });
+    if(status != NOTIFY_STATUS_OK)
+    {
+        AWAKEN_TRACE(Error, "Failed observing power source changes: %{public}u", status);
+        this->_notificationToken = 0;
+        this->stopObserving();
+        return false;
+    }
+    
+    return true;
+}
+
+void IOKitPowerSourceProvider::stopObserving() noexcept
+{
+    if(this->_notificationToken != 0)
+    {
+        notify_cancel(this->_notificationToken);
+        this->_notificationToken = 0;
+    }
+    
+    if(auto dispatchQueue = static_cast<dispatch_queue_t>(this->_dispatchQueue))
+    {
+        // Let an in-flight notification finish, unless called from it.
+        if(dispatch_get_specific(&DispatchQueueKey) != this)
+        {
+            dispatch_sync(dispatchQueue, ^{});
+        }
+        dispatch_release(dispatchQueue);
+        this->_dispatchQueue = nullptr;
+    }
+    this->_changeHandler = nullopt;
+}
+
+#endif
@@ -0,0 +1,212 @@
+//
+//  InMemoryPowerAssertionBackend.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/InMemoryPowerAssertionBackend.hpp>
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Backend
+
+optional<PowerAssertionID> InMemoryPowerAssertionBackend::create(PowerAssertionType type,
+                                                                 const std::string& name,
+                                                                 std::chrono::seconds timeout) noexcept
+{
+    const auto start = chrono::steady_clock::now();
+    this->simulateLatency();
+    
+    lock_guard lock { this->_mutex };
+    
+    optional<PowerAssertionID> assertionID = nullopt;
+    if(!this->_failing[static_cast<size_t>(type)])
+    {
+        auto internedName = this->_names.find(name);
+        if(internedName == this->_names.end())
+        {
+            internedName = this->_names.insert(name).first;
+        }
+        
+        assertionID = this->_nextAssertionID++;
+        this->_assertions.push_back(Assertion { *assertionID, type, &*internedName, timeout });
+        this->_createCount++;
+    }
+    
+    this->record(Call {
+        Call::Kind::Create, type, assertionID.value_or(0), assertionID.has_value(),
+        start, chrono::steady_clock::now() - start
+    });
+    return assertionID;
+}
+
+bool InMemoryPowerAssertionBackend::release(PowerAssertionID assertionID) noexcept
+{
+    const auto start = chrono::steady_clock::now();
+    this->simulateLatency();
+    
+    lock_guard lock { this->_mutex };
+    
+    auto assertion = this->find(assertionID);
+    if(assertion == this->_assertions.end())
+    {
+        return false;
+    }
+    
+    const auto type = assertion->type;
+    const bool succeeded = !this->_failing[static_cast<size_t>(type)];
+    if(succeeded)
+    {
+        *assertion = this->_assertions.back();
+        this->_assertions.pop_back();
+        this->_releaseCount++;
+    }
+    
+    this->record(Call {
+        Call::Kind::Release, type, assertionID, succeeded,
+        start, chrono::steady_clock::now() - start
+    });
+    return succeeded;
+}
+
+bool InMemoryPowerAssertionBackend::setTimeout(PowerAssertionID assertionID, std::chrono::seconds timeout) noexcept
+{
+    const auto start = chrono::steady_clock::now();
+    this->simulateLatency();
+    
+    lock_guard lock { this->_mutex };
+    
+    auto assertion = this->find(assertionID);
+    if(assertion == this->_assertions.end())
+    {
+        return false;
+    }
+    
+    const auto type = assertion->type;
+    const bool succeeded = !this->_failing[static_cast<size_t>(type)];
+    if(succeeded)
+    {
+        assertion->timeout = timeout;
+        this->_updateCount++;
+    }
+    
+    this->record(Call {
+        Call::Kind::Update, type, assertionID, succeeded,
+        start, chrono::steady_clock::now() - start
+    });
+    return succeeded;
+}
+
+vector<InMemoryPowerAssertionBackend::Assertion>::iterator InMemoryPowerAssertionBackend::find(PowerAssertionID assertionID) noexcept
+{
+    return find_if(this->_assertions.begin(), this->_assertions.end(), [assertionID](const auto& assertion) {
+        return assertion.assertionID == assertionID;
+    });
+}
+
+#pragma mark - Simulation
+
+void InMemoryPowerAssertionBackend::setLatency(std::chrono::nanoseconds latency) noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_latency = latency;
+}
+
+void InMemoryPowerAssertionBackend::setFailing(PowerAssertionType type, bool failing) noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_failing[static_cast<size_t>(type)] = failing;
+}
+
+void InMemoryPowerAssertionBackend::simulateLatency() const noexcept
+{
+    chrono::nanoseconds latency;
+    {
+        lock_guard lock { this->_mutex };
+        latency = this->_latency;
+    }
+    if(latency > 0ns)
+    {
+        this_thread::sleep_for(latency);
+    }
+}
+
+#pragma mark - Recorded Calls
+
+size_t InMemoryPowerAssertionBackend::createCount() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_createCount;
+}
+
+size_t InMemoryPowerAssertionBackend::releaseCount() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_releaseCount;
+}
+
+size_t InMemoryPowerAssertionBackend::activeCount() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_assertions.size();
+}
+
+size_t InMemoryPowerAssertionBackend::updateCount() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_updateCount;
+}
+
+void InMemoryPowerAssertionBackend::setRecordedCallCapacity(size_t capacity) noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_calls.clear();
+    this->_calls.shrink_to_fit();
+    this->_calls.reserve(capacity);
+    this->_callCapacity = capacity;
+    this->_recordedCallCount = 0;
+}
+
+vector<InMemoryPowerAssertionBackend::Call> InMemoryPowerAssertionBackend::calls() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    
+    // Once full, the oldest call is overwritten next
+    auto calls = this->_calls;
+    if(calls.size() == this->_callCapacity && !calls.empty())
+    {
+        const auto oldest = static_cast<ptrdiff_t>(this->_recordedCallCount % this->_callCapacity);
+        rotate(calls.begin(), calls.begin() + oldest, calls.end());
+    }
+    return calls;
+}
+
+void InMemoryPowerAssertionBackend::record(const Call& call) noexcept
+{
+    if(this->_callCapacity == 0) { return; }
+    
+    if(this->_calls.size() < this->_callCapacity)
+    {
+        this->_calls.push_back(call);
+    }
+    else
+    {
+        this->_calls[this->_recordedCallCount % this->_callCapacity] = call;
+    }
+    this->_recordedCallCount++;
+}
+
+void InMemoryPowerAssertionBackend::reset() noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_calls.clear();
+    this->_recordedCallCount = 0;
+    this->_createCount = 0;
+    this->_releaseCount = 0;
+    this->_updateCount = 0;
+}
@@ -0,0 +1,58 @@
+//
+//  InMemoryPowerSourceProvider.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/InMemoryPowerSourceProvider.hpp>
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Provider
+
+PowerSourceSnapshot InMemoryPowerSourceProvider::copySnapshot() noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_copyCount++;
+    return this->_snapshot;
+}
+
+bool InMemoryPowerSourceProvider::startObserving(std::function<void()>&& changeHandler) noexcept
+{
+    lock_guard notificationLock { this->_notificationMutex };
+    if(this->_changeHandler != nullopt) { return false; }
+    
+    this->_changeHandler = std::move(changeHandler);
+    return true;
+}
+
+void InMemoryPowerSourceProvider::stopObserving() noexcept
+{
+    lock_guard notificationLock { this->_notificationMutex };
+    this->_changeHandler = nullopt;
+}
+
+#pragma mark - Simulation
+
+void InMemoryPowerSourceProvider::setSnapshot(const PowerSourceSnapshot& snapshot) noexcept
+{
+    {
+        lock_guard lock { this->_mutex };
+        this->_snapshot = snapshot;
+    }
+    
+    lock_guard notificationLock { this->_notificationMutex };
+    if(const auto& changeHandler = this->_changeHandler)
+    {
+        (*changeHandler)();
+    }
+}
+
+size_t InMemoryPowerSourceProvider::copyCount() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_copyCount;
+}
@@ -0,0 +1,35 @@
+//
+//  NullPowerAssertionBackend.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/NullPowerAssertionBackend.hpp>
+
+using namespace std;
+using namespace Awaken;
+
+optional<PowerAssertionID> NullPowerAssertionBackend::create(PowerAssertionType,
+                                                             const std::string&,
+                                                             std::chrono::seconds) noexcept
+{
+    // Identifiers are only unique so that callers can tell assertions apart
+    auto assertionID = this->_nextAssertionID.fetch_add(1, memory_order_relaxed);
+    if(assertionID == 0)
+    {
+        assertionID = this->_nextAssertionID.fetch_add(1, memory_order_relaxed);
+    }
+    return assertionID;
+}
+
+bool NullPowerAssertionBackend::release(PowerAssertionID) noexcept
+{
+    return true;
+}
+
+bool NullPowerAssertionBackend::setTimeout(PowerAssertionID, std::chrono::seconds) noexcept
+{
+    return true;
+}
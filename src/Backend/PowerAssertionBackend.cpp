@@ -0,0 +1,26 @@
+//
+//  PowerAssertionBackend.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/PowerAssertionBackend.hpp>
+
+#if defined(__APPLE__)
+#include <Awaken/IOKitPowerAssertionBackend.hpp>
+namespace Awaken { using SystemPowerAssertionBackend = IOKitPowerAssertionBackend; }
+#else
+#include <Awaken/NullPowerAssertionBackend.hpp>
+namespace Awaken { using SystemPowerAssertionBackend = NullPowerAssertionBackend; }
+#endif
+
+using namespace std;
+using namespace Awaken;
+
+shared_ptr<PowerAssertionBackend> PowerAssertionBackend::systemDefault() noexcept
+{
+    static const auto backend = make_shared<SystemPowerAssertionBackend>();
+    return backend;
+}
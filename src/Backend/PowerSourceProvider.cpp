@@ -0,0 +1,28 @@
+//
+//  PowerSourceProvider.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/PowerSourceProvider.hpp>
+
+#if defined(__APPLE__)
+#include <Awaken/IOKitPowerSourceProvider.hpp>
+namespace Awaken { using SystemPowerSourceProvider = IOKitPowerSourceProvider; }
+#elif defined(__linux__)
+#include <Awaken/SysfsPowerSourceProvider.hpp>
+namespace Awaken { using SystemPowerSourceProvider = SysfsPowerSourceProvider; }
+#else
+#include <Awaken/InMemoryPowerSourceProvider.hpp>
+namespace Awaken { using SystemPowerSourceProvider = InMemoryPowerSourceProvider; }
+#endif
+
+using namespace std;
+using namespace Awaken;
+
+shared_ptr<PowerSourceProvider> PowerSourceProvider::systemDefault() noexcept
+{
+    return make_shared<SystemPowerSourceProvider>();
+}
@@ -0,0 +1,353 @@
+//
+//  SysfsPowerSourceProvider.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#if defined(__linux__)
+
+#include <Awaken/SysfsPowerSourceProvider.hpp>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string_view>
+#include <vector>
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+const filesystem::path SysfsPowerSourceProvider::DefaultRoot { "/sys/class/power_supply" };
+
+#pragma mark - Attributes
+
+namespace Awaken
+{
+
+/// Reads the first line of a sysfs attribute file
+static auto ReadAttribute(const filesystem::path& path) -> optional<string>
+{
+    ifstream file { path };
+    string value;
+    if(!file || !getline(file, value)) { return nullopt; }
+    return value;
+}
+
+static auto ReadNumericAttribute(const filesystem::path& path) -> optional<long long>
+{
+    const auto value = ReadAttribute(path);
+    if(value == nullopt) { return nullopt; }
+    
+    try
+    {
+        return stoll(*value);
+    }
+    catch(...)
+    {
+        return nullopt;
+    }
+}
+
+}
+
+#pragma mark - Observer
+
+struct SysfsPowerSourceProvider::Observer
+{
+    const filesystem::path root;
+    function<void()> changeHandler;
+    int ueventSocket = -1;
+    int inotifyDescriptor = -1;
+    int stopDescriptor = -1;
+    
+    explicit Observer(filesystem::path root) noexcept
+        : root(std::move(root))
+    {
+    }
+    
+    ~Observer() noexcept
+    {
+        for(auto descriptor : { this->ueventSocket, this->inotifyDescriptor, this->stopDescriptor })
+        {
+            if(descriptor >= 0) { close(descriptor); }
+        }
+    }
+    
+    void watchSupplies() noexcept;
+    bool drainUevents() noexcept;
+    bool drainInotify() noexcept;
+};
+
+#pragma mark - Life Cycle
+
+SysfsPowerSourceProvider::SysfsPowerSourceProvider(filesystem::path root) noexcept
+    : _root(std::move(root))
+{
+}
+
+SysfsPowerSourceProvider::~SysfsPowerSourceProvider() noexcept
+{
+    this->stopObserving();
+}
+
+#pragma mark - Snapshot
+
+PowerSourceSnapshot SysfsPowerSourceProvider::copySnapshot() noexcept
+{
+    PowerSourceSnapshot snapshot;
+    
+    // Sort the supplies, so each one keeps its slot between snapshots.
+    vector<filesystem::path> directories;
+    error_code error;
+    for(const auto& entry : filesystem::directory_iterator(this->_root, error))
+    {
+        directories.push_back(entry.path());
+    }
+    sort(directories.begin(), directories.end());
+    
+    for(const auto& directory : directories)
+    {
+        const auto type = ReadAttribute(directory / "type").value_or("");
+        
+        // Batteries of peripherals like mice report a device scope.
+        if(ReadAttribute(directory / "scope").value_or("") == "Device") { continue; }
+        
+        PowerSourceSnapshot::Type sourceType;
+        if(type == "Battery")
+        {
+            sourceType = PowerSourceSnapshot::Type::InternalBattery;
+        }
+        else if(type == "UPS")
+        {
+            sourceType = PowerSourceSnapshot::Type::UPS;
+        }
+        else
+        {
+            continue;
+        }
+        
+        const auto index = snapshot.sourceCount++;
+        if(index >= PowerSourceSnapshot::MaximumSourceCount) { continue; }
+        
+        auto& source = snapshot.sources[index];
+        source.identifier = static_cast<uint32_t>(hash<string>{}(directory.filename().string()));
+        source.type = sourceType;
+        if(const auto capacity = ReadNumericAttribute(directory / "capacity"))
+        {
+            source.capacity = static_cast<float>(*capacity);
+        }
+        source.isCharging = ReadAttribute(directory / "status").value_or("") == "Charging";
+        if(const auto timeToEmpty = ReadNumericAttribute(directory / "time_to_empty_now"))
+        {
+            source.timeRemaining = chrono::duration_cast<chrono::minutes>(chrono::seconds { *timeToEmpty });
+        }
+        
+        // Energies are reported in µWh, charges in µAh.
+        if(const auto energy = ReadNumericAttribute(directory / "energy_full"))
+        {
+            source.energyCapacity = static_cast<float>(*energy / 1e6);
+        }
+        else if(const auto charge = ReadNumericAttribute(directory / "charge_full"))
+        {
+            if(const auto voltage = ReadNumericAttribute(directory / "voltage_min_design"))
+            {
+                source.energyCapacity = static_cast<float>((*charge / 1e6) * (*voltage / 1e6));
+            }
+        }
+    }
+    
+    if(snapshot.sourceCount == 0)
+    {
+        AWAKEN_TRACE(Info, "No power sources found.");
+    }
+    return snapshot;
+}
+
+#pragma mark - Observing
+
+bool SysfsPowerSourceProvider::startObserving(std::function<void()>&& changeHandler) noexcept
+{
+    // Held until the thread is stored, the change handler may stop observing right away.
+    lock_guard lock { this->_threadMutex };
+    if(this->_thread.joinable())
+    {
+        AWAKEN_TRACE(Info, "Already observing power source changes.");
+        return false;
+    }
+    
+    auto observer = make_shared<Observer>(this->_root);
+    
+    // Kernel uevents cover real hardware, sysfs attributes do not
+    // emit inotify events. Inotify covers fake trees used in tests.
+    observer->ueventSocket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if(observer->ueventSocket >= 0)
+    {
+        sockaddr_nl address {};
+        address.nl_family = AF_NETLINK;
+        address.nl_groups = 1;
+        if(::bind(observer->ueventSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            AWAKEN_TRACE(Error, "Failed binding the uevent socket.");
+            close(observer->ueventSocket);
+            observer->ueventSocket = -1;
+        }
+    }
+    
+    observer->inotifyDescriptor = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    observer->stopDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    
+    if((observer->ueventSocket < 0 && observer->inotifyDescriptor < 0) || observer->stopDescriptor < 0)
+    {
+        AWAKEN_TRACE(Error, "Failed observing power source changes.");
+        return false;
+    }
+    
+    observer->watchSupplies();
+    observer->changeHandler = std::move(changeHandler);
+    this->_observer = observer;
+    this->_thread = thread([observer = std::move(observer)]{ observe(*observer); });
+    
+    return true;
+}
+
+void SysfsPowerSourceProvider::stopObserving() noexcept
+{
+    thread observingThread;
+    shared_ptr<Observer> observer;
+    {
+        lock_guard lock { this->_threadMutex };
+        observingThread = std::move(this->_thread);
+        observer = std::move(this->_observer);
+    }
+    if(!observingThread.joinable()) { return; }
+    
+    const uint64_t value = 1;
+    [[maybe_unused]] auto written = write(observer->stopDescriptor, &value, sizeof(value));
+    
+    // Let an in-flight notification finish. When called from it, the
+    // thread keeps the observer, and closes it once the handler returns.
+    if(observingThread.get_id() == this_thread::get_id())
+    {
+        observingThread.detach();
+    }
+    else
+    {
+        observingThread.join();
+    }
+}
+
+void SysfsPowerSourceProvider::Observer::watchSupplies() noexcept
+{
+    if(this->inotifyDescriptor < 0) { return; }
+    
+    constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+    inotify_add_watch(this->inotifyDescriptor, this->root.c_str(), mask);
+    
+    error_code error;
+    for(const auto& entry : filesystem::directory_iterator(this->root, error))
+    {
+        inotify_add_watch(this->inotifyDescriptor, entry.path().c_str(), mask);
+    }
+}
+
+void SysfsPowerSourceProvider::observe(Observer& observer) noexcept
+{
+    array<pollfd, 3> descriptors {{
+        { observer.stopDescriptor, POLLIN, 0 },
+        { observer.ueventSocket, POLLIN, 0 },
+        { observer.inotifyDescriptor, POLLIN, 0 },
+    }};
+    
+    while(true)
+    {
+        if(poll(descriptors.data(), descriptors.size(), -1) < 0)
+        {
+            if(errno == EINTR) { continue; }
+            AWAKEN_TRACE(Error, "Failed waiting for power source changes.");
+            return;
+        }
+        
+        if(descriptors[0].revents != 0) { return; }
+        
+        bool didChange = false;
+        if(descriptors[1].revents & POLLIN)
+        {
+            didChange = observer.drainUevents() || didChange;
+        }
+        if(descriptors[2].revents & POLLIN)
+        {
+            didChange = observer.drainInotify() || didChange;
+        }
+        
+        if(didChange)
+        {
+            observer.changeHandler();
+        }
+    }
+}
+
+bool SysfsPowerSourceProvider::Observer::drainUevents() noexcept
+{
+    bool didChange = false;
+    array<char, 4096> buffer;
+    
+    while(true)
+    {
+        const auto length = recv(this->ueventSocket, buffer.data(), buffer.size(), 0);
+        if(length <= 0) { break; }
+        
+        // A uevent is a list of NUL separated KEY=VALUE strings.
+        string_view message { buffer.data(), static_cast<size_t>(length) };
+        size_t offset = 0;
+        while(offset < message.size())
+        {
+            const auto end = message.find('\0', offset);
+            const auto field = message.substr(offset, end == string_view::npos ? string_view::npos : end - offset);
+            if(field == "SUBSYSTEM=power_supply")
+            {
+                didChange = true;
+                break;
+            }
+            if(end == string_view::npos) { break; }
+            offset = end + 1;
+        }
+    }
+    return didChange;
+}
+
+bool SysfsPowerSourceProvider::Observer::drainInotify() noexcept
+{
+    bool didChange = false;
+    bool didAddSupply = false;
+    alignas(inotify_event) array<char, 4096> buffer;
+    
+    while(true)
+    {
+        const auto length = read(this->inotifyDescriptor, buffer.data(), buffer.size());
+        if(length <= 0) { break; }
+        
+        for(ssize_t offset = 0; offset < length;)
+        {
+            const auto event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+            didAddSupply = didAddSupply || (event->mask & IN_CREATE);
+            didChange = true;
+            offset += sizeof(inotify_event) + event->len;
+        }
+    }
+    
+    if(didAddSupply)
+    {
+        this->watchSupplies();
+    }
+    return didChange;
+}
+
+#endif
@@ -0,0 +1,123 @@
+//
+//  DischargeEstimator.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/DischargeEstimator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using namespace std;
+using namespace Awaken;
+
+using Seconds = chrono::duration<double>;
+
+#pragma mark - Life Cycle
+
+DischargeEstimator::DischargeEstimator(chrono::seconds timeConstant) noexcept
+    : _timeConstant(max(Seconds(timeConstant).count(), 1.0))
+{
+}
+
+#pragma mark - Sampling
+
+void DischargeEstimator::record(const PowerSourceSnapshot& snapshot, Clock::time_point sampledAt) noexcept
+{
+    const auto capacity = snapshot.capacity;
+    if(capacity == PowerSourceSnapshot::CapacityUnavailable || snapshot.isCharging)
+    {
+        this->reset();
+        return;
+    }
+    
+    if(this->_capacity == PowerSourceSnapshot::CapacityUnavailable || capacity > this->_capacity)
+    {
+        this->reset();
+        this->_capacity = capacity;
+        this->_sampledAt = sampledAt;
+        return;
+    }
+    
+    const auto previousSampledAt = std::exchange(this->_sampledAt, sampledAt);
+    if(capacity == this->_capacity) { return; }
+    
+    // The time of the drop before the first one is unknown,
+    // the rate is only measured between two drops.
+    const auto drop = this->_capacity - capacity;
+    if(const auto previousDrop = this->_droppedAt)
+    {
+        const auto elapsed = Seconds(sampledAt - *previousDrop).count();
+        if(elapsed > 0)
+        {
+            const auto rate = drop / elapsed;
+            if(const auto previousRate = this->_rate)
+            {
+                const auto weight = 1.0 - exp(-elapsed / this->_timeConstant);
+                this->_rate = *previousRate + weight * (rate - *previousRate);
+            }
+            else
+            {
+                this->_rate = rate;
+            }
+        }
+    }
+    
+    this->_capacity = capacity;
+    this->_drop = drop;
+    this->_droppedAt = sampledAt;
+    this->_dropUncertainty = sampledAt - previousSampledAt;
+}
+
+void DischargeEstimator::reset() noexcept
+{
+    this->_rate = nullopt;
+    this->_capacity = PowerSourceSnapshot::CapacityUnavailable;
+    this->_drop = 0;
+    this->_droppedAt = nullopt;
+}
+
+#pragma mark - Prediction
+
+optional<double> DischargeEstimator::rate(Clock::time_point now) const noexcept
+{
+    if(!this->_rate || !this->_droppedAt) { return nullopt; }
+    
+    // A battery that did not drop again within the time of the latest
+    // drop at the estimated rate is discharging more slowly.
+    const auto elapsed = Seconds(now - *this->_droppedAt).count();
+    return elapsed > 0 ? min(*this->_rate, this->_drop / elapsed) : *this->_rate;
+}
+
+optional<float> DischargeEstimator::dischargeRate() const noexcept
+{
+    const auto rate = this->rate(this->_sampledAt);
+    if(!rate) { return nullopt; }
+    return static_cast<float>(*rate * 3600);
+}
+
+optional<DischargeEstimator::Clock::duration> DischargeEstimator::timeUntil(float capacity, Clock::time_point now) const noexcept
+{
+    const auto rate = this->rate(now);
+    if(!rate || *rate <= 0) { return nullopt; }
+    if(this->_capacity <= capacity) { return Clock::duration::zero(); }
+    
+    // The reported capacity drops to the next whole percent when the
+    // actual one does, so the prediction starts from the latest drop.
+    const auto crossing = *this->_droppedAt + chrono::duration_cast<Clock::duration>(Seconds((this->_capacity - capacity) / *rate));
+    return max(crossing - now, Clock::duration::zero());
+}
+
+DischargeEstimator::Clock::duration DischargeEstimator::samplingInterval(float capacity, Clock::time_point now) const noexcept
+{
+    const auto remaining = this->timeUntil(capacity, now);
+    if(!remaining) { return DefaultSamplingInterval; }
+    
+    // The latest drop was only noticed by the sample after it, the
+    // capacity may be reached earlier than predicted by that interval.
+    const auto earliest = max(*remaining - this->_dropUncertainty, Clock::duration::zero());
+    return clamp<Clock::duration>(earliest / 2, MinimumSamplingInterval, MaximumSamplingInterval);
+}
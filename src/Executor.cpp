@@ -0,0 +1,251 @@
+//
+//  Executor.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/Executor.hpp>
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include "Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Inline Executor
+
+InlineExecutor& InlineExecutor::shared() noexcept
+{
+    static InlineExecutor executor;
+    return executor;
+}
+
+void InlineExecutor::execute(std::function<void()>&& work) noexcept
+{
+    work();
+}
+
+#pragma mark - Worker Pool Executor
+
+WorkerPoolExecutor& WorkerPoolExecutor::shared() noexcept
+{
+    // Intentionally leaked, handlers may be scheduled during static destruction.
+    static auto executor = new WorkerPoolExecutor();
+    return *executor;
+}
+
+WorkerPoolExecutor::WorkerPoolExecutor(size_t threadCount, size_t queueCapacity) noexcept
+    : _threadCount(max<size_t>(threadCount, 1))
+    , _queue(max<size_t>(queueCapacity, 1))
+{
+}
+
+WorkerPoolExecutor::~WorkerPoolExecutor() noexcept
+{
+    {
+        lock_guard lock { this->_mutex };
+        this->_stopping = true;
+    }
+    this->_condition.notify_all();
+
+    for(auto& thread : this->_threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPoolExecutor::execute(function<void()>&& work) noexcept
+{
+    const auto now = Clock::now();
+    {
+        lock_guard lock { this->_mutex };
+        if(this->_count < this->_queue.size())
+        {
+            auto& item = this->_queue[(this->_head + this->_count) % this->_queue.size()];
+            item.work = std::move(work);
+            item.scheduledAt = now;
+            this->_count++;
+
+            // A pool that never runs a work item never starts a thread, all
+            // of them are started at once so scheduling does not allocate later.
+            if(this->_threads.empty())
+            {
+                this->_threads.reserve(this->_threadCount);
+                for(size_t index = 0; index < this->_threadCount; index++)
+                {
+                    this->_threads.emplace_back([this]{ this->workerLoop(); });
+                }
+            }
+            this->_condition.notify_one();
+            return;
+        }
+    }
+
+    AWAKEN_TRACE(Info, "The executor queue is full, running a work item inline.");
+    this->_metrics.overflows.increment();
+    Metrics::shared().executors.overflows.increment();
+
+    auto item = WorkItem { std::move(work), now };
+    this->run(item);
+}
+
+void WorkerPoolExecutor::run(WorkItem& item) noexcept
+{
+    const auto startedAt = Clock::now();
+    item.work();
+    const auto endedAt = Clock::now();
+
+    for(auto metrics : { &this->_metrics, &Metrics::shared().executors })
+    {
+        metrics->executed.increment();
+        metrics->queueLatency.record(startedAt - item.scheduledAt);
+        metrics->runDuration.record(endedAt - startedAt);
+    }
+}
+
+void WorkerPoolExecutor::workerLoop() noexcept
+{
+    unique_lock lock { this->_mutex };
+    while(true)
+    {
+        this->_condition.wait(lock, [this]{ return this->_count > 0 || this->_stopping; });
+        if(this->_count == 0) { return; }
+
+        auto item = std::move(this->_queue[this->_head]);
+        this->_head = (this->_head + 1) % this->_queue.size();
+        this->_count--;
+
+        lock.unlock();
+        this->run(item);
+        item.work = nullptr;
+        lock.lock();
+    }
+}
+
+#pragma mark - Scheduled Handler
+
+/// Shared with the queued calls, which keep it alive
+/// after the owning `ScheduledHandler` is destroyed.
+struct ScheduledHandler::State
+{
+    atomic<size_t> references { 1 };
+
+    std::mutex mutex;
+    condition_variable condition;
+    function<void()> handler;
+
+    /// Incremented when queued calls are dropped
+    uint64_t generation = 0;
+    bool isScheduled = false;
+    bool isScheduledAgain = false;
+    bool isClosed = false;
+    optional<thread::id> callingThread = nullopt;
+
+    void retain() noexcept
+    {
+        this->references.fetch_add(1, memory_order_relaxed);
+    }
+
+    void release() noexcept
+    {
+        if(this->references.fetch_sub(1, memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    void call(uint64_t generation) noexcept
+    {
+        unique_lock lock { this->mutex };
+        if(this->isClosed || generation != this->generation) { return; }
+
+        if(this->callingThread)
+        {
+            this->isScheduledAgain = true;
+            return;
+        }
+
+        this->callingThread = this_thread::get_id();
+        do
+        {
+            this->isScheduled = false;
+            this->isScheduledAgain = false;
+
+            lock.unlock();
+            if(this->handler != nullptr)
+            {
+                this->handler();
+            }
+            lock.lock();
+        }
+        while(this->isScheduledAgain && !this->isClosed);
+
+        this->callingThread = nullopt;
+        this->condition.notify_all();
+    }
+
+    /// Drops queued calls and waits for a call in progress on another thread
+    void discard(unique_lock<std::mutex>& lock) noexcept
+    {
+        this->generation++;
+        this->isScheduled = false;
+        this->isScheduledAgain = false;
+
+        const auto currentThread = this_thread::get_id();
+        this->condition.wait(lock, [this, currentThread]{
+            return !this->callingThread || *this->callingThread == currentThread;
+        });
+    }
+};
+
+ScheduledHandler::ScheduledHandler(Executor& executor) noexcept
+    : _executor(executor)
+    , _state(new State())
+{
+}
+
+ScheduledHandler::~ScheduledHandler() noexcept
+{
+    {
+        unique_lock lock { this->_state->mutex };
+        this->_state->isClosed = true;
+        this->_state->discard(lock);
+    }
+    this->_state->release();
+}
+
+void ScheduledHandler::setHandler(function<void()>&& handler) noexcept
+{
+    unique_lock lock { this->_state->mutex };
+    this->_state->condition.wait(lock, [this]{ return !this->_state->callingThread; });
+    this->_state->handler = std::move(handler);
+}
+
+void ScheduledHandler::schedule() noexcept
+{
+    const auto state = this->_state;
+    uint64_t generation = 0;
+    {
+        lock_guard lock { state->mutex };
+        if(state->isClosed || state->isScheduled) { return; }
+
+        state->isScheduled = true;
+        generation = state->generation;
+    }
+
+    // Captures two words, which std::function stores without allocating.
+    state->retain();
+    this->_executor.execute([state, generation]{
+        state->call(generation);
+        state->release();
+    });
+}
+
+void ScheduledHandler::discard() noexcept
+{
+    unique_lock lock { this->_state->mutex };
+    this->_state->discard(lock);
+}
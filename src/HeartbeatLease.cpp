@@ -0,0 +1,71 @@
+//
+//  HeartbeatLease.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/HeartbeatLease.hpp>
+#include <Awaken/Metrics.hpp>
+#include "Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Life Cycle
+
+HeartbeatLease::HeartbeatLease(string owner,
+                               chrono::milliseconds ttl,
+                               shared_ptr<PowerAssertionBackend> backend,
+                               TimerWheel& wheel) noexcept
+    : _owner(std::move(owner))
+    , _waiter(new HeartbeatWaiter(ttl, wheel))
+    , _session(this->_owner, std::move(backend), unique_ptr<Waiter>(this->_waiter))
+{
+    this->_endSubscription = this->_session.subscribeToEnd([this](HoldEndReason reason) {
+        this->sessionDidEnd(reason);
+    });
+}
+
+HeartbeatLease::~HeartbeatLease() noexcept
+{
+    this->_session.unsubscribe(this->_endSubscription);
+    this->_session.cancel();
+}
+
+#pragma mark - Heartbeats
+
+bool HeartbeatLease::acquire() noexcept
+{
+    return this->_session.run();
+}
+
+void HeartbeatLease::release() noexcept
+{
+    this->_session.cancel();
+}
+
+bool HeartbeatLease::isHeld() const noexcept
+{
+    return this->_session.isRunning();
+}
+
+Subscription HeartbeatLease::subscribeToMissedHeartbeat(function<void(const string&)>&& handler) noexcept
+{
+    return this->_missedHeartbeatHandlers.subscribe(std::move(handler));
+}
+
+bool HeartbeatLease::unsubscribe(Subscription subscription) noexcept
+{
+    return this->_missedHeartbeatHandlers.unsubscribe(subscription);
+}
+
+void HeartbeatLease::sessionDidEnd(HoldEndReason reason) noexcept
+{
+    if(reason != HoldEndReason::Timeout || !this->_waiter->didMissHeartbeat()) { return; }
+
+    AWAKEN_TRACE(Info, "A lease missed its heartbeat after %{public}lld ms.", this->_waiter->ttl().count());
+    Metrics::shared().missedHeartbeats.increment();
+    this->_missedHeartbeatHandlers(this->_owner);
+}
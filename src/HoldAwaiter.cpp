@@ -0,0 +1,30 @@
+//
+//  HoldAwaiter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/HoldAwaiter.hpp>
+#include <Awaken/Awaken.hpp>
+
+using namespace std;
+using namespace Awaken;
+
+HoldAwaiter::HoldAwaiter(class Awaken& awaken, chrono::seconds timeout, Executor& executor) noexcept
+    : _awaken(awaken)
+    , _timeout(timeout)
+    , _executor(executor)
+    , _continuation(nullptr)
+    , _reason(HoldEndReason::Failed)
+{
+}
+
+bool HoldAwaiter::await_suspend(coroutine_handle<> continuation) noexcept
+{
+    // Resumes immediately with `HoldEndReason::Failed` if the hold
+    // could not be started, otherwise when the hold ends.
+    this->_continuation = continuation;
+    return this->_awaken.beginHold(*this);
+}
@@ -7,72 +7,57 @@
 //
 
 #include <Awaken/IOPowerAssertion.hpp>
-#include <CoreFoundation/CoreFoundation.h>
-#include <IOKit/pwr_mgt/IOPMLib.h>
+#include <utility>
 #include "Log.hpp"
 
 using namespace std;
 using namespace Awaken;
 
+#pragma mark - Life Cycle
 
-#pragma mark - Awaken::CoreFoundationString
-
-namespace Awaken
-{
-class CoreFoundationString
+IOPowerAssertion::IOPowerAssertion() noexcept
+    : IOPowerAssertion(PowerAssertionRegistry::shared())
 {
-public:
-    CoreFoundationString(std::string stdString) noexcept
-    {
-        const auto data = reinterpret_cast<const UInt8*>(stdString.data());
-        const auto size = static_cast<CFIndex>(stdString.size());
-        this->_cfString = CFStringCreateWithBytes(kCFAllocatorDefault,
-                                                  data, size,
-                                                  kCFStringEncodingUTF8,
-                                                  false);
-    }
-    
-    ~CoreFoundationString() { CFRelease(this->_cfString); }
-    
-    CFStringRef get() const noexcept { return this->_cfString; }
-    CFStringRef operator()() const noexcept { return this->_cfString; }
-    
-private:
-    CFStringRef _cfString;
-};
 }
 
-#pragma mark - Life Cycle
+IOPowerAssertion::IOPowerAssertion(shared_ptr<PowerAssertionBackend> backend) noexcept
+    : IOPowerAssertion(PowerAssertionRegistry::forBackend(backend))
+{
+}
 
-IOPowerAssertion::IOPowerAssertion() noexcept
+IOPowerAssertion::IOPowerAssertion(shared_ptr<PowerAssertionRegistry> registry) noexcept
     : timeout(0s)
+    , releaseLinger(0ms)
     , preventUserIdleSystemSleep(false)
     , preventUserIdleDisplaySleep(false)
-    , _systemAssertionID(nullopt)
-    , _displayAssertionID(nullopt)
+    , _registry(std::move(registry))
+    , _systemAssertion(nullptr)
+    , _displayAssertion(nullptr)
 {
 }
 
 IOPowerAssertion::~IOPowerAssertion() noexcept
 {
-    this->cancel();
+    if(this->isRunning())
+    {
+        this->cancel();
+    }
+    this->forgetEntries();
 }
 
 #pragma mark - Running
 
 bool IOPowerAssertion::isRunning() const noexcept
 {
-    return this->_systemAssertionID != nullopt || this->_displayAssertionID != nullopt;
+    return this->_systemAssertion.load(memory_order_acquire) != nullptr
+        || this->_displayAssertion.load(memory_order_acquire) != nullptr;
 }
 
 bool IOPowerAssertion::run() noexcept
 {
     if(this->isRunning())
     {
-        os_log(DefaultLog, "An assertion is already running: %{public}d/%{public}d.",
-               this->_systemAssertionID.value_or(-1),
-               this->_displayAssertionID.value_or(-1)
-               );
+        AWAKEN_TRACE(Info, "An assertion is already running.");
         return false;
     }
     
@@ -81,37 +66,33 @@ bool IOPowerAssertion::run() noexcept
     const auto timeout = this->timeout;
     if(timeout > 0s)
     {
-        os_log(DefaultLog, "Asserting for %{public}lld seconds.", timeout.count());
+        AWAKEN_TRACE(Debug, "Asserting for %{public}lld seconds.", timeout.count());
     }
     else
     {
-        os_log(DefaultLog, "Asserting indefinitely.");
+        AWAKEN_TRACE(Debug, "Asserting indefinitely.");
     }
     
-    const auto interval = static_cast<CFTimeInterval>(timeout.count());
+    auto& registry = *this->_registry;
+    if(this->_entryTimeout != timeout)
+    {
+        this->forgetEntries();
+        this->_entryTimeout = timeout;
+    }
     
     auto preventUserIdleSystemSleep = this->preventUserIdleSystemSleep;
     if(preventUserIdleSystemSleep == true)
     {
-        os_log(DefaultLog, "Preventing user idle system sleep.");
+        AWAKEN_TRACE(Debug, "Preventing user idle system sleep.");
         
-        const auto reason = CFSTR("preventing user idle system sleep");
-        IOPMAssertionID assertionID = 0;
-        auto assertionName = CoreFoundationString(this->name);
-        auto result = IOPMAssertionCreateWithDescription(kIOPMAssertionTypePreventUserIdleSystemSleep,
-                                                         assertionName(),
-                                                         reason, nullptr, nullptr,
-                                                         interval,
-                                                         kIOPMAssertionTimeoutActionRelease,
-                                                         &assertionID);
-        if(result == kIOReturnSuccess)
+        auto& entry = this->entry(this->_systemEntry, PowerAssertionType::PreventUserIdleSystemSleep);
+        if(registry.acquire(entry, this->name))
         {
-            this->_systemAssertionID = assertionID;
+            this->_systemAssertion.store(&entry, memory_order_release);
         }
         else
         {
-            os_log(DefaultLog, "Failed preventing user idle system sleep.");
-            this->_systemAssertionID = nullopt;
+            AWAKEN_TRACE(Error, "Failed preventing user idle system sleep.");
             runResult = false;
         }
     }
@@ -119,38 +100,29 @@ bool IOPowerAssertion::run() noexcept
     auto preventUserIdleDisplaySleep = this->preventUserIdleDisplaySleep;
     if(preventUserIdleDisplaySleep == true)
     {
-        os_log(DefaultLog, "Preventing user idle display sleep.");
+        AWAKEN_TRACE(Debug, "Preventing user idle display sleep.");
         
-        const auto reason = CFSTR("preventing user idle display sleep");
-        IOPMAssertionID assertionID = 0;
-        auto assertionName = CoreFoundationString(this->name);
-        auto result = IOPMAssertionCreateWithDescription(kIOPMAssertionTypePreventUserIdleDisplaySleep,
-                                                         assertionName(),
-                                                         reason, nullptr, nullptr,
-                                                         interval,
-                                                         kIOPMAssertionTimeoutActionRelease,
-                                                         &assertionID);
-        if(result == kIOReturnSuccess)
+        auto& entry = this->entry(this->_displayEntry, PowerAssertionType::PreventUserIdleDisplaySleep);
+        if(registry.acquire(entry, this->name))
         {
-            this->_displayAssertionID = assertionID;
+            this->_displayAssertion.store(&entry, memory_order_release);
         }
         else
         {
-            os_log(DefaultLog, "Failed preventing user idle display sleep.");
-            this->_displayAssertionID = nullopt;
+            AWAKEN_TRACE(Error, "Failed preventing user idle display sleep.");
             runResult = false;
         }
     }
     
     if(runResult == false)
     {
-        if(auto assertionID = this->_systemAssertionID)
+        if(auto entry = this->_systemAssertion.exchange(nullptr, memory_order_acq_rel))
         {
-            IOPMAssertionRelease(*assertionID);
+            registry.release(*entry);
         }
-        if(auto assertionID = this->_displayAssertionID)
+        if(auto entry = this->_displayAssertion.exchange(nullptr, memory_order_acq_rel))
         {
-            IOPMAssertionRelease(*assertionID);
+            registry.release(*entry);
         }
     }
     return runResult;
@@ -160,20 +132,72 @@ bool IOPowerAssertion::cancel() noexcept
 {
     if(!this->isRunning())
     {
-        os_log(DefaultLog, "Cannot cancel, no assertion is running.");
+        AWAKEN_TRACE(Info, "Cannot cancel, no assertion is running.");
         return false;
     }
     
-    if(auto assertionID = this->_systemAssertionID)
+    auto& registry = *this->_registry;
+    const auto releaseLinger = this->releaseLinger;
+    
+    // Each entry is released exactly once,
+    // even by concurrent cancellations.
+    if(auto entry = this->_systemAssertion.exchange(nullptr, memory_order_acq_rel))
     {
-        os_log(DefaultLog, "Cancel system sleep assertion.");
-        IOPMAssertionRelease(*assertionID);
+        AWAKEN_TRACE(Debug, "Cancel system sleep assertion.");
+        registry.release(*entry, releaseLinger);
     }
-    if(auto assertionID = this->_displayAssertionID)
+    if(auto entry = this->_displayAssertion.exchange(nullptr, memory_order_acq_rel))
     {
-        os_log(DefaultLog, "Cancel display sleep assertion.");
-        IOPMAssertionRelease(*assertionID);
+        AWAKEN_TRACE(Debug, "Cancel display sleep assertion.");
+        registry.release(*entry, releaseLinger);
     }
     
     return true;
 }
+
+bool IOPowerAssertion::extend(chrono::steady_clock::duration remaining) noexcept
+{
+    if(!this->isRunning())
+    {
+        AWAKEN_TRACE(Info, "Cannot extend, no assertion is running.");
+        return false;
+    }
+    
+    auto& registry = *this->_registry;
+    const auto deadline = TimerWheel::Clock::now() + remaining;
+    bool extendResult = true;
+    
+    if(auto entry = this->_systemAssertion.load(memory_order_acquire))
+    {
+        extendResult = registry.extend(*entry, deadline) && extendResult;
+    }
+    if(auto entry = this->_displayAssertion.load(memory_order_acquire))
+    {
+        extendResult = registry.extend(*entry, deadline) && extendResult;
+    }
+    return extendResult;
+}
+
+#pragma mark - Entries
+
+PowerAssertionRegistry::Entry& IOPowerAssertion::entry(PowerAssertionRegistry::Entry*& cachedEntry, PowerAssertionType type) noexcept
+{
+    if(cachedEntry == nullptr)
+    {
+        cachedEntry = &this->_registry->entry(type, this->_entryTimeout);
+    }
+    return *cachedEntry;
+}
+
+void IOPowerAssertion::forgetEntries() noexcept
+{
+    // Entries still held by a running assertion stay in use until
+    // they are released, the registry only reuses idle ones.
+    for(auto entry : { exchange(this->_systemEntry, nullptr), exchange(this->_displayEntry, nullptr) })
+    {
+        if(entry != nullptr)
+        {
+            this->_registry->forget(*entry);
+        }
+    }
+}
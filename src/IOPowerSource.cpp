@@ -7,11 +7,7 @@
 //
 
 #include <Awaken/IOPowerSource.hpp>
-#include <CoreFoundation/CoreFoundation.h>
-#include <dispatch/dispatch.h>
-#include <notify.h>
-#include <IOKit/ps/IOPSKeys.h>
-#include <IOKit/ps/IOPowerSources.h>
+#include <Awaken/Metrics.hpp>
 #include "Log.hpp"
 
 using namespace std;
@@ -20,170 +16,251 @@ using namespace Awaken;
 #pragma mark - Life Cycle
 
 IOPowerSource::IOPowerSource() noexcept
-    : _capacity(CapacityUnavailable)
-    , _capacityChangeHandler(nullopt)
-    , _dispatchQueue(nullptr)
-    , _notificationToken(0)
+    : IOPowerSource(PowerSourceProvider::systemDefault())
 {
 }
 
-IOPowerSource::~IOPowerSource() noexcept
+IOPowerSource::IOPowerSource(shared_ptr<PowerSourceProvider> provider, Executor& executor) noexcept
+    : _provider(std::move(provider))
+    , _isObserving(false)
+    , _isRegistered(false)
+    , _capacity(CapacityUnavailable)
+    , _pollingThreshold(0)
+    , _pollTimer([this]{ this->_poll.schedule(); })
+    , _capacityChangeNotification(executor)
+    , _poll(executor)
 {
-    this->unregisterFromCapacityChanges();
+    // The capacity is read when the handler is called, a burst
+    // of changes results in a single call with the latest one.
+    this->_capacityChangeNotification.setHandler([this]{
+        this->notifyCapacityChangeHandlers(this->_cachedSnapshot.load().snapshot.capacity);
+    });
+    this->_poll.setHandler([this]{
+        this->poll();
+    });
 }
 
-#pragma mark - Power Source Infos
-
-namespace Awaken
-{
-
-/// Returns a retained power source dictionary copy,
-/// call `CFRelease()` when done!
-static auto CopyPowerSourceDescription() -> optional<CFDictionaryRef>
+IOPowerSource::~IOPowerSource() noexcept
 {
-    auto powerSources = IOPSCopyPowerSourcesInfo();
-    auto sourcesList = IOPSCopyPowerSourcesList(powerSources);
-    
-    if(CFArrayGetCount(sourcesList) == 0)
+    lock_guard lock { this->_observingMutex };
+    if(this->_isObserving)
     {
-        CFRelease(sourcesList);
-        CFRelease(powerSources);
-        os_log(DefaultLog, "No power sources found.");
-        return nullopt;
+        this->_provider->stopObserving();
     }
-    
-    auto powerSource = IOPSGetPowerSourceDescription(sourcesList, CFArrayGetValueAtIndex(sourcesList, 0));
-    CFRetain(powerSource);
-    
-    CFRelease(sourcesList);
-    CFRelease(powerSources);
-    
-    if(powerSource == nullptr) { return nullopt; }
-    return powerSource;
-}
-
+    this->_isPolling = false;
+    TimerWheel::shared().cancel(this->_pollTimer);
 }
 
 #pragma mark - Battery Capacity
 
-bool IOPowerSource::hasBattery() const noexcept
+PowerSourceSnapshot IOPowerSource::snapshot() const noexcept
 {
-    if(auto powerSourceDescription = CopyPowerSourceDescription())
+    const auto cachedSnapshot = this->_cachedSnapshot.load();
+    if(cachedSnapshot.isValid)
     {
-        const auto key = CFSTR(kIOPSTypeKey);
-        const auto internalBatteryTypeKey = CFSTR(kIOPSInternalBatteryType);
-        
-        auto batteryType = static_cast<CFStringRef>(CFDictionaryGetValue(*powerSourceDescription, key));
-        if(batteryType == nullptr)
-        {
-            CFRelease(*powerSourceDescription);
-            return false;
-        }
-        
-        const bool isInternalBattery = CFEqual(batteryType, internalBatteryTypeKey);
-        CFRelease(*powerSourceDescription);
-        
-        os_log(DefaultLog, "Device has internal battery: %{public}d", isInternalBattery);
-        return isInternalBattery;
+        return cachedSnapshot.snapshot;
     }
-    else
+    
+    // The cache can only be trusted while change notifications
+    // refresh it, otherwise every query reads the provider. Providers
+    // take the refresh mutex from within their notifications, so
+    // observing is started before it is taken.
+    const bool isObserving = this->startObservingIfNeeded();
+    lock_guard lock { this->_refreshMutex };
+    if(const auto cachedSnapshot = this->_cachedSnapshot.load(); cachedSnapshot.isValid)
     {
-        return false;
+        return cachedSnapshot.snapshot;
     }
+    
+    const auto snapshot = this->refresh();
+    if(isObserving)
+    {
+        this->_cachedSnapshot.store({ true, snapshot });
+    }
+    return snapshot;
+}
+
+bool IOPowerSource::hasBattery() const noexcept
+{
+    return this->snapshot().capacity != CapacityUnavailable;
 }
 
 float IOPowerSource::capacity() const noexcept
 {
-    if(auto powerSourceDescription = CopyPowerSourceDescription())
-    {
-        const auto key = CFSTR(kIOPSCurrentCapacityKey);
-        const auto capacity = static_cast<CFNumberRef>(CFDictionaryGetValue(*powerSourceDescription, key));
-        if(capacity == nullptr)
-        {
-            CFRelease(*powerSourceDescription);
-            return CapacityUnavailable;
-        }
-        
-        float capacityValue = CapacityUnavailable;
-        CFNumberGetValue(capacity, kCFNumberFloatType, &capacityValue);
-        CFRelease(*powerSourceDescription);
-        
-        os_log(DefaultLog, "Battery Capacity: %{public}.00f", capacityValue);
-        return capacityValue;
-    }
-    else
+    return this->snapshot().capacity;
+}
+
+#pragma mark - Discharge Prediction
+
+optional<float> IOPowerSource::dischargeRate() const noexcept
+{
+    lock_guard lock { this->_refreshMutex };
+    return this->_estimator.dischargeRate();
+}
+
+optional<chrono::seconds> IOPowerSource::timeUntilCapacity(float capacity) const noexcept
+{
+    lock_guard lock { this->_refreshMutex };
+    const auto remaining = this->_estimator.timeUntil(capacity, DischargeEstimator::Clock::now());
+    if(!remaining) { return nullopt; }
+    return chrono::duration_cast<chrono::seconds>(*remaining);
+}
+
+void IOPowerSource::setPollingThreshold(float capacity) noexcept
+{
+    this->_pollingThreshold.store(capacity, memory_order_relaxed);
+}
+
+#pragma mark - Source Filter
+
+void IOPowerSource::setSourceFilter(PowerSourceFilter filter) noexcept
+{
+    lock_guard lock { this->_refreshMutex };
+    this->_aggregator.setFilter(filter);
+    
+    if(this->_cachedSnapshot.load().isValid)
     {
-        return CapacityUnavailable;
+        this->_cachedSnapshot.store({ true, this->_aggregator.snapshot() });
     }
 }
 
+PowerSourceFilter IOPowerSource::sourceFilter() const noexcept
+{
+    lock_guard lock { this->_refreshMutex };
+    return this->_aggregator.filter();
+}
+
 #pragma mark - Capacity Changes
 
 void IOPowerSource::setCapacityChangeHandler(std::function<void(float)>&& capacityChangeHandler) noexcept
 {
-    this->_capacityChangeHandler = capacityChangeHandler;
+    this->_capacityChangeHandlers.replace(this->_capacityChangeHandlerSubscription, std::move(capacityChangeHandler));
+}
+
+Subscription IOPowerSource::subscribeToCapacityChanges(std::function<void(float)>&& handler) noexcept
+{
+    return this->_capacityChangeHandlers.subscribe(std::move(handler));
+}
+
+bool IOPowerSource::unsubscribe(Subscription subscription) noexcept
+{
+    return this->_capacityChangeHandlers.unsubscribe(subscription);
 }
 
 bool IOPowerSource::registerForCapacityChanges() noexcept
 {
-    if(this->_notificationToken != 0)
+    this->_capacity.store(CapacityUnavailable, memory_order_relaxed);
+    if(this->_isRegistered.exchange(true, memory_order_acq_rel))
     {
-        os_log(DefaultLog, "Already registered for capacity changes.");
+        AWAKEN_TRACE(Info, "Already registered for capacity changes.");
         return false;
     }
     
-    os_log(DefaultLog, "Registering for battery capacity changes…");
-    
-    const auto dispatchQueue = dispatch_queue_create("info.marcel-dierkes.Awaken.IOPowerSourceQueue",
-                                                     DISPATCH_QUEUE_SERIAL);
-    this->_dispatchQueue = dispatchQueue;
-    
-    auto capacityDidChange = [this](){
-        const auto capacity = this->capacity();
-        
-        if(capacity != this->_capacity)
-        {
-            os_log(DefaultLog, "Capacity did change… %{public}.00f", capacity);
-            this->_capacity = capacity;
-            
-            if(const auto& capacityChangeHandler = this->_capacityChangeHandler)
-            {
-                (*capacityChangeHandler)(capacity);
-            }
-        }
-        else
-        {
-            os_log(DefaultLog, "Capacity did NOT change… %{public}.00f", capacity);
-        }
-    };
-    
-    notify_register_dispatch(kIOPSTimeRemainingNotificationKey, &this->_notificationToken, dispatchQueue, ^(int) {
-        capacityDidChange();
-    });
+    AWAKEN_TRACE(Info, "Registering for battery capacity changes…");
     
+    if(!this->startObservingIfNeeded())
+    {
+        AWAKEN_TRACE(Info, "Power source changes are not supported, polling instead.");
+        lock_guard lock { this->_observingMutex };
+        this->_isPolling = true;
+        TimerWheel::shared().schedule(this->_pollTimer, TimerWheel::Clock::now());
+    }
     return true;
 }
 
 bool IOPowerSource::unregisterFromCapacityChanges() noexcept
 {
-    if(this->_notificationToken == 0)
+    if(!this->_isRegistered.exchange(false))
     {
-        os_log(DefaultLog, "Not registered for capacity changes.");
+        AWAKEN_TRACE(Info, "Not registered for capacity changes.");
         return false;
     }
-    else
+    
+    this->_capacity.store(CapacityUnavailable, memory_order_relaxed);
+    
+    {
+        lock_guard lock { this->_observingMutex };
+        this->_isPolling = false;
+        TimerWheel::shared().cancel(this->_pollTimer);
+    }
+    
+    AWAKEN_TRACE(Info, "Unregistered from battery capacity changes.");
+    
+    return true;
+}
+
+#pragma mark - Observing
+
+bool IOPowerSource::startObservingIfNeeded() const noexcept
+{
+    lock_guard lock { this->_observingMutex };
+    if(this->_isObserving) { return true; }
+    
+    auto mutableSelf = const_cast<IOPowerSource*>(this);
+    this->_isObserving = this->_provider->startObserving([mutableSelf]{
+        mutableSelf->powerSourceDidChange();
+    });
+    return this->_isObserving;
+}
+
+PowerSourceSnapshot IOPowerSource::refresh() const noexcept
+{
+    this->_aggregator.update(this->_provider->copySnapshot());
+    const auto snapshot = this->_aggregator.snapshot();
+    this->_estimator.record(snapshot, DischargeEstimator::Clock::now());
+    return snapshot;
+}
+
+void IOPowerSource::powerSourceDidChange() noexcept
+{
+    Metrics::shared().powerSourceNotifications.increment();
+    
+    // Refresh the cache with a single copy of the description,
+    // only the sources that changed are re-aggregated.
     {
-        notify_cancel(this->_notificationToken);
-        this->_notificationToken = 0;
+        lock_guard lock { this->_refreshMutex };
+        this->_cachedSnapshot.store({ true, this->refresh() });
     }
     
-    this->_capacity = CapacityUnavailable;
+    if(!this->_isRegistered) { return; }
     
-    const auto dispatchQueue = static_cast<dispatch_queue_t>(this->_dispatchQueue);
-    dispatch_release(dispatchQueue);
-    this->_dispatchQueue = nullptr;
+    this->_capacityChangeNotification.schedule();
+}
+
+void IOPowerSource::poll() noexcept
+{
+    Metrics::shared().powerSourcePolls.increment();
     
-    os_log(DefaultLog, "Unregistered from battery capacity changes.");
+    PowerSourceSnapshot snapshot;
+    chrono::steady_clock::duration interval;
+    {
+        lock_guard lock { this->_refreshMutex };
+        snapshot = this->refresh();
+        interval = this->_estimator.samplingInterval(this->_pollingThreshold.load(memory_order_relaxed),
+                                                     DischargeEstimator::Clock::now());
+    }
     
-    return true;
+    this->notifyCapacityChangeHandlers(snapshot.capacity);
+    
+    lock_guard lock { this->_observingMutex };
+    if(!this->_isPolling) { return; }
+    
+    AWAKEN_TRACE(Debug, "Polling the power source again in %{public}lld seconds.",
+                 chrono::duration_cast<chrono::seconds>(interval).count());
+    TimerWheel::shared().schedule(this->_pollTimer, TimerWheel::Clock::now() + interval);
+}
+
+void IOPowerSource::notifyCapacityChangeHandlers(float capacity) noexcept
+{
+    if(!this->_isRegistered) { return; }
+    
+    if(this->_capacity.exchange(capacity, memory_order_acq_rel) != capacity)
+    {
+        AWAKEN_TRACE(Debug, "Capacity did change… %{public}.00f", capacity);
+        this->_capacityChangeHandlers(capacity);
+    }
+    else
+    {
+        AWAKEN_TRACE(Debug, "Capacity did NOT change… %{public}.00f", capacity);
+    }
 }
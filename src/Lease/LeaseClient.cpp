@@ -0,0 +1,174 @@
+//
+//  LeaseClient.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/LeaseClient.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::LeaseProtocol;
+
+#pragma mark - Life Cycle
+
+LeaseClient::~LeaseClient() noexcept
+{
+    this->disconnect();
+}
+
+LeaseClient::LeaseClient(LeaseClient&& other) noexcept
+    : _fd(exchange(other._fd, -1))
+    , _request(std::move(other._request))
+{
+}
+
+LeaseClient& LeaseClient::operator=(LeaseClient&& other) noexcept
+{
+    if(this != &other)
+    {
+        this->disconnect();
+        this->_fd = exchange(other._fd, -1);
+        this->_request = std::move(other._request);
+    }
+    return *this;
+}
+
+#pragma mark - Connection
+
+bool LeaseClient::connect(const string& socketPath) noexcept
+{
+    this->disconnect();
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if(socketPath.size() >= sizeof(address.sun_path)) { return false; }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0) { return false; }
+
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+    const int enabled = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+
+    if(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        AWAKEN_TRACE(Info, "Failed connecting to the lease server: %{public}d.", errno);
+        close(fd);
+        return false;
+    }
+
+    this->_fd = fd;
+    return true;
+}
+
+void LeaseClient::disconnect() noexcept
+{
+    if(this->_fd < 0) { return; }
+
+    close(this->_fd);
+    this->_fd = -1;
+}
+
+#pragma mark - Leases
+
+optional<LeaseClient::LeaseID> LeaseClient::acquire(PowerAssertionType type, chrono::milliseconds duration, string_view owner) noexcept
+{
+    if(!this->send(Opcode::Acquire, type, InvalidLeaseID, duration, owner)) { return nullopt; }
+
+    const auto response = this->receive();
+    if(!response || response->status != Status::Ok) { return nullopt; }
+    return response->lease;
+}
+
+bool LeaseClient::renew(LeaseID lease, chrono::milliseconds duration) noexcept
+{
+    if(!this->send(Opcode::Renew, PowerAssertionType::PreventUserIdleSystemSleep, lease, duration)) { return false; }
+
+    const auto response = this->receive();
+    return response && response->status == Status::Ok;
+}
+
+bool LeaseClient::release(LeaseID lease) noexcept
+{
+    if(!this->send(Opcode::Release, PowerAssertionType::PreventUserIdleSystemSleep, lease, 0ms)) { return false; }
+
+    const auto response = this->receive();
+    return response && response->status == Status::Ok;
+}
+
+#pragma mark - Pipelining
+
+bool LeaseClient::send(Opcode opcode, PowerAssertionType type, LeaseID lease, chrono::milliseconds duration, string_view owner) noexcept
+{
+    if(this->_fd < 0) { return false; }
+
+    owner = owner.substr(0, MaximumOwnerLength);
+    const auto clampedDuration = clamp(duration, 0ms, chrono::milliseconds { MaximumDuration });
+    const RequestHeader header {
+        opcode,
+        type,
+        static_cast<uint8_t>(owner.size()),
+        0,
+        lease,
+        static_cast<uint32_t>(clampedDuration.count())
+    };
+
+    this->_request.resize(sizeof(header) + owner.size());
+    memcpy(this->_request.data(), &header, sizeof(header));
+    memcpy(this->_request.data() + sizeof(header), owner.data(), owner.size());
+
+    size_t offset = 0;
+    while(offset < this->_request.size())
+    {
+#if defined(MSG_NOSIGNAL)
+        const auto count = ::send(this->_fd, this->_request.data() + offset, this->_request.size() - offset, MSG_NOSIGNAL);
+#else
+        const auto count = ::send(this->_fd, this->_request.data() + offset, this->_request.size() - offset, 0);
+#endif
+        if(count < 0)
+        {
+            if(errno == EINTR) { continue; }
+
+            this->disconnect();
+            return false;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+optional<Response> LeaseClient::receive() noexcept
+{
+    if(this->_fd < 0) { return nullopt; }
+
+    Response response;
+    auto bytes = reinterpret_cast<uint8_t*>(&response);
+    size_t offset = 0;
+    while(offset < sizeof(response))
+    {
+        const auto count = recv(this->_fd, bytes + offset, sizeof(response) - offset, 0);
+        if(count < 0 && errno == EINTR) { continue; }
+        if(count <= 0)
+        {
+            this->disconnect();
+            return nullopt;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    return response;
+}
@@ -0,0 +1,23 @@
+//
+//  LeaseProtocol.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/LeaseProtocol.hpp>
+#include <cstdlib>
+#include <format>
+#include <unistd.h>
+
+using namespace std;
+
+string Awaken::LeaseProtocol::DefaultSocketPath() noexcept
+{
+    if(const auto runtimeDirectory = getenv("XDG_RUNTIME_DIR"); runtimeDirectory != nullptr && *runtimeDirectory != '\0')
+    {
+        return format("{}/awakend.sock", runtimeDirectory);
+    }
+    return format("/tmp/awakend-{}.sock", getuid());
+}
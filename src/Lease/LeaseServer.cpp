@@ -0,0 +1,598 @@
+//
+//  LeaseServer.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/LeaseServer.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#else
+#include <sys/event.h>
+#endif
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+using namespace Awaken::LeaseProtocol;
+
+#pragma mark - Events
+
+namespace Awaken
+{
+
+/// The number of ready descriptors handled per wake-up
+constexpr size_t EventBatchSize = 256;
+
+struct LeaseServerEvent
+{
+    int fd;
+    bool readable;
+    bool writable;
+    bool failed;
+};
+
+static bool SetNonBlocking(int fd) noexcept
+{
+    const auto flags = fcntl(fd, F_GETFL);
+    return flags >= 0
+        && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0
+        && fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+}
+
+static int CreateEventQueue() noexcept
+{
+#if defined(__linux__)
+    return epoll_create1(EPOLL_CLOEXEC);
+#else
+    return kqueue();
+#endif
+}
+
+/// Waits for ready descriptors
+/// @param timeout The timeout in milliseconds, -1 waits indefinitely
+/// @returns the number of events written, -1 on failure
+static int WaitForEvents(int eventFD, array<LeaseServerEvent, EventBatchSize>& events, int timeout) noexcept
+{
+#if defined(__linux__)
+    array<epoll_event, EventBatchSize> ready;
+    const auto count = epoll_wait(eventFD, ready.data(), static_cast<int>(ready.size()), timeout);
+    for(int index = 0; index < count; index++)
+    {
+        const auto flags = ready[index].events;
+        events[index] = {
+            ready[index].data.fd,
+            (flags & (EPOLLIN | EPOLLHUP)) != 0,
+            (flags & EPOLLOUT) != 0,
+            (flags & EPOLLERR) != 0,
+        };
+    }
+    return count;
+#else
+    array<struct kevent, EventBatchSize> ready;
+    const timespec interval { timeout / 1000, (timeout % 1000) * 1'000'000 };
+    const auto count = kevent(eventFD, nullptr, 0, ready.data(), static_cast<int>(ready.size()),
+                              timeout < 0 ? nullptr : &interval);
+    for(int index = 0; index < count; index++)
+    {
+        const auto& event = ready[index];
+        events[index] = {
+            static_cast<int>(event.ident),
+            event.filter == EVFILT_READ,
+            event.filter == EVFILT_WRITE,
+            (event.flags & EV_ERROR) != 0,
+        };
+    }
+    return count;
+#endif
+}
+
+}
+
+#pragma mark - Life Cycle
+
+LeaseServer::LeaseServer(string socketPath, shared_ptr<PowerAssertionRegistry> registry) noexcept
+    : _socketPath(std::move(socketPath))
+    , _registry(std::move(registry))
+    , _entries({
+        &this->_registry->entry(PowerAssertionType::PreventUserIdleSystemSleep, 0s),
+        &this->_registry->entry(PowerAssertionType::PreventUserIdleDisplaySleep, 0s),
+    })
+{
+}
+
+LeaseServer::~LeaseServer() noexcept
+{
+    for(auto& [fd, client] : this->_clients)
+    {
+        close(fd);
+    }
+    for(auto& [leaseID, lease] : this->_leases)
+    {
+        this->_registry->release(*this->_entries[static_cast<size_t>(lease.type)]);
+    }
+    for(const auto entry : this->_entries)
+    {
+        this->_registry->forget(*entry);
+    }
+
+    for(const auto fd : { this->_listenFD, this->_eventFD, this->_wakeFDs[0], this->_wakeFDs[1] })
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    if(this->_listenFD >= 0)
+    {
+        unlink(this->_socketPath.c_str());
+    }
+}
+
+#pragma mark - Running
+
+bool LeaseServer::listen() noexcept
+{
+    if(this->_listenFD >= 0) { return true; }
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if(this->_socketPath.size() >= sizeof(address.sun_path))
+    {
+        AWAKEN_TRACE(Error, "The lease socket path is too long.");
+        return false;
+    }
+    memcpy(address.sun_path, this->_socketPath.c_str(), this->_socketPath.size() + 1);
+    const auto addressPointer = reinterpret_cast<const sockaddr*>(&address);
+
+    const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || !SetNonBlocking(fd))
+    {
+        AWAKEN_TRACE(Error, "Failed creating the lease socket: %{public}d.", errno);
+        if(fd >= 0) { close(fd); }
+        return false;
+    }
+
+    // A socket file nobody accepts on is left behind by a server
+    // that did not exit cleanly, a live server keeps its socket.
+    struct stat status {};
+    if(lstat(this->_socketPath.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+    {
+        const auto probeFD = socket(AF_UNIX, SOCK_STREAM, 0);
+        const bool isLive = probeFD >= 0 && connect(probeFD, addressPointer, sizeof(address)) == 0;
+        if(probeFD >= 0) { close(probeFD); }
+
+        if(isLive)
+        {
+            AWAKEN_TRACE(Error, "Another lease server is already listening.");
+            close(fd);
+            return false;
+        }
+        unlink(this->_socketPath.c_str());
+    }
+
+    if(::bind(fd, addressPointer, sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+    {
+        AWAKEN_TRACE(Error, "Failed binding the lease socket: %{public}d.", errno);
+        close(fd);
+        return false;
+    }
+
+    this->_eventFD = CreateEventQueue();
+    if(this->_eventFD < 0 || pipe(this->_wakeFDs.data()) != 0
+       || !SetNonBlocking(this->_wakeFDs[0]) || !SetNonBlocking(this->_wakeFDs[1]))
+    {
+        AWAKEN_TRACE(Error, "Failed creating the lease event queue: %{public}d.", errno);
+        close(fd);
+        unlink(this->_socketPath.c_str());
+        return false;
+    }
+
+    this->_listenFD = fd;
+    return this->watch(this->_listenFD, false) && this->watch(this->_wakeFDs[0], false);
+}
+
+bool LeaseServer::run() noexcept
+{
+    if(this->_listenFD < 0) { return false; }
+
+    AWAKEN_TRACE(Info, "Serving leases.");
+    array<LeaseServerEvent, EventBatchSize> events;
+
+    while(!this->_stopping.load(memory_order_acquire))
+    {
+        const auto now = Clock::now();
+        this->expireLeases(now);
+
+        const auto count = WaitForEvents(this->_eventFD, events, this->timeoutUntilNextExpiry(now));
+        if(count < 0)
+        {
+            if(errno == EINTR) { continue; }
+
+            AWAKEN_TRACE(Error, "Failed waiting for lease requests: %{public}d.", errno);
+            break;
+        }
+
+        for(int index = 0; index < count; index++)
+        {
+            const auto& event = events[index];
+            if(event.fd == this->_listenFD)
+            {
+                this->acceptClients();
+                continue;
+            }
+            if(event.fd == this->_wakeFDs[0])
+            {
+                uint8_t buffer[16];
+                while(read(this->_wakeFDs[0], buffer, sizeof(buffer)) > 0) {}
+                continue;
+            }
+
+            // A client closed earlier in this batch may still have events
+            const auto client = this->_clients.find(event.fd);
+            if(client == this->_clients.end()) { continue; }
+
+            if(event.failed)
+            {
+                this->closeClient(event.fd);
+                continue;
+            }
+            if(event.writable && !this->writeClient(client->second)) { continue; }
+            if(event.readable)
+            {
+                this->readClient(client->second);
+            }
+        }
+    }
+
+    // Leases do not outlive the server
+    while(!this->_clients.empty())
+    {
+        this->closeClient(this->_clients.begin()->first);
+    }
+    AWAKEN_TRACE(Info, "Stopped serving leases.");
+    return true;
+}
+
+void LeaseServer::stop() noexcept
+{
+    this->_stopping.store(true, memory_order_release);
+
+    if(this->_wakeFDs[1] >= 0)
+    {
+        const uint8_t byte = 1;
+        [[maybe_unused]] const auto result = write(this->_wakeFDs[1], &byte, sizeof(byte));
+    }
+}
+
+LeaseServer::Statistics LeaseServer::statistics() const noexcept
+{
+    return {
+        .clients = this->_clientCount.load(memory_order_relaxed),
+        .leases = this->_leaseCount.load(memory_order_relaxed),
+        .acquisitions = this->_acquisitions.load(memory_order_relaxed),
+        .renewals = this->_renewals.load(memory_order_relaxed),
+        .releases = this->_releases.load(memory_order_relaxed),
+        .expirations = this->_expirations.load(memory_order_relaxed),
+        .invalidRequests = this->_invalidRequests.load(memory_order_relaxed),
+    };
+}
+
+#pragma mark - Event Queue
+
+bool LeaseServer::watch(int fd, bool writable) noexcept
+{
+#if defined(__linux__)
+    epoll_event event {};
+    event.events = writable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    event.data.fd = fd;
+    if(epoll_ctl(this->_eventFD, EPOLL_CTL_MOD, fd, &event) == 0) { return true; }
+    return errno == ENOENT && epoll_ctl(this->_eventFD, EPOLL_CTL_ADD, fd, &event) == 0;
+#else
+    array<struct kevent, 2> changes;
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, writable ? (EV_ADD | EV_ENABLE) : (EV_ADD | EV_DISABLE), 0, 0, nullptr);
+    return kevent(this->_eventFD, changes.data(), static_cast<int>(changes.size()), nullptr, 0, nullptr) == 0;
+#endif
+}
+
+void LeaseServer::unwatch(int fd) noexcept
+{
+#if defined(__linux__)
+    epoll_ctl(this->_eventFD, EPOLL_CTL_DEL, fd, nullptr);
+#else
+    array<struct kevent, 2> changes;
+    EV_SET(&changes[0], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+    kevent(this->_eventFD, changes.data(), static_cast<int>(changes.size()), nullptr, 0, nullptr);
+#endif
+}
+
+#pragma mark - Clients
+
+void LeaseServer::acceptClients() noexcept
+{
+    while(true)
+    {
+        const auto fd = accept(this->_listenFD, nullptr, nullptr);
+        if(fd < 0)
+        {
+            if(errno == EINTR || errno == ECONNABORTED) { continue; }
+            if(errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                AWAKEN_TRACE(Error, "Failed accepting a lease client: %{public}d.", errno);
+            }
+            return;
+        }
+
+#if defined(SO_NOSIGPIPE)
+        const int enabled = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+        if(!SetNonBlocking(fd) || !this->watch(fd, false))
+        {
+            close(fd);
+            continue;
+        }
+
+        auto& client = this->_clients[fd];
+        client.fd = fd;
+        this->_clientCount.store(this->_clients.size(), memory_order_relaxed);
+    }
+}
+
+bool LeaseServer::readClient(Client& client) noexcept
+{
+    const auto count = recv(client.fd, client.input.data() + client.inputLength,
+                            client.input.size() - client.inputLength, 0);
+    if(count == 0 || (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+    {
+        this->closeClient(client.fd);
+        return false;
+    }
+    if(count < 0) { return true; }
+    client.inputLength += static_cast<size_t>(count);
+
+    // Handle every complete request, a partial one is kept for the next read.
+    size_t offset = 0;
+    while(client.inputLength - offset >= sizeof(RequestHeader))
+    {
+        RequestHeader header;
+        memcpy(&header, client.input.data() + offset, sizeof(header));
+
+        const auto requestSize = sizeof(RequestHeader) + header.ownerLength;
+        if(header.ownerLength > MaximumOwnerLength)
+        {
+            this->respond(client, header.opcode, Status::InvalidRequest, header.lease);
+            if(this->writeClient(client)) { this->closeClient(client.fd); }
+            return false;
+        }
+        if(client.inputLength - offset < requestSize) { break; }
+
+        const auto owner = string_view {
+            reinterpret_cast<const char*>(client.input.data() + offset + sizeof(RequestHeader)),
+            header.ownerLength
+        };
+        if(!this->handleRequest(client, header, owner))
+        {
+            // A failed write has already closed the client
+            if(this->writeClient(client)) { this->closeClient(client.fd); }
+            return false;
+        }
+        offset += requestSize;
+    }
+
+    client.inputLength -= offset;
+    memmove(client.input.data(), client.input.data() + offset, client.inputLength);
+
+    return this->writeClient(client);
+}
+
+bool LeaseServer::writeClient(Client& client) noexcept
+{
+    size_t offset = 0;
+    while(offset < client.output.size())
+    {
+#if defined(MSG_NOSIGNAL)
+        const auto count = send(client.fd, client.output.data() + offset, client.output.size() - offset, MSG_NOSIGNAL);
+#else
+        const auto count = send(client.fd, client.output.data() + offset, client.output.size() - offset, 0);
+#endif
+        if(count < 0)
+        {
+            if(errno == EINTR) { continue; }
+            if(errno == EAGAIN || errno == EWOULDBLOCK) { break; }
+
+            this->closeClient(client.fd);
+            return false;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    client.output.erase(client.output.begin(), client.output.begin() + static_cast<ptrdiff_t>(offset));
+
+    if(client.output.size() > MaximumPendingOutput)
+    {
+        AWAKEN_TRACE(Info, "Disconnecting a lease client that stopped reading.");
+        this->closeClient(client.fd);
+        return false;
+    }
+
+    // Only wait for writability while responses are pending
+    const bool isPending = !client.output.empty();
+    if(isPending != client.isWaitingForWritability)
+    {
+        client.isWaitingForWritability = isPending;
+        this->watch(client.fd, isPending);
+    }
+    return true;
+}
+
+void LeaseServer::closeClient(int fd) noexcept
+{
+    const auto client = this->_clients.find(fd);
+    if(client == this->_clients.end()) { return; }
+
+    // A disconnected client drops all of its leases
+    const auto leases = std::move(client->second.leases);
+    for(const auto leaseID : leases)
+    {
+        if(this->_leases.contains(leaseID))
+        {
+            this->_releases.fetch_add(1, memory_order_relaxed);
+            this->endLease(leaseID);
+        }
+    }
+
+    this->unwatch(fd);
+    close(fd);
+    this->_clients.erase(client);
+    this->_clientCount.store(this->_clients.size(), memory_order_relaxed);
+}
+
+#pragma mark - Requests
+
+bool LeaseServer::handleRequest(Client& client, const RequestHeader& header, string_view owner) noexcept
+{
+    const auto duration = chrono::milliseconds { header.durationMilliseconds };
+
+    switch(header.opcode)
+    {
+        case Opcode::Acquire:
+        {
+            if(header.type != PowerAssertionType::PreventUserIdleSystemSleep
+               && header.type != PowerAssertionType::PreventUserIdleDisplaySleep)
+            {
+                break;
+            }
+
+            auto& entry = *this->_entries[static_cast<size_t>(header.type)];
+            const auto name = owner.empty() ? string { "awakend" } : string { owner };
+            if(!this->_registry->acquire(entry, name))
+            {
+                this->respond(client, header.opcode, Status::Failed, InvalidLeaseID);
+                return true;
+            }
+
+            const auto leaseID = this->nextLeaseID();
+            const auto expiry = Clock::now() + duration;
+            this->_leases.emplace(leaseID, Lease { client.fd, header.type, expiry, name });
+            this->_expiries.insert({ expiry, leaseID });
+            client.leases.push_back(leaseID);
+
+            this->_acquisitions.fetch_add(1, memory_order_relaxed);
+            this->_leaseCount.store(this->_leases.size(), memory_order_relaxed);
+            this->respond(client, header.opcode, Status::Ok, leaseID);
+            return true;
+        }
+        case Opcode::Renew:
+        {
+            const auto lease = this->_leases.find(header.lease);
+            if(lease == this->_leases.end() || lease->second.client != client.fd)
+            {
+                this->respond(client, header.opcode, Status::UnknownLease, header.lease);
+                return true;
+            }
+
+            // The lease's entry is moved in place, which does not allocate
+            auto expiry = this->_expiries.extract({ lease->second.expiry, header.lease });
+            lease->second.expiry = Clock::now() + duration;
+            expiry.value().time = lease->second.expiry;
+            this->_expiries.insert(std::move(expiry));
+
+            this->_renewals.fetch_add(1, memory_order_relaxed);
+            this->respond(client, header.opcode, Status::Ok, header.lease);
+            return true;
+        }
+        case Opcode::Release:
+        {
+            const auto lease = this->_leases.find(header.lease);
+            if(lease == this->_leases.end() || lease->second.client != client.fd)
+            {
+                this->respond(client, header.opcode, Status::UnknownLease, header.lease);
+                return true;
+            }
+
+            this->endLease(header.lease);
+            this->_releases.fetch_add(1, memory_order_relaxed);
+            this->respond(client, header.opcode, Status::Ok, header.lease);
+            return true;
+        }
+    }
+
+    this->_invalidRequests.fetch_add(1, memory_order_relaxed);
+    this->respond(client, header.opcode, Status::InvalidRequest, header.lease);
+    return false;
+}
+
+void LeaseServer::respond(Client& client, Opcode opcode, Status status, LeaseID leaseID) noexcept
+{
+    const Response response { opcode, status, 0, leaseID };
+    const auto bytes = reinterpret_cast<const uint8_t*>(&response);
+    client.output.insert(client.output.end(), bytes, bytes + sizeof(response));
+}
+
+#pragma mark - Leases
+
+LeaseServer::LeaseID LeaseServer::nextLeaseID() noexcept
+{
+    // Skips the invalid identifier and identifiers still in use after wrapping around
+    do
+    {
+        this->_lastLeaseID++;
+    }
+    while(this->_lastLeaseID == InvalidLeaseID || this->_leases.contains(this->_lastLeaseID));
+
+    return this->_lastLeaseID;
+}
+
+void LeaseServer::endLease(LeaseID leaseID) noexcept
+{
+    const auto lease = this->_leases.find(leaseID);
+    if(lease == this->_leases.end()) { return; }
+
+    if(const auto client = this->_clients.find(lease->second.client); client != this->_clients.end())
+    {
+        auto& leases = client->second.leases;
+        if(const auto position = ranges::find(leases, leaseID); position != leases.end())
+        {
+            *position = leases.back();
+            leases.pop_back();
+        }
+    }
+
+    this->_registry->release(*this->_entries[static_cast<size_t>(lease->second.type)]);
+    this->_expiries.erase({ lease->second.expiry, leaseID });
+    this->_leases.erase(lease);
+    this->_leaseCount.store(this->_leases.size(), memory_order_relaxed);
+}
+
+void LeaseServer::expireLeases(Clock::time_point now) noexcept
+{
+    // Ending a lease removes its entry
+    while(!this->_expiries.empty() && this->_expiries.begin()->time <= now)
+    {
+        const auto leaseID = this->_expiries.begin()->lease;
+
+        AWAKEN_TRACE(Info, "Lease %{public}u expired.", leaseID);
+        this->_expirations.fetch_add(1, memory_order_relaxed);
+        this->endLease(leaseID);
+    }
+}
+
+int LeaseServer::timeoutUntilNextExpiry(Clock::time_point now) const noexcept
+{
+    if(this->_expiries.empty()) { return -1; }
+
+    const auto remaining = chrono::ceil<chrono::milliseconds>(this->_expiries.begin()->time - now);
+    return static_cast<int>(clamp<chrono::milliseconds::rep>(remaining.count(), 0, INT32_MAX));
+}
@@ -9,6 +9,12 @@
 #ifndef Log_hpp
 #define Log_hpp
 
+// Events are recorded with AWAKEN_TRACE, the unified log
+// is only written to by `Trace::osLogSink()`.
+#include <Awaken/Trace.hpp>
+
+#if __has_include(<os/log.h>)
+
 #include <os/log.h>
 
 namespace Awaken
@@ -16,4 +22,6 @@ namespace Awaken
 const auto DefaultLog = os_log_create("info.marcel-dierkes.Awaken", "Awaken");
 }
 
+#endif
+
 #endif /* Log_hpp */
@@ -0,0 +1,209 @@
+//
+//  Metrics.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/Metrics.hpp>
+#include <bit>
+#include <sstream>
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Histogram
+
+size_t Histogram::bucketIndex(uint64_t value) noexcept
+{
+    if(value < SubBucketCount) { return static_cast<size_t>(value); }
+    
+    const auto msb = static_cast<unsigned>(63 - countl_zero(value));
+    const auto group = msb - SubBucketBits + 1;
+    const auto subBucket = (value >> (msb - SubBucketBits)) & (SubBucketCount - 1);
+    return group * SubBucketCount + static_cast<size_t>(subBucket);
+}
+
+uint64_t Histogram::bucketUpperBound(size_t index) noexcept
+{
+    if(index < SubBucketCount) { return index; }
+    
+    const auto group = index / SubBucketCount;
+    const auto subBucket = index % SubBucketCount;
+    const auto shift = group - 1;
+    const auto lowerBound = (SubBucketCount + subBucket) << shift;
+    return lowerBound + ((uint64_t { 1 } << shift) - 1);
+}
+
+void Histogram::record(chrono::nanoseconds duration) noexcept
+{
+    const auto value = static_cast<uint64_t>(max<chrono::nanoseconds::rep>(duration.count(), 0));
+    this->_counts[bucketIndex(value)].fetch_add(1, memory_order_relaxed);
+    this->_count.fetch_add(1, memory_order_relaxed);
+    this->_sum.fetch_add(value, memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept
+{
+    Snapshot snapshot;
+    for(size_t index = 0; index < BucketCount; index++)
+    {
+        snapshot.counts[index] = this->_counts[index].load(memory_order_relaxed);
+    }
+    snapshot.count = this->_count.load(memory_order_relaxed);
+    snapshot.sum = this->_sum.load(memory_order_relaxed);
+    return snapshot;
+}
+
+chrono::nanoseconds Histogram::Snapshot::percentile(double fraction) const noexcept
+{
+    uint64_t total = 0;
+    for(const auto count : this->counts)
+    {
+        total += count;
+    }
+    if(total == 0) { return chrono::nanoseconds { 0 }; }
+    
+    const auto rank = static_cast<uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+    uint64_t cumulative = 0;
+    for(size_t index = 0; index < BucketCount; index++)
+    {
+        cumulative += this->counts[index];
+        if(cumulative >= rank)
+        {
+            return chrono::nanoseconds { static_cast<chrono::nanoseconds::rep>(bucketUpperBound(index)) };
+        }
+    }
+    return chrono::nanoseconds::max();
+}
+
+#pragma mark - Metrics
+
+Metrics& Metrics::shared() noexcept
+{
+    // Intentionally leaked, sessions may end during static destruction.
+    static auto metrics = new Metrics();
+    return *metrics;
+}
+
+#pragma mark - Prometheus
+
+namespace Awaken
+{
+
+static constexpr const char* HoldEndReasonLabels[HoldEndReasonCount] = {
+    "timeout", "cancelled", "battery_threshold", "failed",
+};
+
+static constexpr const char* PowerAssertionTypeLabels[PowerAssertionTypeCount] = {
+    "prevent_user_idle_system_sleep", "prevent_user_idle_display_sleep",
+};
+
+static void WriteHeader(ostringstream& stream, const char* name, const char* type, const char* help)
+{
+    stream << "# HELP " << name << " " << help << "\n";
+    stream << "# TYPE " << name << " " << type << "\n";
+}
+
+/// The exported buckets end at every fourth power of two from about
+/// 1 µs to 78 h, the same for every histogram and every export.
+static constexpr size_t FirstExportedGroup = 8;
+static constexpr size_t LastExportedGroup = 46;
+static constexpr size_t ExportedGroupStride = 2;
+
+static void WriteHistogram(ostringstream& stream, const char* name, const char* help, const Histogram& histogram)
+{
+    WriteHeader(stream, name, "histogram", help);
+    
+    // The total is summed from the same bucket counts, so the
+    // buckets never exceed it while values are being recorded.
+    const auto snapshot = histogram.snapshot();
+    uint64_t cumulative = 0;
+    size_t index = 0;
+    for(size_t group = FirstExportedGroup; group <= LastExportedGroup; group += ExportedGroupStride)
+    {
+        const auto end = (group + 1) * Histogram::SubBucketCount;
+        for(; index < end; index++)
+        {
+            cumulative += snapshot.counts[index];
+        }
+        const auto upperBound = Histogram::bucketUpperBound(end - 1);
+        stream << name << "_bucket{le=\"" << static_cast<double>(upperBound) / 1e9 << "\"} " << cumulative << "\n";
+    }
+    for(; index < Histogram::BucketCount; index++)
+    {
+        cumulative += snapshot.counts[index];
+    }
+    stream << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+    stream << name << "_sum " << static_cast<double>(snapshot.sum) / 1e9 << "\n";
+    stream << name << "_count " << cumulative << "\n";
+}
+
+}
+
+string Metrics::prometheusText() const
+{
+    ostringstream stream;
+    stream.precision(12);
+    
+    WriteHeader(stream, "awaken_sessions_started_total", "counter", "Sessions started with run().");
+    stream << "awaken_sessions_started_total " << this->sessions.started.value() << "\n";
+    
+    WriteHeader(stream, "awaken_sessions_active", "gauge", "Sessions that are currently running.");
+    stream << "awaken_sessions_active " << this->sessions.active.value() << "\n";
+    
+    WriteHeader(stream, "awaken_sessions_ended_total", "counter", "Sessions that ended, by reason.");
+    for(size_t index = 0; index < HoldEndReasonCount; index++)
+    {
+        stream << "awaken_sessions_ended_total{reason=\"" << HoldEndReasonLabels[index] << "\"} "
+               << this->sessions.ended[index].value() << "\n";
+    }
+    
+    WriteHistogram(stream, "awaken_hold_duration_seconds", "How long sessions were running.", this->sessions.holdDuration);
+    WriteHistogram(stream, "awaken_handler_latency_seconds", "Delay between the end of a session and its handler.", this->sessions.handlerLatency);
+    
+    WriteHeader(stream, "awaken_assertions_held", "gauge", "Backend power assertions that are currently held.");
+    for(size_t index = 0; index < PowerAssertionTypeCount; index++)
+    {
+        stream << "awaken_assertions_held{type=\"" << PowerAssertionTypeLabels[index] << "\"} "
+               << this->assertions[index].held.value() << "\n";
+    }
+    
+    WriteHeader(stream, "awaken_backend_calls_total", "counter", "Successful power assertion backend calls.");
+    for(size_t index = 0; index < PowerAssertionTypeCount; index++)
+    {
+        const auto& assertion = this->assertions[index];
+        const auto type = PowerAssertionTypeLabels[index];
+        stream << "awaken_backend_calls_total{type=\"" << type << "\",call=\"create\"} " << assertion.creates.value() << "\n";
+        stream << "awaken_backend_calls_total{type=\"" << type << "\",call=\"release\"} " << assertion.releases.value() << "\n";
+        stream << "awaken_backend_calls_total{type=\"" << type << "\",call=\"update\"} " << assertion.updates.value() << "\n";
+    }
+    
+    WriteHeader(stream, "awaken_backend_failures_total", "counter", "Failed power assertion backend calls.");
+    for(size_t index = 0; index < PowerAssertionTypeCount; index++)
+    {
+        stream << "awaken_backend_failures_total{type=\"" << PowerAssertionTypeLabels[index] << "\"} "
+               << this->assertions[index].failures.value() << "\n";
+    }
+    
+    WriteHeader(stream, "awaken_wakeups_total", "counter", "Thread wakeups caused by the library.");
+    stream << "awaken_wakeups_total{source=\"thread_waiter\"} " << this->threadWaiterWakeups.value() << "\n";
+    stream << "awaken_wakeups_total{source=\"timer_wheel\"} " << this->timerWheelWakeups.value() << "\n";
+    stream << "awaken_wakeups_total{source=\"power_source\"} " << this->powerSourceNotifications.value() << "\n";
+    stream << "awaken_wakeups_total{source=\"power_source_poll\"} " << this->powerSourcePolls.value() << "\n";
+    
+    WriteHeader(stream, "awaken_missed_heartbeats_total", "counter", "Heartbeat leases that were not renewed in time.");
+    stream << "awaken_missed_heartbeats_total " << this->missedHeartbeats.value() << "\n";
+    
+    WriteHeader(stream, "awaken_executor_work_items_total", "counter", "Work items run by worker pool executors.");
+    stream << "awaken_executor_work_items_total " << this->executors.executed.value() << "\n";
+    
+    WriteHeader(stream, "awaken_executor_overflows_total", "counter", "Work items run inline because the executor queue was full.");
+    stream << "awaken_executor_overflows_total " << this->executors.overflows.value() << "\n";
+    
+    WriteHistogram(stream, "awaken_executor_queue_latency_seconds", "How long work items waited in the executor queue.", this->executors.queueLatency);
+    WriteHistogram(stream, "awaken_executor_run_duration_seconds", "How long work items ran on the executor.", this->executors.runDuration);
+    
+    return stream.str();
+}
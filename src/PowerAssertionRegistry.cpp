@@ -0,0 +1,351 @@
+//
+//  PowerAssertionRegistry.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/PowerAssertionRegistry.hpp>
+#include <Awaken/Metrics.hpp>
+#include <algorithm>
+#include <unordered_map>
+#include "Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Entry
+
+PowerAssertionRegistry::Entry::Entry(PowerAssertionRegistry& registry, PowerAssertionType type, chrono::seconds timeout) noexcept
+    : _type(type)
+    , _timeout(timeout)
+    , _assertionID(nullopt)
+    , _lingerDeadline(nullopt)
+    , _lingerTimer([&registry, this]{ registry.lingerDidExpire(*this); })
+{
+}
+
+#pragma mark - Life Cycle
+
+shared_ptr<PowerAssertionRegistry> PowerAssertionRegistry::shared() noexcept
+{
+    static const auto registry = forBackend(PowerAssertionBackend::systemDefault());
+    return registry;
+}
+
+shared_ptr<PowerAssertionRegistry> PowerAssertionRegistry::forBackend(const shared_ptr<PowerAssertionBackend>& backend) noexcept
+{
+    static mutex registriesMutex;
+    static unordered_map<PowerAssertionBackend*, weak_ptr<PowerAssertionRegistry>> registries;
+
+    lock_guard lock { registriesMutex };
+
+    auto& registry = registries[backend.get()];
+    if(auto existingRegistry = registry.lock())
+    {
+        return existingRegistry;
+    }
+
+    auto newRegistry = make_shared<PowerAssertionRegistry>(backend);
+    registry = newRegistry;
+    return newRegistry;
+}
+
+PowerAssertionRegistry::PowerAssertionRegistry(shared_ptr<PowerAssertionBackend> backend) noexcept
+    : _backend(std::move(backend))
+{
+}
+
+PowerAssertionRegistry::~PowerAssertionRegistry() noexcept
+{
+    for(auto& [key, entry] : this->_entries)
+    {
+        TimerWheel::shared().cancel(entry->_lingerTimer);
+        if(auto assertionID = entry->_assertionID)
+        {
+            AWAKEN_TRACE(Error, "Releasing leaked power assertion %{public}d.", *assertionID);
+            this->_backend->release(*assertionID);
+        }
+    }
+}
+
+#pragma mark - Entries
+
+PowerAssertionRegistry::Entry& PowerAssertionRegistry::entry(PowerAssertionType type, chrono::seconds timeout) noexcept
+{
+    lock_guard lock { this->_entriesMutex };
+
+    const auto key = make_pair(type, timeout.count());
+    auto iterator = this->_entries.find(key);
+    if(iterator == this->_entries.end())
+    {
+        if(auto entry = this->reuseEntry(type, timeout))
+        {
+            entry->_users++;
+            return *entry;
+        }
+        iterator = this->_entries.emplace(key, make_unique<Entry>(*this, type, timeout)).first;
+    }
+
+    auto& entry = *iterator->second;
+    if(entry._users++ == 0)
+    {
+        erase(this->_unusedEntries, &entry);
+    }
+    return entry;
+}
+
+void PowerAssertionRegistry::forget(Entry& entry) noexcept
+{
+    lock_guard lock { this->_entriesMutex };
+    if(entry._users == 0)
+    {
+        AWAKEN_TRACE(Error, "Forgot a power assertion entry that was not used.");
+        return;
+    }
+    if(--entry._users == 0)
+    {
+        this->_unusedEntries.push_back(&entry);
+    }
+}
+
+PowerAssertionRegistry::Entry* PowerAssertionRegistry::reuseEntry(PowerAssertionType type, chrono::seconds timeout) noexcept
+{
+    for(auto iterator = this->_unusedEntries.begin(); iterator != this->_unusedEntries.end(); iterator++)
+    {
+        auto& entry = **iterator;
+
+        // A lingering assertion stays with its key until it is released.
+        unique_lock entryLock { entry._mutex };
+        if(entry._references.load(memory_order_acquire) > 0 || entry._assertionID != nullopt) { continue; }
+
+        auto node = this->_entries.extract({ entry._type, entry._timeout.count() });
+        node.key() = { type, timeout.count() };
+        entry._type = type;
+        entry._timeout = timeout;
+        entryLock.unlock();
+
+        this->_entries.insert(std::move(node));
+        this->_unusedEntries.erase(iterator);
+        return &entry;
+    }
+    return nullptr;
+}
+
+bool PowerAssertionRegistry::acquire(Entry& entry, const string& name) noexcept
+{
+    switch(this->reference(entry, name))
+    {
+        case Reference::Failed: return false;
+        case Reference::Created: return true;
+        case Reference::Joined: break;
+    }
+
+    // The backend assertion was created with the timeout of an earlier
+    // session, it must not expire before this session's timeout.
+    if(entry._timeout == 0s || this->extend(entry, TimerWheel::Clock::now() + entry._timeout))
+    {
+        return true;
+    }
+    this->release(entry);
+    return false;
+}
+
+PowerAssertionRegistry::Reference PowerAssertionRegistry::reference(Entry& entry, const string& name) noexcept
+{
+    // Fast path: the assertion is already held by another session.
+    auto references = entry._references.load(memory_order_acquire);
+    while(references > 0)
+    {
+        if(entry._references.compare_exchange_weak(references, references + 1,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire))
+        {
+            this->_acquisitions.fetch_add(1, memory_order_relaxed);
+            return Reference::Joined;
+        }
+    }
+
+    // Slow path: transitions between zero and one reference
+    // only happen while holding the entry mutex.
+    lock_guard lock { entry._mutex };
+    if(entry._references.load(memory_order_acquire) > 0)
+    {
+        entry._references.fetch_add(1, memory_order_acq_rel);
+        this->_acquisitions.fetch_add(1, memory_order_relaxed);
+        return Reference::Joined;
+    }
+
+    // The backend assertion is still held during the linger period,
+    // a pending linger timer finds the entry in use and does nothing.
+    // One that the backend has already timed out is replaced.
+    if(entry._lingerDeadline != nullopt)
+    {
+        const auto expiry = entry._backendExpiry.load(memory_order_relaxed);
+        if(expiry == 0 || TimerWheel::Clock::now().time_since_epoch().count() < expiry)
+        {
+            entry._lingerDeadline = nullopt;
+            entry._references.store(1, memory_order_release);
+            this->_lingerReattachments.fetch_add(1, memory_order_relaxed);
+            this->_acquisitions.fetch_add(1, memory_order_relaxed);
+            return Reference::Joined;
+        }
+        this->releaseBackendAssertion(entry);
+    }
+
+    auto& metrics = Metrics::shared().assertion(entry._type);
+    const auto assertionID = this->_backend->create(entry._type, name, entry._timeout);
+    if(assertionID == nullopt)
+    {
+        this->_backendFailures.fetch_add(1, memory_order_relaxed);
+        metrics.failures.increment();
+        return Reference::Failed;
+    }
+    metrics.creates.increment();
+    metrics.held.increment();
+
+    const auto expiry = entry._timeout > 0s ? TimerWheel::Clock::now() + entry._timeout : TimerWheel::Clock::time_point {};
+    entry._backendExpiry.store(expiry.time_since_epoch().count(), memory_order_relaxed);
+    entry._assertionID = assertionID;
+    entry._references.store(1, memory_order_release);
+    this->_backendCreates.fetch_add(1, memory_order_relaxed);
+    this->_acquisitions.fetch_add(1, memory_order_relaxed);
+    return Reference::Created;
+}
+
+void PowerAssertionRegistry::release(Entry& entry, chrono::milliseconds linger) noexcept
+{
+    // Fast path: other sessions still hold the assertion.
+    auto references = entry._references.load(memory_order_acquire);
+    while(references > 1)
+    {
+        if(entry._references.compare_exchange_weak(references, references - 1,
+                                                    memory_order_acq_rel,
+                                                    memory_order_acquire))
+        {
+            this->_releases.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+    }
+
+    lock_guard lock { entry._mutex };
+    const auto previousReferences = entry._references.fetch_sub(1, memory_order_acq_rel);
+    if(previousReferences == 0)
+    {
+        AWAKEN_TRACE(Error, "Released a power assertion that was not acquired.");
+        entry._references.store(0, memory_order_release);
+        return;
+    }
+    this->_releases.fetch_add(1, memory_order_relaxed);
+
+    if(previousReferences > 1) { return; }
+
+    if(linger > 0ms && entry._assertionID != nullopt)
+    {
+        const auto deadline = TimerWheel::Clock::now() + linger;
+        entry._lingerDeadline = deadline;
+        TimerWheel::shared().schedule(entry._lingerTimer, deadline);
+        return;
+    }
+
+    this->releaseBackendAssertion(entry);
+}
+
+bool PowerAssertionRegistry::extend(Entry& entry, TimerWheel::Clock::time_point deadline) noexcept
+{
+    using Clock = TimerWheel::Clock;
+    
+    // Indefinite assertions and assertions that already outlive
+    // the deadline do not need a backend call.
+    const auto isCovered = [&entry, deadline]{
+        const auto expiry = entry._backendExpiry.load(memory_order_acquire);
+        return expiry == 0 || Clock::time_point { Clock::duration { expiry } } >= deadline;
+    };
+    if(isCovered()) { return true; }
+    
+    lock_guard lock { entry._mutex };
+    if(isCovered()) { return true; }
+    
+    const auto assertionID = entry._assertionID;
+    if(assertionID == nullopt) { return false; }
+    
+    const auto now = Clock::now();
+    const auto timeout = max(chrono::ceil<chrono::seconds>(deadline - now), 1s);
+    auto& metrics = Metrics::shared().assertion(entry._type);
+    if(!this->_backend->setTimeout(*assertionID, timeout))
+    {
+        this->_backendFailures.fetch_add(1, memory_order_relaxed);
+        metrics.failures.increment();
+        return false;
+    }
+    metrics.updates.increment();
+    
+    entry._backendExpiry.store((now + timeout).time_since_epoch().count(), memory_order_release);
+    this->_backendUpdates.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+void PowerAssertionRegistry::releaseBackendAssertion(Entry& entry) noexcept
+{
+    if(auto assertionID = entry._assertionID)
+    {
+        auto& metrics = Metrics::shared().assertion(entry._type);
+        if(this->_backend->release(*assertionID))
+        {
+            this->_backendReleases.fetch_add(1, memory_order_relaxed);
+            metrics.releases.increment();
+        }
+        else
+        {
+            this->_backendFailures.fetch_add(1, memory_order_relaxed);
+            metrics.failures.increment();
+        }
+        metrics.held.decrement();
+    }
+    entry._assertionID = nullopt;
+    entry._backendExpiry.store(0, memory_order_relaxed);
+    entry._lingerDeadline = nullopt;
+}
+
+void PowerAssertionRegistry::lingerDidExpire(Entry& entry) noexcept
+{
+    lock_guard lock { entry._mutex };
+
+    const auto deadline = entry._lingerDeadline;
+    if(deadline == nullopt || entry._references.load(memory_order_acquire) > 0)
+    {
+        return;
+    }
+
+    // A later release may have extended the linger period.
+    if(TimerWheel::Clock::now() < *deadline)
+    {
+        TimerWheel::shared().schedule(entry._lingerTimer, *deadline);
+        return;
+    }
+
+    AWAKEN_TRACE(Info, "Linger period expired, releasing power assertion.");
+    this->releaseBackendAssertion(entry);
+}
+
+#pragma mark - Statistics
+
+PowerAssertionRegistry::Statistics PowerAssertionRegistry::statistics() const noexcept
+{
+    unique_lock lock { this->_entriesMutex };
+    const auto entries = static_cast<uint64_t>(this->_entries.size());
+    lock.unlock();
+
+    return Statistics {
+        this->_acquisitions.load(memory_order_relaxed),
+        this->_releases.load(memory_order_relaxed),
+        this->_backendCreates.load(memory_order_relaxed),
+        this->_backendReleases.load(memory_order_relaxed),
+        this->_backendUpdates.load(memory_order_relaxed),
+        this->_backendFailures.load(memory_order_relaxed),
+        this->_lingerReattachments.load(memory_order_relaxed),
+        this->_lingerReattachments.load(memory_order_relaxed) * 2,
+        entries,
+    };
+}
@@ -0,0 +1,163 @@
+//
+//  PowerSourceAggregator.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/PowerSourceAggregator.hpp>
+
+using namespace std;
+using namespace Awaken;
+
+using Source = PowerSourceSnapshot::Source;
+
+#pragma mark - Life Cycle
+
+PowerSourceAggregator::PowerSourceAggregator(PowerSourceFilter filter) noexcept
+    : _filter(filter)
+{
+}
+
+#pragma mark - Filter
+
+PowerSourceFilter PowerSourceAggregator::filter() const noexcept
+{
+    return this->_filter;
+}
+
+void PowerSourceAggregator::setFilter(PowerSourceFilter filter) noexcept
+{
+    this->_filter = filter;
+    this->_totals = {};
+    
+    for(size_t index = 0; index < this->_snapshot.storedSourceCount(); index++)
+    {
+        this->accumulate(this->_snapshot.sources[index], 1);
+    }
+}
+
+#pragma mark - Aggregating
+
+size_t PowerSourceAggregator::update(const PowerSourceSnapshot& snapshot) noexcept
+{
+    const auto previousCount = this->_snapshot.storedSourceCount();
+    const auto count = snapshot.storedSourceCount();
+    size_t changeCount = 0;
+    
+    for(size_t index = 0; index < max(previousCount, count); index++)
+    {
+        const auto& previousSource = this->_snapshot.sources[index];
+        const auto& source = snapshot.sources[index];
+        
+        const bool hadSource = index < previousCount;
+        const bool hasSource = index < count;
+        if(hadSource && hasSource && previousSource == source) { continue; }
+        
+        if(hadSource)
+        {
+            this->accumulate(previousSource, -1);
+        }
+        if(hasSource)
+        {
+            this->accumulate(source, 1);
+        }
+        changeCount++;
+    }
+    
+    this->_snapshot = snapshot;
+    return changeCount;
+}
+
+PowerSourceSnapshot PowerSourceAggregator::snapshot() const noexcept
+{
+    auto snapshot = this->_snapshot;
+    const auto& totals = this->_totals;
+    
+    if(totals.count == 0)
+    {
+        snapshot.type = PowerSourceSnapshot::Type::Unknown;
+        snapshot.capacity = PowerSourceSnapshot::CapacityUnavailable;
+        snapshot.isCharging = false;
+        snapshot.timeRemaining = nullopt;
+        return snapshot;
+    }
+    
+    snapshot.type = PowerSourceSnapshot::Type::Unknown;
+    if(totals.batteryCount > 0)
+    {
+        snapshot.type = PowerSourceSnapshot::Type::InternalBattery;
+    }
+    else if(totals.upsCount > 0)
+    {
+        snapshot.type = PowerSourceSnapshot::Type::UPS;
+    }
+    
+    if(totals.countWithoutEnergy == 0 && totals.energy > 0)
+    {
+        snapshot.capacity = static_cast<float>(totals.energyWeightedCapacity / totals.energy);
+    }
+    else
+    {
+        snapshot.capacity = static_cast<float>(totals.capacity / totals.count);
+    }
+    
+    snapshot.isCharging = totals.chargingCount > 0;
+    
+    // Sources are drained one after another, so the remaining times add up.
+    snapshot.timeRemaining = nullopt;
+    if(totals.countWithoutTimeRemaining == 0)
+    {
+        snapshot.timeRemaining = chrono::minutes { totals.minutesRemaining };
+    }
+    
+    return snapshot;
+}
+
+void PowerSourceAggregator::accumulate(const Source& source, int sign) noexcept
+{
+    if(!source.matches(this->_filter)) { return; }
+    
+    auto& totals = this->_totals;
+    totals.count += sign;
+    totals.capacity += sign * static_cast<double>(source.capacity);
+    
+    if(source.energyCapacity > 0)
+    {
+        totals.energy += sign * static_cast<double>(source.energyCapacity);
+        totals.energyWeightedCapacity += sign * static_cast<double>(source.capacity) * source.energyCapacity;
+    }
+    else
+    {
+        totals.countWithoutEnergy += sign;
+    }
+    
+    if(const auto timeRemaining = source.timeRemaining)
+    {
+        totals.minutesRemaining += sign * timeRemaining->count();
+    }
+    else
+    {
+        totals.countWithoutTimeRemaining += sign;
+    }
+    
+    if(source.isCharging)
+    {
+        totals.chargingCount += sign;
+    }
+    if(source.type == PowerSourceSnapshot::Type::InternalBattery)
+    {
+        totals.batteryCount += sign;
+    }
+    else if(source.type == PowerSourceSnapshot::Type::UPS)
+    {
+        totals.upsCount += sign;
+    }
+    
+    // Start over from exact zeros instead of accumulating rounding errors.
+    if(totals.count == 0)
+    {
+        totals = {};
+    }
+}
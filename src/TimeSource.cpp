@@ -0,0 +1,92 @@
+//
+//  TimeSource.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/TimeSource.hpp>
+#include <algorithm>
+#include <optional>
+#include <Awaken/TimerWheel.hpp>
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Steady Time Source
+
+SteadyTimeSource& SteadyTimeSource::shared() noexcept
+{
+    // Intentionally leaked, the shared timing wheel outlives static destruction.
+    static auto timeSource = new SteadyTimeSource();
+    return *timeSource;
+}
+
+void SteadyTimeSource::waitUntil(unique_lock<std::mutex>& lock, condition_variable& condition, Clock::time_point time) const noexcept
+{
+    condition.wait_until(lock, time);
+}
+
+#pragma mark - Virtual Time Source
+
+VirtualTimeSource::VirtualTimeSource(Clock::time_point start) noexcept
+    : _now(start.time_since_epoch().count())
+{
+}
+
+VirtualTimeSource::Clock::time_point VirtualTimeSource::now() const noexcept
+{
+    return Clock::time_point { Clock::duration { this->_now.load(memory_order_acquire) } };
+}
+
+void VirtualTimeSource::waitUntil(unique_lock<std::mutex>& lock, condition_variable& condition, Clock::time_point time) const noexcept
+{
+    if(this->now() >= time) { return; }
+    condition.wait_for(lock, PollingInterval);
+}
+
+void VirtualTimeSource::advance(Clock::time_point time) noexcept
+{
+    lock_guard lock { this->_mutex };
+
+    const auto moveTo = [this](Clock::time_point time) {
+        const auto now = max(this->now(), time);
+        this->_now.store(now.time_since_epoch().count(), memory_order_release);
+        for(auto wheel : this->_wheels)
+        {
+            wheel->runUntil(now);
+        }
+    };
+
+    // Every step ends at the earliest event of all wheels,
+    // so timers of different wheels fire in order, too.
+    while(true)
+    {
+        optional<Clock::time_point> next = nullopt;
+        for(auto wheel : this->_wheels)
+        {
+            if(const auto deadline = wheel->nextDeadline())
+            {
+                next = min(next.value_or(*deadline), *deadline);
+            }
+        }
+        if(!next || *next > time) { break; }
+
+        moveTo(*next);
+    }
+    moveTo(time);
+}
+
+bool VirtualTimeSource::attach(TimerWheel& wheel) noexcept
+{
+    lock_guard lock { this->_mutex };
+    this->_wheels.push_back(&wheel);
+    return true;
+}
+
+void VirtualTimeSource::detach(TimerWheel& wheel) noexcept
+{
+    lock_guard lock { this->_mutex };
+    erase(this->_wheels, &wheel);
+}
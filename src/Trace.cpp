@@ -0,0 +1,326 @@
+//
+//  Trace.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/Trace.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include "Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Buffers
+
+namespace Awaken
+{
+
+constexpr size_t TraceRecordWordCount = sizeof(TraceRecord) / sizeof(uint64_t);
+/// One more than the kept events, the owning thread may be
+/// writing the spare slot while readers copy the others.
+constexpr size_t TraceSlotCount = Trace::BufferCapacity + 1;
+static_assert(sizeof(TraceRecord) % sizeof(uint64_t) == 0, "Trace records must consist of whole words");
+static_assert(is_trivially_copyable_v<TraceRecord>, "Trace records must be trivially copyable");
+
+/// A single-writer ring buffer of trace records. Records are stored as
+/// atomic words, readers discard records overwritten while copying.
+struct TraceBuffer
+{
+    array<array<atomic<uint64_t>, TraceRecordWordCount>, TraceSlotCount> slots;
+    atomic<uint64_t> head { 0 };
+    atomic<uint64_t> clearedHead { 0 };
+    atomic<bool> isInUse { false };
+    uint32_t thread = 0;
+};
+
+struct TraceBuffers
+{
+    std::mutex mutex;
+    vector<unique_ptr<TraceBuffer>> buffers;
+    uint32_t nextThread = 1;
+};
+
+static TraceBuffers& SharedTraceBuffers() noexcept
+{
+    // Intentionally leaked, threads may record events during static destruction.
+    static auto buffers = new TraceBuffers();
+    return *buffers;
+}
+
+#if defined(__APPLE__)
+static atomic<TraceSink> SharedTraceSink { &Trace::osLogSink };
+#else
+static atomic<TraceSink> SharedTraceSink { nullptr };
+#endif
+
+/// Returns the buffer to the pool when its thread finishes
+struct ThreadTraceBuffer
+{
+    TraceBuffer* buffer = nullptr;
+    
+    ~ThreadTraceBuffer()
+    {
+        if(auto buffer = this->buffer)
+        {
+            buffer->isInUse.store(false, memory_order_release);
+        }
+    }
+};
+
+static thread_local ThreadTraceBuffer CurrentThreadTraceBuffer;
+
+static TraceBuffer& CurrentTraceBuffer() noexcept
+{
+    auto& threadBuffer = CurrentThreadTraceBuffer;
+    if(threadBuffer.buffer != nullptr)
+    {
+        return *threadBuffer.buffer;
+    }
+    
+    auto& buffers = SharedTraceBuffers();
+    lock_guard lock { buffers.mutex };
+    
+    for(auto& buffer : buffers.buffers)
+    {
+        if(!buffer->isInUse.exchange(true, memory_order_acquire))
+        {
+            threadBuffer.buffer = buffer.get();
+            break;
+        }
+    }
+    if(threadBuffer.buffer == nullptr)
+    {
+        buffers.buffers.push_back(make_unique<TraceBuffer>());
+        threadBuffer.buffer = buffers.buffers.back().get();
+        threadBuffer.buffer->isInUse.store(true, memory_order_relaxed);
+    }
+    
+    threadBuffer.buffer->thread = buffers.nextThread++;
+    return *threadBuffer.buffer;
+}
+
+}
+
+#pragma mark - Recording
+
+void Trace::commit(TraceRecord& record) noexcept
+{
+    auto& buffer = CurrentTraceBuffer();
+    
+    const auto now = chrono::steady_clock::now().time_since_epoch();
+    record.timestamp = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now).count());
+    record.thread = buffer.thread;
+    
+    array<uint64_t, TraceRecordWordCount> words;
+    memcpy(words.data(), &record, sizeof(TraceRecord));
+    
+    const auto head = buffer.head.load(memory_order_relaxed);
+    auto& slot = buffer.slots[head % TraceSlotCount];
+    for(size_t index = 0; index < TraceRecordWordCount; index++)
+    {
+        slot[index].store(words[index], memory_order_relaxed);
+    }
+    buffer.head.store(head + 1, memory_order_release);
+    
+    if(auto sink = SharedTraceSink.load(memory_order_relaxed))
+    {
+        sink(record);
+    }
+}
+
+#pragma mark - Dumping
+
+vector<TraceRecord> Trace::records() noexcept
+{
+    vector<TraceRecord> records;
+    
+    auto& buffers = SharedTraceBuffers();
+    lock_guard lock { buffers.mutex };
+    
+    for(auto& buffer : buffers.buffers)
+    {
+        const auto head = buffer->head.load(memory_order_acquire);
+        const auto start = max(head > BufferCapacity ? head - BufferCapacity : 0,
+                               buffer->clearedHead.load(memory_order_relaxed));
+        
+        vector<TraceRecord> bufferRecords;
+        bufferRecords.reserve(head - start);
+        for(auto index = start; index < head; index++)
+        {
+            array<uint64_t, TraceRecordWordCount> words;
+            const auto& slot = buffer->slots[index % TraceSlotCount];
+            for(size_t word = 0; word < TraceRecordWordCount; word++)
+            {
+                words[word] = slot[word].load(memory_order_relaxed);
+            }
+            
+            TraceRecord record;
+            memcpy(&record, words.data(), sizeof(TraceRecord));
+            bufferRecords.push_back(record);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        
+        // The owning thread may have overwritten the oldest records
+        // while they were copied, including the slot it writes next.
+        const auto currentHead = buffer->head.load(memory_order_relaxed);
+        const auto validStart = currentHead >= TraceSlotCount ? currentHead - TraceSlotCount + 1 : 0;
+        const auto skipCount = validStart > start ? min<uint64_t>(validStart - start, bufferRecords.size()) : 0;
+        records.insert(records.end(), bufferRecords.begin() + static_cast<ptrdiff_t>(skipCount), bufferRecords.end());
+    }
+    
+    stable_sort(records.begin(), records.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.timestamp < rhs.timestamp;
+    });
+    return records;
+}
+
+string Trace::format(const TraceRecord& record)
+{
+    char line[MaximumLineLength];
+    format(record, line, sizeof(line));
+    return line;
+}
+
+size_t Trace::format(const TraceRecord& record, char* buffer, size_t capacity) noexcept
+{
+    static constexpr const char* LevelNames[] = { "debug", "info", "error", "off" };
+    
+    if(capacity == 0) { return 0; }
+    
+    // The line stays terminated, snprintf() returns the untruncated length.
+    size_t length = 0;
+    const auto advance = [&length, capacity](int count) {
+        if(count > 0) { length = min(length + static_cast<size_t>(count), capacity - 1); }
+    };
+    const auto append = [&](char character) {
+        if(length + 1 < capacity) { buffer[length++] = character; }
+        buffer[length] = '\0';
+    };
+    
+    advance(snprintf(buffer, capacity, "%llu.%06llu [%u] %s: ",
+                     static_cast<unsigned long long>(record.timestamp / 1'000'000'000),
+                     static_cast<unsigned long long>(record.timestamp % 1'000'000'000 / 1'000),
+                     record.thread,
+                     LevelNames[static_cast<size_t>(record.descriptor->level)]));
+    
+    // Rebuild each conversion for the stored argument kind,
+    // the format string only contributes flags, width and precision.
+    size_t argument = 0;
+    for(auto format = record.descriptor->format; *format != '\0' && length + 1 < capacity; format++)
+    {
+        if(*format != '%')
+        {
+            append(*format);
+            continue;
+        }
+        
+        format++;
+        if(*format == '%')
+        {
+            append('%');
+            continue;
+        }
+        if(*format == '{')
+        {
+            while(*format != '\0' && *format != '}') { format++; }
+            if(*format == '}') { format++; }
+        }
+        
+        // Leaves room for the longest conversion and the terminator
+        char specification[16] = "%";
+        size_t specificationLength = 1;
+        while(*format != '\0' && strchr("-+ #0123456789.", *format) != nullptr)
+        {
+            if(specificationLength < sizeof(specification) - 4) { specification[specificationLength++] = *format; }
+            format++;
+        }
+        while(*format != '\0' && strchr("hlLqjzt", *format) != nullptr) { format++; }
+        if(*format == '\0') { break; }
+        
+        if(argument >= record.argumentCount)
+        {
+            advance(snprintf(buffer + length, capacity - length, "<missing>"));
+            continue;
+        }
+        
+        const auto bits = record.arguments[argument];
+        switch(record.argumentKind(argument++))
+        {
+            case TraceRecord::ArgumentKind::Signed:
+                memcpy(specification + specificationLength, "lld", 4);
+                advance(snprintf(buffer + length, capacity - length, specification, static_cast<long long>(bits)));
+                break;
+            case TraceRecord::ArgumentKind::Unsigned:
+                memcpy(specification + specificationLength, "llu", 4);
+                advance(snprintf(buffer + length, capacity - length, specification, static_cast<unsigned long long>(bits)));
+                break;
+            case TraceRecord::ArgumentKind::Floating:
+                memcpy(specification + specificationLength, "f", 2);
+                advance(snprintf(buffer + length, capacity - length, specification, bit_cast<double>(bits)));
+                break;
+        }
+    }
+    
+    return length;
+}
+
+void Trace::dump(FILE* file) noexcept
+{
+    char line[MaximumLineLength];
+    for(const auto& record : records())
+    {
+        format(record, line, sizeof(line));
+        fprintf(file, "%s\n", line);
+    }
+}
+
+void Trace::clear() noexcept
+{
+    auto& buffers = SharedTraceBuffers();
+    lock_guard lock { buffers.mutex };
+    
+    for(auto& buffer : buffers.buffers)
+    {
+        buffer->clearedHead.store(buffer->head.load(memory_order_acquire), memory_order_relaxed);
+    }
+}
+
+#pragma mark - Sinks
+
+void Trace::setSink(TraceSink sink) noexcept
+{
+    SharedTraceSink.store(sink, memory_order_relaxed);
+}
+
+void Trace::osLogSink(const TraceRecord& record) noexcept
+{
+#if __has_include(<os/log.h>)
+    auto type = OS_LOG_TYPE_DEFAULT;
+    switch(record.descriptor->level)
+    {
+        case TraceLevel::Debug: type = OS_LOG_TYPE_DEBUG; break;
+        case TraceLevel::Error: type = OS_LOG_TYPE_ERROR; break;
+        default: break;
+    }
+    char line[MaximumLineLength];
+    format(record, line, sizeof(line));
+    os_log_with_type(DefaultLog, type, "%{public}s", line);
+#else
+    (void)record;
+#endif
+}
+
+void Trace::standardErrorSink(const TraceRecord& record) noexcept
+{
+    char line[MaximumLineLength];
+    format(record, line, sizeof(line));
+    fprintf(stderr, "%s\n", line);
+}
@@ -6,6 +6,8 @@
 //  Copyright © 2020 Marcel Dierkes. All rights reserved.
 //
 
+#if defined(__APPLE__)
+
 #include <Awaken/DispatchWaiter.hpp>
 #include "../Log.hpp"
 
@@ -40,33 +42,30 @@ void DispatchWaiter::setTimeoutHandler(std::function<void()>&& timeoutHandler) n
 
 bool DispatchWaiter::isRunning() const noexcept
 {
-    return this->_running;
+    return this->_running.load(memory_order_acquire);
 }
 
 bool DispatchWaiter::run() noexcept
 {
-    if(this->isRunning())
+    if(this->_running.exchange(true, memory_order_acq_rel))
     {
-        os_log(DefaultLog, "A waiter is already running.");
+        AWAKEN_TRACE(Info, "A waiter is already running.");
         return false;
     }
     
-    this->_running = true;
-    
     const auto nanoTimeout = chrono::duration_cast<chrono::nanoseconds>(this->_timeout);
     const auto timeoutHandler = this->_timeoutHandler;
     
     auto lambda = [this, timeoutHandler] {
-        if(!this->_running) { return; }
+        if(!this->_running.exchange(false, memory_order_acq_rel)) { return; }
         
-        os_log(DefaultLog, "Waiting.");
+        AWAKEN_TRACE(Debug, "Waiting.");
         
         if(const auto& handler = timeoutHandler) {
             (*handler)();
         }
-        this->_running = false;
         
-        os_log(DefaultLog, "Waited.");
+        AWAKEN_TRACE(Debug, "Waited.");
     };
     
     dispatch_after(dispatch_time(DISPATCH_TIME_NOW, nanoTimeout.count()), this->_dispatchQueue, ^{
@@ -76,10 +75,18 @@ bool DispatchWaiter::run() noexcept
     return false;
 }
 
+bool DispatchWaiter::setDeadline(chrono::steady_clock::time_point) noexcept
+{
+    AWAKEN_TRACE(Info, "Moving the deadline is not supported.");
+    return false;
+}
+
 bool DispatchWaiter::cancel() noexcept
 {
-    this->_running = false;
-    os_log(DefaultLog, "Cancel waiter.");
+    this->_running.store(false, memory_order_release);
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
     
     return true;
 }
+
+#endif
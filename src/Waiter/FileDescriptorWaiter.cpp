@@ -0,0 +1,435 @@
+//
+//  FileDescriptorWaiter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <Awaken/FileDescriptorWaiter.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <fcntl.h>
+#include <mutex>
+#include <optional>
+#include <poll.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+#if defined(__APPLE__)
+#include <sys/event.h>
+#endif
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+/// The maximum number of bytes moved per wake-up
+constexpr size_t TransferSize = 64 * 1024;
+
+/// The events that report a hang-up in addition to `POLLHUP`,
+/// unread data must not wake up a waiter that keeps the input.
+#if defined(POLLRDHUP)
+constexpr short HangUpEvents = POLLRDHUP;
+#else
+constexpr short HangUpEvents = 0;
+#endif
+
+struct FileDescriptorWaiter::State
+{
+    const int fd;
+    const int passThroughFD;
+    const Input input;
+
+    std::mutex mutex;
+    condition_variable condition;
+    ScheduledHandler timeoutHandler;
+
+    bool isRunning = false;
+    bool isStopping = false;
+    /// Incremented by every run, so the thread stops waiting
+    /// for a cancelled run that was followed by the next one
+    uint64_t run = 0;
+    optional<chrono::steady_clock::time_point> deadline = nullopt;
+
+    /// Created by the first run and reused by all following ones
+    array<int, 2> wakeFDs { -1, -1 };
+    /// Watches the descriptor and the wake-up pipe on macOS while keeping the input
+    int queueFD = -1;
+
+    /// Only accessed by the thread
+    vector<char> buffer;
+    bool canSplice = true;
+    atomic<uint64_t> transferredBytes { 0 };
+
+    State(int fd, int passThroughFD, Input input, Executor& executor) noexcept
+        : fd(fd)
+        , passThroughFD(passThroughFD)
+        , input(input)
+        , timeoutHandler(executor)
+        , buffer(input == Input::Consume ? TransferSize : 0)
+    {
+    }
+
+    ~State() noexcept
+    {
+        for(const auto fd : { this->wakeFDs[0], this->wakeFDs[1], this->queueFD })
+        {
+            if(fd >= 0) { close(fd); }
+        }
+    }
+
+    /// Creates the wake-up pipe and, if needed, the event queue
+    bool open() noexcept;
+    void wake() noexcept;
+    void drainWakeUps() noexcept;
+    /// Waits without holding the lock until the descriptor or the wake-up pipe is ready
+    /// @returns false if waiting failed
+    bool waitForEvents(int timeout, bool& didReachEnd) noexcept;
+    bool transfer() noexcept;
+};
+
+#pragma mark - Life Cycle
+
+FileDescriptorWaiter::FileDescriptorWaiter(int fd, Input input, Executor& executor) noexcept
+    : _state(make_shared<State>(fd, -1, input, executor))
+{
+}
+
+FileDescriptorWaiter::FileDescriptorWaiter(int fd, int passThroughFD, Executor& executor) noexcept
+    : _state(make_shared<State>(fd, passThroughFD, Input::Consume, executor))
+{
+}
+
+FileDescriptorWaiter::~FileDescriptorWaiter() noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+        state.isStopping = true;
+        state.wake();
+    }
+    state.condition.notify_one();
+
+    if(this->_thread.joinable())
+    {
+        // The timeout handler may destroy the waiter
+        // from its own thread, which cannot join itself.
+        if(this->_thread.get_id() == this_thread::get_id())
+        {
+            this->_thread.detach();
+        }
+        else
+        {
+            this->_thread.join();
+        }
+    }
+    state.timeoutHandler.discard();
+}
+
+#pragma mark - Properties
+
+void FileDescriptorWaiter::setTimeout(std::chrono::seconds timeout) noexcept
+{
+    this->_timeout = timeout;
+}
+
+void FileDescriptorWaiter::setTimeoutHandler(std::function<void()>&& timeoutHandler) noexcept
+{
+    this->_state->timeoutHandler.setHandler(std::move(timeoutHandler));
+}
+
+uint64_t FileDescriptorWaiter::transferredBytes() const noexcept
+{
+    return this->_state->transferredBytes.load(memory_order_relaxed);
+}
+
+#pragma mark - Running
+
+bool FileDescriptorWaiter::isRunning() const noexcept
+{
+    lock_guard lock { this->_state->mutex };
+    return this->_state->isRunning;
+}
+
+bool FileDescriptorWaiter::run() noexcept
+{
+    if(this->isRunning())
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    // A handler of the previous run that is still queued
+    // would otherwise stop this run.
+    auto& state = *this->_state;
+    state.timeoutHandler.discard();
+
+    {
+        lock_guard lock { state.mutex };
+        if(state.isRunning)
+        {
+            AWAKEN_TRACE(Info, "A waiter is already running.");
+            return false;
+        }
+        if(state.wakeFDs[0] < 0 && !state.open())
+        {
+            return false;
+        }
+
+        state.isRunning = true;
+        state.run++;
+
+        const auto timeout = this->_timeout;
+        if(timeout == 0s)
+        {
+            AWAKEN_TRACE(Debug, "Waiting for descriptor %{public}d to close…", state.fd);
+            state.deadline = nullopt;
+        }
+        else
+        {
+            AWAKEN_TRACE(Debug, "Waiting for descriptor %{public}d to close or %{public}lld seconds.", state.fd, timeout.count());
+            state.deadline = chrono::steady_clock::now() + timeout;
+        }
+    }
+
+    if(!this->_thread.joinable())
+    {
+        this->_thread = thread([state = this->_state]{
+            wait(*state);
+        });
+    }
+    state.condition.notify_one();
+
+    return true;
+}
+
+bool FileDescriptorWaiter::cancel() noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+        state.wake();
+    }
+
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
+    return true;
+}
+
+bool FileDescriptorWaiter::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    auto& state = *this->_state;
+    lock_guard lock { state.mutex };
+    if(!state.isRunning) { return false; }
+
+    state.deadline = deadline;
+    state.wake();
+    return true;
+}
+
+void FileDescriptorWaiter::wait(State& state) noexcept
+{
+    unique_lock lock { state.mutex };
+    uint64_t waitedRun = 0;
+    while(true)
+    {
+        // Waits for the next run, which may already be cancelled.
+        state.condition.wait(lock, [&state, waitedRun]{ return state.run != waitedRun || state.isStopping; });
+        if(state.isStopping) { return; }
+
+        // Cancelling, moving the deadline and stopping wake the thread
+        // up through the pipe, otherwise only the descriptor does.
+        const auto run = state.run;
+        waitedRun = run;
+        while(state.isRunning && state.run == run && !state.isStopping)
+        {
+            auto timeout = -1;
+            if(const auto deadline = state.deadline)
+            {
+                const auto remainingTime = chrono::ceil<chrono::milliseconds>(*deadline - chrono::steady_clock::now());
+                if(remainingTime <= 0ms) { break; }
+                timeout = static_cast<int>(min<chrono::milliseconds::rep>(remainingTime.count(), INT32_MAX));
+            }
+
+            lock.unlock();
+            bool didReachEnd = false;
+            const bool didWait = state.waitForEvents(timeout, didReachEnd);
+            lock.lock();
+
+            if(!didWait) { break; }
+            if(didReachEnd)
+            {
+                AWAKEN_TRACE(Debug, "Descriptor %{public}d reached its end.", state.fd);
+                break;
+            }
+        }
+        if(state.isStopping) { return; }
+        if(state.run != run) { continue; }
+        AWAKEN_TRACE(Debug, "Waited.");
+
+        state.isRunning = false;
+
+        lock.unlock();
+        state.timeoutHandler.schedule();
+        lock.lock();
+    }
+}
+
+#pragma mark - Events
+
+bool FileDescriptorWaiter::State::open() noexcept
+{
+    if(pipe(this->wakeFDs.data()) != 0)
+    {
+        AWAKEN_TRACE(Error, "Failed creating the waiter wake-up pipe: %{public}d.", errno);
+        return false;
+    }
+    for(const auto fd : this->wakeFDs)
+    {
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+#if defined(__APPLE__)
+    // Edge-triggered, so unread data only wakes the thread once
+    if(this->input == Input::Keep)
+    {
+        this->queueFD = kqueue();
+        array<struct kevent, 2> changes;
+        EV_SET(&changes[0], this->fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+        EV_SET(&changes[1], this->wakeFDs[0], EVFILT_READ, EV_ADD, 0, 0, nullptr);
+        if(this->queueFD < 0
+           || kevent(this->queueFD, changes.data(), static_cast<int>(changes.size()), nullptr, 0, nullptr) != 0)
+        {
+            AWAKEN_TRACE(Error, "Failed watching descriptor %{public}d: %{public}d.", this->fd, errno);
+            for(auto& fd : this->wakeFDs)
+            {
+                close(exchange(fd, -1));
+            }
+            if(this->queueFD >= 0) { close(exchange(this->queueFD, -1)); }
+            return false;
+        }
+    }
+#endif
+    return true;
+}
+
+void FileDescriptorWaiter::State::wake() noexcept
+{
+    if(this->wakeFDs[1] < 0) { return; }
+
+    const char byte = 1;
+    [[maybe_unused]] const auto result = write(this->wakeFDs[1], &byte, sizeof(byte));
+}
+
+void FileDescriptorWaiter::State::drainWakeUps() noexcept
+{
+    char buffer[16];
+    while(read(this->wakeFDs[0], buffer, sizeof(buffer)) > 0) {}
+}
+
+bool FileDescriptorWaiter::State::waitForEvents(int timeout, bool& didReachEnd) noexcept
+{
+#if defined(__APPLE__)
+    if(this->input == Input::Keep)
+    {
+        const timespec time { timeout / 1000, (timeout % 1000) * 1'000'000 };
+        array<struct kevent, 2> events;
+        const auto count = kevent(this->queueFD, nullptr, 0, events.data(), static_cast<int>(events.size()),
+                                  timeout >= 0 ? &time : nullptr);
+        if(count < 0)
+        {
+            if(errno == EINTR) { return true; }
+            AWAKEN_TRACE(Error, "Failed waiting for descriptor %{public}d: %{public}d.", this->fd, errno);
+            return false;
+        }
+        for(int index = 0; index < count; index++)
+        {
+            if(static_cast<int>(events[index].ident) == this->fd)
+            {
+                didReachEnd = didReachEnd || (events[index].flags & (EV_EOF | EV_ERROR)) != 0;
+            }
+            else
+            {
+                this->drainWakeUps();
+            }
+        }
+        return true;
+    }
+#endif
+
+    array<pollfd, 2> fds {{
+        { this->fd, this->input == Input::Keep ? HangUpEvents : static_cast<short>(POLLIN), 0 },
+        { this->wakeFDs[0], POLLIN, 0 },
+    }};
+    const auto count = poll(fds.data(), fds.size(), timeout);
+    if(count < 0)
+    {
+        if(errno == EINTR) { return true; }
+        AWAKEN_TRACE(Error, "Failed waiting for descriptor %{public}d: %{public}d.", this->fd, errno);
+        return false;
+    }
+
+    // A kept descriptor only reports hang-ups and errors. Reading happens
+    // outside the lock, a blocked pass-through receiver must not block cancel().
+    if(count > 0 && fds[0].revents != 0)
+    {
+        didReachEnd = this->input == Input::Keep || (fds[0].revents & POLLNVAL) != 0 || !this->transfer();
+    }
+    if(count > 0 && fds[1].revents != 0)
+    {
+        this->drainWakeUps();
+    }
+    return true;
+}
+
+bool FileDescriptorWaiter::State::transfer() noexcept
+{
+#if defined(__linux__)
+    // Moves the data between the kernel buffers if either side is a pipe
+    if(this->passThroughFD >= 0 && this->canSplice)
+    {
+        const auto count = splice(this->fd, nullptr, this->passThroughFD, nullptr, TransferSize, SPLICE_F_MOVE);
+        if(count > 0)
+        {
+            this->transferredBytes.fetch_add(static_cast<uint64_t>(count), memory_order_relaxed);
+            return true;
+        }
+        if(count == 0) { return false; }
+        if(errno == EINTR || errno == EAGAIN) { return true; }
+        if(errno != EINVAL) { return false; }
+
+        this->canSplice = false;
+    }
+#endif
+
+    const auto count = read(this->fd, this->buffer.data(), this->buffer.size());
+    if(count < 0) { return errno == EINTR || errno == EAGAIN; }
+    if(count == 0) { return false; }
+    this->transferredBytes.fetch_add(static_cast<uint64_t>(count), memory_order_relaxed);
+
+    if(this->passThroughFD < 0) { return true; }
+
+    // A receiver that went away ends the wait like the sender
+    size_t offset = 0;
+    while(offset < static_cast<size_t>(count))
+    {
+        const auto written = write(this->passThroughFD, this->buffer.data() + offset, static_cast<size_t>(count) - offset);
+        if(written < 0)
+        {
+            if(errno == EINTR) { continue; }
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
@@ -0,0 +1,147 @@
+//
+//  HeartbeatWaiter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/HeartbeatWaiter.hpp>
+#include <algorithm>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Life Cycle
+
+HeartbeatWaiter::HeartbeatWaiter(chrono::milliseconds ttl, TimerWheel& wheel, Executor& executor) noexcept
+    : _wheel(wheel)
+    , _ttl(ttl)
+    , _timeoutHandler(executor)
+    , _timer([this]{ this->timerDidFire(); })
+{
+}
+
+HeartbeatWaiter::~HeartbeatWaiter() noexcept
+{
+    this->_running = false;
+    this->_wheel.cancel(this->_timer);
+}
+
+#pragma mark - Properties
+
+void HeartbeatWaiter::setTimeout(chrono::seconds timeout) noexcept
+{
+    this->_timeout = timeout;
+}
+
+void HeartbeatWaiter::setTimeoutHandler(function<void()>&& timeoutHandler) noexcept
+{
+    this->_timeoutHandler.setHandler(std::move(timeoutHandler));
+}
+
+#pragma mark - Heartbeats
+
+bool HeartbeatWaiter::didMissHeartbeat() const noexcept
+{
+    return this->_didMissHeartbeat.load(memory_order_acquire);
+}
+
+HeartbeatWaiter::Clock::time_point HeartbeatWaiter::heartbeatExpiry() const noexcept
+{
+    const auto lastHeartbeat = Clock::duration { this->_lastHeartbeat.load(memory_order_relaxed) };
+    return Clock::time_point { lastHeartbeat } + this->_ttl;
+}
+
+HeartbeatWaiter::Clock::time_point HeartbeatWaiter::nextExpiry() const noexcept
+{
+    const auto deadline = Clock::time_point { Clock::duration { this->_deadline.load(memory_order_relaxed) } };
+    return min(this->heartbeatExpiry(), deadline);
+}
+
+#pragma mark - Running
+
+bool HeartbeatWaiter::isRunning() const noexcept
+{
+    return this->_running.load(memory_order_acquire);
+}
+
+bool HeartbeatWaiter::run() noexcept
+{
+    if(this->_running.load(memory_order_acquire))
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    // A handler of the previous run that is still pending or being
+    // called would otherwise stop this run, see `timerDidFire()`.
+    this->_wheel.cancel(this->_timer);
+    this->_timeoutHandler.discard();
+
+    if(this->_running.exchange(true, memory_order_acq_rel))
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    const auto now = this->_wheel.now();
+    const auto timeout = this->_timeout;
+    this->_didMissHeartbeat.store(false, memory_order_relaxed);
+    this->_lastHeartbeat.store(now.time_since_epoch().count(), memory_order_relaxed);
+    this->_deadline.store(timeout > 0s ? (now + timeout).time_since_epoch().count() : NoDeadline, memory_order_relaxed);
+
+    AWAKEN_TRACE(Debug, "Waiting for heartbeats every %{public}lld ms.", this->_ttl.count());
+    this->_wheel.schedule(this->_timer, this->nextExpiry());
+
+    return true;
+}
+
+bool HeartbeatWaiter::cancel() noexcept
+{
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
+
+    if(this->_running.exchange(false, memory_order_acq_rel))
+    {
+        this->_wheel.fire(this->_timer);
+    }
+    return true;
+}
+
+bool HeartbeatWaiter::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    if(!this->_running.load(memory_order_acquire)) { return false; }
+
+    this->_deadline.store(deadline.time_since_epoch().count(), memory_order_relaxed);
+    return this->_wheel.reschedule(this->_timer, this->nextExpiry());
+}
+
+void HeartbeatWaiter::timerDidFire() noexcept
+{
+    if(this->_running.load(memory_order_acquire))
+    {
+        const auto now = this->_wheel.now();
+        const auto expiry = this->nextExpiry();
+        if(expiry > now)
+        {
+            // Renewed since the timer was armed, the holder is alive.
+            this->_wheel.schedule(this->_timer, expiry);
+
+            // A cancel() before the timer was re-armed could not fire it.
+            if(!this->_running.load(memory_order_acquire))
+            {
+                this->_wheel.fire(this->_timer);
+            }
+            return;
+        }
+
+        if(this->_running.exchange(false, memory_order_acq_rel))
+        {
+            const auto heartbeatExpiry = this->heartbeatExpiry();
+            this->_didMissHeartbeat.store(heartbeatExpiry <= expiry, memory_order_release);
+        }
+    }
+
+    this->_timeoutHandler.schedule();
+}
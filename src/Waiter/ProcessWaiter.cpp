@@ -0,0 +1,489 @@
+//
+//  ProcessWaiter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/ProcessWaiter.hpp>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <fcntl.h>
+#include <mutex>
+#include <optional>
+#include <unistd.h>
+#include <utility>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#else
+#include <sys/event.h>
+#endif
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Events
+
+namespace Awaken
+{
+
+#if defined(__linux__)
+#if defined(SYS_pidfd_open)
+constexpr long PidfdOpenSyscall = SYS_pidfd_open;
+#else
+constexpr long PidfdOpenSyscall = 434;
+#endif
+#endif
+
+/// The number of events handled per wake-up
+constexpr size_t ProcessEventBatchSize = 16;
+
+/// Identifies the wake-up pipe in the event queue, process events
+/// carry the tag of the run that watches them instead
+constexpr uint64_t WakeUpEventData = UINT64_MAX;
+
+enum class WatchResult
+{
+    Watching,
+    Exited,
+    Failed,
+};
+
+struct ProcessEvent
+{
+    bool isWakeUp = false;
+    /// The run that watched the process
+    uint32_t tag = 0;
+    /// The pidfd of the process on Linux
+    int fd = -1;
+};
+
+static int CreateEventQueue() noexcept
+{
+#if defined(__linux__)
+    return epoll_create1(EPOLL_CLOEXEC);
+#else
+    return kqueue();
+#endif
+}
+
+static bool WatchWakeup(int eventFD, int wakeFD) noexcept
+{
+#if defined(__linux__)
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = WakeUpEventData;
+    return epoll_ctl(eventFD, EPOLL_CTL_ADD, wakeFD, &event) == 0;
+#else
+    struct kevent event;
+    EV_SET(&event, wakeFD, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    return kevent(eventFD, &event, 1, nullptr, 0, nullptr) == 0;
+#endif
+}
+
+/// Sorts the processes and removes duplicates, kqueue merges the
+/// events of a process watched twice, so it would only finish once.
+static vector<pid_t> UniqueProcesses(vector<pid_t> processes) noexcept
+{
+    sort(processes.begin(), processes.end());
+    processes.erase(unique(processes.begin(), processes.end()), processes.end());
+    return processes;
+}
+
+static WatchResult WatchProcess(int eventFD, pid_t process, uint32_t tag, vector<int>& processFDs) noexcept
+{
+#if defined(__linux__)
+    const auto fd = static_cast<int>(syscall(PidfdOpenSyscall, process, 0));
+    if(fd < 0)
+    {
+        return errno == ESRCH ? WatchResult::Exited : WatchResult::Failed;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    processFDs.push_back(fd);
+
+    // A pidfd becomes readable once the process exited
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = (static_cast<uint64_t>(tag) << 32) | static_cast<uint32_t>(fd);
+    return epoll_ctl(eventFD, EPOLL_CTL_ADD, fd, &event) == 0 ? WatchResult::Watching : WatchResult::Failed;
+#else
+    (void)processFDs;
+
+    // Adding a process again replaces the tag of an earlier run
+    struct kevent event;
+    EV_SET(&event, process, EVFILT_PROC, EV_ADD | EV_ONESHOT, NOTE_EXIT, 0, reinterpret_cast<void*>(static_cast<uintptr_t>(tag)));
+    if(kevent(eventFD, &event, 1, nullptr, 0, nullptr) == 0) { return WatchResult::Watching; }
+    return errno == ESRCH ? WatchResult::Exited : WatchResult::Failed;
+#endif
+}
+
+/// Stops reporting a process of the current run, level-triggered
+/// pidfds would be reported again on Linux
+static void UnwatchProcess(int eventFD, const ProcessEvent& event) noexcept
+{
+#if defined(__linux__)
+    epoll_ctl(eventFD, EPOLL_CTL_DEL, event.fd, nullptr);
+#else
+    // One-shot events are removed when they are reported
+    (void)eventFD;
+    (void)event;
+#endif
+}
+
+/// Waits for process exits or a wake-up
+/// @param timeout The timeout in milliseconds, -1 waits indefinitely
+/// @returns the number of events, -1 on failure
+static int WaitForEvents(int eventFD, int timeout, array<ProcessEvent, ProcessEventBatchSize>& processEvents) noexcept
+{
+#if defined(__linux__)
+    array<epoll_event, ProcessEventBatchSize> events;
+    const auto count = epoll_wait(eventFD, events.data(), static_cast<int>(events.size()), timeout);
+    for(int index = 0; index < count; index++)
+    {
+        const auto data = events[index].data.u64;
+        processEvents[index] = data == WakeUpEventData
+            ? ProcessEvent { true }
+            : ProcessEvent { false, static_cast<uint32_t>(data >> 32), static_cast<int>(static_cast<uint32_t>(data)) };
+    }
+#else
+    array<struct kevent, ProcessEventBatchSize> events;
+    const timespec interval { timeout / 1000, (timeout % 1000) * 1'000'000 };
+    const auto count = kevent(eventFD, nullptr, 0, events.data(), static_cast<int>(events.size()),
+                              timeout < 0 ? nullptr : &interval);
+    for(int index = 0; index < count; index++)
+    {
+        processEvents[index] = events[index].filter == EVFILT_READ
+            ? ProcessEvent { true }
+            : ProcessEvent { false, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(events[index].udata)) };
+    }
+#endif
+    return count;
+}
+
+}
+
+struct ProcessWaiter::State
+{
+    std::mutex mutex;
+    condition_variable condition;
+    ScheduledHandler timeoutHandler;
+    vector<pid_t> processes;
+
+    bool isRunning = false;
+    bool isStopping = false;
+    /// Incremented by every run, so the thread stops waiting
+    /// for a cancelled run that was followed by the next one
+    uint64_t run = 0;
+    optional<chrono::steady_clock::time_point> deadline = nullopt;
+    /// The number of processes the current run still waits for
+    size_t remaining = 0;
+
+    /// Created by the first run and reused by all following ones
+    int eventFD = -1;
+    array<int, 2> wakeFDs { -1, -1 };
+    /// Incremented whenever processes are watched, only
+    /// events with the latest tag belong to the current run
+    uint32_t tag = 0;
+    /// The pidfds of the current run on Linux
+    vector<int> processFDs;
+
+    State(vector<pid_t> processes, Executor& executor) noexcept
+        : timeoutHandler(executor)
+        , processes(UniqueProcesses(std::move(processes)))
+    {
+    }
+
+    ~State() noexcept
+    {
+        this->unwatch();
+        for(const auto fd : { this->eventFD, this->wakeFDs[0], this->wakeFDs[1] })
+        {
+            if(fd >= 0) { close(fd); }
+        }
+    }
+
+    /// Creates the event queue and the wake-up pipe
+    bool open() noexcept
+    {
+        this->eventFD = CreateEventQueue();
+        if(this->eventFD >= 0 && pipe(this->wakeFDs.data()) == 0)
+        {
+            for(const auto fd : this->wakeFDs)
+            {
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                fcntl(fd, F_SETFD, FD_CLOEXEC);
+            }
+            if(WatchWakeup(this->eventFD, this->wakeFDs[0])) { return true; }
+        }
+
+        for(auto fd : { &this->eventFD, &this->wakeFDs[0], &this->wakeFDs[1] })
+        {
+            if(*fd >= 0) { close(exchange(*fd, -1)); }
+        }
+        return false;
+    }
+
+    /// Closes the pidfds of the current run, which removes them from epoll
+    void unwatch() noexcept
+    {
+        for(const auto fd : this->processFDs)
+        {
+            close(fd);
+        }
+        this->processFDs.clear();
+    }
+
+    void wake() noexcept
+    {
+        if(this->wakeFDs[1] < 0) { return; }
+
+        const char byte = 1;
+        [[maybe_unused]] const auto result = write(this->wakeFDs[1], &byte, sizeof(byte));
+    }
+
+    void drainWakeUps() noexcept
+    {
+        char buffer[16];
+        while(read(this->wakeFDs[0], buffer, sizeof(buffer)) > 0) {}
+    }
+};
+
+#pragma mark - Life Cycle
+
+ProcessWaiter::ProcessWaiter(vector<pid_t> processes, Executor& executor) noexcept
+    : _state(make_shared<State>(std::move(processes), executor))
+{
+}
+
+ProcessWaiter::~ProcessWaiter() noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+        state.isStopping = true;
+        state.wake();
+    }
+    state.condition.notify_one();
+
+    if(this->_thread.joinable())
+    {
+        // The timeout handler may destroy the waiter
+        // from its own thread, which cannot join itself.
+        if(this->_thread.get_id() == this_thread::get_id())
+        {
+            this->_thread.detach();
+        }
+        else
+        {
+            this->_thread.join();
+        }
+    }
+    state.timeoutHandler.discard();
+}
+
+#pragma mark - Properties
+
+void ProcessWaiter::setProcesses(vector<pid_t> processes) noexcept
+{
+    lock_guard lock { this->_state->mutex };
+    this->_state->processes = UniqueProcesses(std::move(processes));
+}
+
+vector<pid_t> ProcessWaiter::processes() const noexcept
+{
+    lock_guard lock { this->_state->mutex };
+    return this->_state->processes;
+}
+
+void ProcessWaiter::setTimeout(std::chrono::seconds timeout) noexcept
+{
+    this->_timeout = timeout;
+}
+
+void ProcessWaiter::setTimeoutHandler(std::function<void()>&& timeoutHandler) noexcept
+{
+    this->_state->timeoutHandler.setHandler(std::move(timeoutHandler));
+}
+
+#pragma mark - Running
+
+bool ProcessWaiter::isRunning() const noexcept
+{
+    lock_guard lock { this->_state->mutex };
+    return this->_state->isRunning;
+}
+
+bool ProcessWaiter::run() noexcept
+{
+    if(this->isRunning())
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    // A handler of the previous run that is still queued
+    // would otherwise stop this run.
+    auto& state = *this->_state;
+    state.timeoutHandler.discard();
+
+    {
+        lock_guard lock { state.mutex };
+        if(state.isRunning)
+        {
+            AWAKEN_TRACE(Info, "A waiter is already running.");
+            return false;
+        }
+        if(state.eventFD < 0 && !state.open())
+        {
+            AWAKEN_TRACE(Error, "Failed creating the process event queue: %{public}d.", errno);
+            return false;
+        }
+
+        // A cancelled run may not have been finished by the thread yet.
+        state.unwatch();
+        state.tag++;
+
+        size_t remaining = 0;
+        for(const auto process : state.processes)
+        {
+            switch(WatchProcess(state.eventFD, process, state.tag, state.processFDs))
+            {
+                case WatchResult::Watching:
+                    remaining++;
+                    break;
+                case WatchResult::Exited:
+                    AWAKEN_TRACE(Info, "Process %{public}d already exited.", process);
+                    break;
+                case WatchResult::Failed:
+                    AWAKEN_TRACE(Error, "Failed watching process %{public}d: %{public}d.", process, errno);
+                    state.unwatch();
+                    return false;
+            }
+        }
+
+        state.isRunning = true;
+        state.run++;
+        state.remaining = remaining;
+
+        const auto timeout = this->_timeout;
+        if(timeout == 0s)
+        {
+            AWAKEN_TRACE(Debug, "Waiting for %{public}zu processes to exit…", remaining);
+            state.deadline = nullopt;
+        }
+        else
+        {
+            AWAKEN_TRACE(Debug, "Waiting for %{public}zu processes to exit or %{public}lld seconds.", remaining, timeout.count());
+            state.deadline = chrono::steady_clock::now() + timeout;
+        }
+    }
+
+    if(!this->_thread.joinable())
+    {
+        this->_thread = thread([state = this->_state]{
+            wait(*state);
+        });
+    }
+    state.condition.notify_one();
+
+    return true;
+}
+
+bool ProcessWaiter::cancel() noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+        state.wake();
+    }
+
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
+    return true;
+}
+
+bool ProcessWaiter::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    auto& state = *this->_state;
+    lock_guard lock { state.mutex };
+    if(!state.isRunning) { return false; }
+
+    state.deadline = deadline;
+    state.wake();
+    return true;
+}
+
+void ProcessWaiter::wait(State& state) noexcept
+{
+    unique_lock lock { state.mutex };
+    uint64_t waitedRun = 0;
+    array<ProcessEvent, ProcessEventBatchSize> events;
+    while(true)
+    {
+        // Waits for the next run, which may already be cancelled.
+        state.condition.wait(lock, [&state, waitedRun]{ return state.run != waitedRun || state.isStopping; });
+        if(state.isStopping) { return; }
+
+        // Cancelling, moving the deadline and stopping wake the thread up
+        // through the pipe, it never wakes up on its own otherwise.
+        const auto run = state.run;
+        waitedRun = run;
+        while(state.isRunning && state.run == run && state.remaining > 0 && !state.isStopping)
+        {
+            auto timeout = -1;
+            if(const auto deadline = state.deadline)
+            {
+                const auto remainingTime = chrono::ceil<chrono::milliseconds>(*deadline - chrono::steady_clock::now());
+                if(remainingTime <= 0ms) { break; }
+                timeout = static_cast<int>(min<chrono::milliseconds::rep>(remainingTime.count(), INT32_MAX));
+            }
+
+            const auto eventFD = state.eventFD;
+            lock.unlock();
+            const auto count = WaitForEvents(eventFD, timeout, events);
+            const auto error = errno;
+            lock.lock();
+
+            if(count < 0)
+            {
+                if(error == EINTR) { continue; }
+
+                AWAKEN_TRACE(Error, "Failed waiting for processes: %{public}d.", error);
+                break;
+            }
+
+            // Exits of a cancelled run may still be reported, a following
+            // run has a new tag and may already have taken over.
+            for(int index = 0; index < count; index++)
+            {
+                const auto& event = events[index];
+                if(event.isWakeUp)
+                {
+                    state.drainWakeUps();
+                }
+                else if(event.tag == state.tag && state.remaining > 0)
+                {
+                    UnwatchProcess(state.eventFD, event);
+                    state.remaining--;
+                }
+            }
+        }
+        if(state.isStopping) { return; }
+        if(state.run != run) { continue; }
+        AWAKEN_TRACE(Debug, "Waited.");
+
+        state.isRunning = false;
+        state.unwatch();
+
+        lock.unlock();
+        state.timeoutHandler.schedule();
+        lock.lock();
+    }
+}
@@ -7,13 +7,70 @@
 //
 
 #include <Awaken/ThreadWaiter.hpp>
+#include <Awaken/Metrics.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 #include "../Log.hpp"
 
 using namespace std;
 using namespace Awaken;
 
+struct ThreadWaiter::State
+{
+    std::mutex mutex;
+    condition_variable condition;
+    ScheduledHandler timeoutHandler;
+    TimeSource& timeSource;
+
+    bool isRunning = false;
+    bool isStopping = false;
+    /// Incremented by every run, so the thread stops waiting
+    /// for a cancelled run that was followed by the next one
+    uint64_t run = 0;
+    optional<chrono::steady_clock::time_point> deadline = nullopt;
+
+    State(Executor& executor, TimeSource& timeSource) noexcept
+        : timeoutHandler(executor)
+        , timeSource(timeSource)
+    {
+    }
+};
+
 #pragma mark - Life Cycle
 
+ThreadWaiter::ThreadWaiter(Executor& executor, TimeSource& timeSource) noexcept
+    : _timeSource(timeSource)
+    , _state(make_shared<State>(executor, timeSource))
+{
+}
+
+ThreadWaiter::~ThreadWaiter() noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+        state.isStopping = true;
+    }
+    state.condition.notify_one();
+
+    if(this->_thread.joinable())
+    {
+        // The timeout handler may destroy the waiter
+        // from its own thread, which cannot join itself.
+        if(this->_thread.get_id() == this_thread::get_id())
+        {
+            this->_thread.detach();
+        }
+        else
+        {
+            this->_thread.join();
+        }
+    }
+    state.timeoutHandler.discard();
+}
+
 #pragma mark - Properties
 
 void ThreadWaiter::setTimeout(std::chrono::seconds timeout) noexcept
@@ -23,75 +80,125 @@ void ThreadWaiter::setTimeout(std::chrono::seconds timeout) noexcept
 
 void ThreadWaiter::setTimeoutHandler(std::function<void()>&& timeoutHandler) noexcept
 {
-    this->_timeoutHandler = timeoutHandler;
+    this->_state->timeoutHandler.setHandler(std::move(timeoutHandler));
 }
 
 #pragma mark - Running
 
 bool ThreadWaiter::isRunning() const noexcept
 {
-    return this->_running;
+    lock_guard lock { this->_state->mutex };
+    return this->_state->isRunning;
 }
 
 bool ThreadWaiter::run() noexcept
 {
     if(this->isRunning())
     {
-        os_log(DefaultLog, "A waiter is already running.");
+        AWAKEN_TRACE(Info, "A waiter is already running.");
         return false;
     }
-    
-    this->_running = true;
-    
-    const auto timeout = this->_timeout;
-    const auto timeoutHandler = this->_timeoutHandler;
-    
-    if(timeout == 0s)
+
+    // A handler of the previous run that is still queued
+    // would otherwise stop this run.
+    auto& state = *this->_state;
+    state.timeoutHandler.discard();
+
     {
-        this->_thread = thread([timeoutHandler, this]{
-            os_log(DefaultLog, "Waiting indefinitely…");
-            
-            do {
-                this_thread::sleep_for(1s);
-                this_thread::yield();
-            } while(this->_running);
-            
-            os_log(DefaultLog, "Cancelled.");
-            
-            if(timeoutHandler != nullopt)
-            {
-                (*timeoutHandler)();
-            }
-        });
+        lock_guard lock { state.mutex };
+        if(state.isRunning)
+        {
+            AWAKEN_TRACE(Info, "A waiter is already running.");
+            return false;
+        }
+        state.isRunning = true;
+        state.run++;
+
+        const auto timeout = this->_timeout;
+        if(timeout == 0s)
+        {
+            AWAKEN_TRACE(Debug, "Waiting indefinitely…");
+            state.deadline = nullopt;
+        }
+        else
+        {
+            AWAKEN_TRACE(Debug, "Waiting for %{public}lld seconds.", timeout.count());
+            state.deadline = this->_timeSource.now() + timeout;
+        }
     }
-    else
+
+    if(!this->_thread.joinable())
     {
-        this->_thread = thread([timeout, timeoutHandler, this]{
-            os_log(DefaultLog, "Waiting for %{public}lld seconds.", timeout.count());
-            
-            const auto start = chrono::system_clock::now();
-            const auto end = start + timeout;
-            
-            do {
-                this_thread::sleep_for(1s);
-                this_thread::yield();
-            } while(chrono::system_clock::now() < end && this->_running);
-            
-            os_log(DefaultLog, "Waited.");
-            
-            if(timeoutHandler != nullopt)
-            {
-                (*timeoutHandler)();
-            }
+        this->_thread = thread([state = this->_state]{
+            wait(*state);
         });
     }
-    
+    state.condition.notify_one();
+
     return true;
 }
 
 bool ThreadWaiter::cancel() noexcept
 {
-    this->_running = false;
-    os_log(DefaultLog, "Cancel waiter.");
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        state.isRunning = false;
+    }
+    state.condition.notify_one();
+
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
+    return true;
+}
+
+bool ThreadWaiter::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    auto& state = *this->_state;
+    {
+        lock_guard lock { state.mutex };
+        if(!state.isRunning) { return false; }
+
+        state.deadline = deadline;
+    }
+    state.condition.notify_one();
     return true;
 }
+
+void ThreadWaiter::wait(State& state) noexcept
+{
+    unique_lock lock { state.mutex };
+    uint64_t waitedRun = 0;
+    while(true)
+    {
+        // Waits for the next run, which may already be cancelled.
+        state.condition.wait(lock, [&state, waitedRun]{ return state.run != waitedRun || state.isStopping; });
+        if(state.isStopping) { return; }
+
+        // The deadline may be moved by setDeadline() while waiting,
+        // which wakes the thread up to wait for the new deadline.
+        const auto run = state.run;
+        waitedRun = run;
+        while(state.isRunning && state.run == run)
+        {
+            if(const auto deadline = state.deadline)
+            {
+                if(state.timeSource.now() >= *deadline) { break; }
+                state.timeSource.waitUntil(lock, state.condition, *deadline);
+            }
+            else
+            {
+                state.condition.wait(lock);
+            }
+            Metrics::shared().threadWaiterWakeups.increment();
+        }
+        if(state.isStopping) { return; }
+        if(state.run != run) { continue; }
+        AWAKEN_TRACE(Debug, "Waited.");
+
+        state.isRunning = false;
+
+        lock.unlock();
+        state.timeoutHandler.schedule();
+        lock.lock();
+    }
+}
@@ -0,0 +1,430 @@
+//
+//  TimerWheel.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/TimerWheel.hpp>
+#include <bit>
+#include <Awaken/Metrics.hpp>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Timer
+
+TimerWheel::Timer::Timer(std::function<void()>&& handler) noexcept
+    : _handler(std::move(handler))
+    , _bucket(NoBucket)
+{
+}
+
+TimerWheel::Timer::~Timer() noexcept
+{
+    if(auto wheel = this->_wheel)
+    {
+        wheel->cancel(*this);
+    }
+}
+
+#pragma mark - Life Cycle
+
+TimerWheel& TimerWheel::shared() noexcept
+{
+    // Intentionally leaked, timers may outlive static destruction
+    // and handlers are allowed to call exit() on the service thread.
+    static auto wheel = new TimerWheel();
+    return *wheel;
+}
+
+TimerWheel::TimerWheel(TimeSource& timeSource) noexcept
+    : _timeSource(timeSource)
+    , _isDriven(timeSource.attach(*this))
+    , _epoch(timeSource.now())
+{
+}
+
+TimerWheel::~TimerWheel() noexcept
+{
+    this->_timeSource.detach(*this);
+    {
+        lock_guard lock { this->_mutex };
+        this->_stopping = true;
+
+        for(auto& bucket : this->_buckets)
+        {
+            for(auto timer = bucket.head; timer != nullptr; timer = timer->_next)
+            {
+                timer->_wheel = nullptr;
+                timer->_bucket = NoBucket;
+            }
+            bucket = {};
+        }
+    }
+    this->_condition.notify_all();
+
+    if(this->_thread.joinable())
+    {
+        if(this->_thread.get_id() == this_thread::get_id())
+        {
+            this->_thread.detach();
+        }
+        else
+        {
+            this->_thread.join();
+        }
+    }
+}
+
+#pragma mark - Scheduling
+
+void TimerWheel::schedule(Timer& timer, Clock::time_point deadline) noexcept
+{
+    unique_lock lock { this->_mutex };
+    if(this->arm(timer, deadline))
+    {
+        lock.unlock();
+        this->_condition.notify_one();
+    }
+}
+
+bool TimerWheel::reschedule(Timer& timer, Clock::time_point deadline) noexcept
+{
+    unique_lock lock { this->_mutex };
+    if(this->_firing == &timer || timer._bucket == PendingBucket)
+    {
+        return false;
+    }
+
+    if(this->arm(timer, deadline))
+    {
+        lock.unlock();
+        this->_condition.notify_one();
+    }
+    return true;
+}
+
+void TimerWheel::fire(Timer& timer) noexcept
+{
+    {
+        lock_guard lock { this->_mutex };
+        // A handler that re-armed its own timer expects it to fire again.
+        if(this->_firing == &timer && timer._bucket == NoBucket) { return; }
+
+        if(timer._bucket != NoBucket)
+        {
+            this->remove(timer);
+        }
+        timer._wheel = this;
+        this->append(timer, PendingBucket);
+
+        this->startIfNeeded();
+    }
+    this->_condition.notify_one();
+}
+
+bool TimerWheel::cancel(Timer& timer) noexcept
+{
+    unique_lock lock { this->_mutex };
+
+    const bool wasScheduled = timer._bucket != NoBucket;
+    if(wasScheduled)
+    {
+        this->remove(timer);
+    }
+
+    if(this->_firingThread != this_thread::get_id())
+    {
+        this->_firingCondition.wait(lock, [this, &timer]{ return this->_firing != &timer; });
+    }
+
+    return wasScheduled;
+}
+
+size_t TimerWheel::count() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    return this->_count;
+}
+
+bool TimerWheel::arm(Timer& timer, Clock::time_point deadline) noexcept
+{
+    if(timer._bucket != NoBucket)
+    {
+        this->remove(timer);
+    }
+
+    timer._wheel = this;
+    timer._expiry = max(this->tickFor(deadline), this->_currentTick);
+    this->insert(timer);
+
+    this->startIfNeeded();
+
+    // The service thread only needs a wake-up if it
+    // currently sleeps past the new expiry.
+    return timer._bucket == PendingBucket || timer._expiry < this->_nextWakeTick;
+}
+
+#pragma mark - Ticks
+
+uint64_t TimerWheel::tickFor(Clock::time_point time) const noexcept
+{
+    if(time <= this->_epoch) { return 0; }
+
+    const auto ticks = chrono::ceil<chrono::milliseconds>(time - this->_epoch) / Resolution;
+    return static_cast<uint64_t>(ticks);
+}
+
+TimerWheel::Clock::time_point TimerWheel::timeFor(uint64_t tick) const noexcept
+{
+    return this->_epoch + tick * Resolution;
+}
+
+#pragma mark - Buckets
+
+void TimerWheel::insert(Timer& timer) noexcept
+{
+    const auto expiry = timer._expiry;
+    if(expiry <= this->_currentTick)
+    {
+        this->append(timer, PendingBucket);
+        return;
+    }
+
+    // Pick the finest level that can represent the remaining
+    // ticks, the timer cascades down as the wheel advances.
+    const auto delta = expiry - this->_currentTick;
+    for(unsigned level = 0; level < LevelCount; level++)
+    {
+        const auto shift = LevelBits * (level + 1);
+        if(delta < (uint64_t { 1 } << shift))
+        {
+            const auto slot = (expiry >> (LevelBits * level)) & (SlotCount - 1);
+            this->append(timer, static_cast<uint16_t>(level * SlotCount + slot));
+            return;
+        }
+    }
+
+    this->append(timer, OverflowBucket);
+}
+
+void TimerWheel::append(Timer& timer, uint16_t bucketIndex) noexcept
+{
+    auto& bucket = this->_buckets[bucketIndex];
+
+    timer._bucket = bucketIndex;
+    timer._previous = bucket.tail;
+    timer._next = nullptr;
+
+    if(bucket.tail != nullptr)
+    {
+        bucket.tail->_next = &timer;
+    }
+    else
+    {
+        bucket.head = &timer;
+    }
+    bucket.tail = &timer;
+
+    if(bucketIndex < OverflowBucket)
+    {
+        this->_occupied[bucketIndex / SlotCount] |= uint64_t { 1 } << (bucketIndex % SlotCount);
+    }
+    this->_count++;
+}
+
+void TimerWheel::remove(Timer& timer) noexcept
+{
+    const auto bucketIndex = timer._bucket;
+    auto& bucket = this->_buckets[bucketIndex];
+
+    if(timer._previous != nullptr)
+    {
+        timer._previous->_next = timer._next;
+    }
+    else
+    {
+        bucket.head = timer._next;
+    }
+
+    if(timer._next != nullptr)
+    {
+        timer._next->_previous = timer._previous;
+    }
+    else
+    {
+        bucket.tail = timer._previous;
+    }
+
+    if(bucket.head == nullptr && bucketIndex < OverflowBucket)
+    {
+        this->_occupied[bucketIndex / SlotCount] &= ~(uint64_t { 1 } << (bucketIndex % SlotCount));
+    }
+
+    timer._previous = nullptr;
+    timer._next = nullptr;
+    timer._bucket = NoBucket;
+    this->_count--;
+}
+
+#pragma mark - Advancing
+
+optional<uint64_t> TimerWheel::nextEventTick() const noexcept
+{
+    optional<uint64_t> nextTick = nullopt;
+
+    for(unsigned level = 0; level < LevelCount; level++)
+    {
+        const auto occupied = this->_occupied[level];
+        if(occupied == 0) { continue; }
+
+        // Find the closest occupied slot after the current one,
+        // a distance of SlotCount wraps back to the current slot.
+        const auto shift = LevelBits * level;
+        const auto index = static_cast<int>((this->_currentTick >> shift) & (SlotCount - 1));
+        const auto rotated = rotr(occupied, index + 1);
+        const auto distance = static_cast<uint64_t>(countr_zero(rotated)) + 1;
+
+        const auto tick = ((this->_currentTick >> shift) + distance) << shift;
+        nextTick = min(nextTick.value_or(tick), tick);
+    }
+
+    if(this->_buckets[OverflowBucket].head != nullptr)
+    {
+        const auto shift = LevelBits * LevelCount;
+        const auto tick = ((this->_currentTick >> shift) + 1) << shift;
+        nextTick = min(nextTick.value_or(tick), tick);
+    }
+
+    return nextTick;
+}
+
+void TimerWheel::advance(uint64_t targetTick) noexcept
+{
+    // Jump straight from one occupied slot to the next,
+    // empty slots in between do not need to be visited.
+    while(this->_currentTick < targetTick)
+    {
+        const auto nextTick = this->nextEventTick();
+        if(!nextTick || *nextTick > targetTick)
+        {
+            this->_currentTick = targetTick;
+            return;
+        }
+
+        this->_currentTick = *nextTick;
+        this->process(*nextTick);
+    }
+}
+
+void TimerWheel::process(uint64_t tick) noexcept
+{
+    const auto cascade = [this](uint16_t bucketIndex) {
+        auto timer = this->_buckets[bucketIndex].head;
+        while(timer != nullptr)
+        {
+            const auto next = timer->_next;
+            this->remove(*timer);
+            this->insert(*timer);
+            timer = next;
+        }
+    };
+
+    if((tick & ((uint64_t { 1 } << (LevelBits * LevelCount)) - 1)) == 0)
+    {
+        cascade(OverflowBucket);
+    }
+
+    for(unsigned level = LevelCount - 1; level > 0; level--)
+    {
+        const auto shift = LevelBits * level;
+        if((tick & ((uint64_t { 1 } << shift) - 1)) != 0) { continue; }
+
+        const auto slot = (tick >> shift) & (SlotCount - 1);
+        cascade(static_cast<uint16_t>(level * SlotCount + slot));
+    }
+
+    cascade(static_cast<uint16_t>(tick & (SlotCount - 1)));
+}
+
+#pragma mark - Service Thread
+
+bool TimerWheel::firePending(unique_lock<std::mutex>& lock) noexcept
+{
+    auto timer = this->_buckets[PendingBucket].head;
+    if(timer == nullptr) { return false; }
+
+    this->remove(*timer);
+    this->_firing = timer;
+    this->_firingThread = this_thread::get_id();
+
+    lock.unlock();
+    timer->_handler();
+    lock.lock();
+
+    this->_firing = nullptr;
+    this->_firingThread = {};
+    this->_firingCondition.notify_all();
+    return true;
+}
+
+void TimerWheel::startIfNeeded() noexcept
+{
+    if(this->_isDriven || this->_thread.joinable() || this->_stopping) { return; }
+
+    AWAKEN_TRACE(Info, "Starting timer wheel service thread.");
+    this->_thread = thread([this]{ this->serviceLoop(); });
+}
+
+void TimerWheel::serviceLoop() noexcept
+{
+    unique_lock lock { this->_mutex };
+
+    while(!this->_stopping)
+    {
+        const auto elapsed = chrono::floor<chrono::milliseconds>(this->_timeSource.now() - this->_epoch);
+        this->advance(static_cast<uint64_t>(elapsed / Resolution));
+
+        if(this->firePending(lock)) { continue; }
+
+        if(const auto nextTick = this->nextEventTick())
+        {
+            this->_nextWakeTick = *nextTick;
+            this->_timeSource.waitUntil(lock, this->_condition, this->timeFor(*nextTick));
+        }
+        else
+        {
+            this->_nextWakeTick = UINT64_MAX;
+            this->_condition.wait(lock);
+        }
+        this->_nextWakeTick = 0;
+        Metrics::shared().timerWheelWakeups.increment();
+    }
+}
+
+#pragma mark - Virtual Time
+
+optional<TimerWheel::Clock::time_point> TimerWheel::nextDeadline() const noexcept
+{
+    lock_guard lock { this->_mutex };
+    if(this->_buckets[PendingBucket].head != nullptr)
+    {
+        return this->timeFor(this->_currentTick);
+    }
+
+    const auto nextTick = this->nextEventTick();
+    if(!nextTick) { return nullopt; }
+    return this->timeFor(*nextTick);
+}
+
+void TimerWheel::runUntil(Clock::time_point time) noexcept
+{
+    unique_lock lock { this->_mutex };
+
+    const auto elapsed = chrono::floor<chrono::milliseconds>(time - this->_epoch);
+    this->advance(static_cast<uint64_t>(max(elapsed, 0ms) / Resolution));
+    while(this->firePending(lock)) {}
+}
@@ -0,0 +1,103 @@
+//
+//  TimerWheelWaiter.cpp
+//  Awaken
+//
+//  Created by Marcel Dierkes on 17.10.26.
+//  Copyright © 2026 Marcel Dierkes. All rights reserved.
+//
+
+#include <Awaken/TimerWheelWaiter.hpp>
+#include "../Log.hpp"
+
+using namespace std;
+using namespace Awaken;
+
+#pragma mark - Life Cycle
+
+TimerWheelWaiter::TimerWheelWaiter(TimerWheel& wheel, Executor& executor) noexcept
+    : _wheel(wheel)
+    , _timeoutHandler(executor)
+    , _timer([this]{
+        this->_running.store(false, memory_order_release);
+        this->_timeoutHandler.schedule();
+    })
+{
+}
+
+TimerWheelWaiter::~TimerWheelWaiter() noexcept
+{
+    this->_running = false;
+    this->_wheel.cancel(this->_timer);
+}
+
+#pragma mark - Properties
+
+void TimerWheelWaiter::setTimeout(std::chrono::seconds timeout) noexcept
+{
+    this->_timeout = timeout;
+}
+
+void TimerWheelWaiter::setTimeoutHandler(std::function<void()>&& timeoutHandler) noexcept
+{
+    this->_timeoutHandler.setHandler(std::move(timeoutHandler));
+}
+
+#pragma mark - Running
+
+bool TimerWheelWaiter::isRunning() const noexcept
+{
+    return this->_running.load(memory_order_acquire);
+}
+
+bool TimerWheelWaiter::run() noexcept
+{
+    if(this->_running.load(memory_order_acquire))
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    // A handler of the previous run that is still pending or being
+    // called would otherwise stop this run, see the timer handler.
+    this->_wheel.cancel(this->_timer);
+    this->_timeoutHandler.discard();
+
+    if(this->_running.exchange(true, memory_order_acq_rel))
+    {
+        AWAKEN_TRACE(Info, "A waiter is already running.");
+        return false;
+    }
+
+    const auto timeout = this->_timeout;
+    if(timeout == 0s)
+    {
+        // Nothing to schedule, cancel() fires the timer directly.
+        AWAKEN_TRACE(Debug, "Waiting indefinitely…");
+        return true;
+    }
+
+    AWAKEN_TRACE(Debug, "Waiting for %{public}lld seconds.", timeout.count());
+    this->_wheel.schedule(this->_timer, this->_wheel.now() + timeout);
+
+    return true;
+}
+
+bool TimerWheelWaiter::cancel() noexcept
+{
+    AWAKEN_TRACE(Debug, "Cancel waiter.");
+
+    if(this->_running.exchange(false, memory_order_acq_rel))
+    {
+        this->_wheel.fire(this->_timer);
+    }
+    return true;
+}
+
+bool TimerWheelWaiter::setDeadline(chrono::steady_clock::time_point deadline) noexcept
+{
+    if(!this->_running.load(memory_order_acquire)) { return false; }
+
+    // Re-arming fails if the timer already expired and is about to
+    // call the timeout handler.
+    return this->_wheel.reschedule(this->_timer, deadline);
+}